@@ -18,6 +18,7 @@ CLASSHEADERS = \
     QwtAbstractScaleDraw \
     QwtAlphaColorMap \
     QwtClipper \
+    QwtColorLookupTable \
     QwtColorMap \
     QwtColumnRect \
     QwtColumnSymbol \
@@ -52,6 +53,7 @@ CLASSHEADERS = \
     QwtPlainTextEngine \
     QwtPoint3D \
     QwtPointPolar \
+    QwtPolygonClipperF \
     QwtPowerTransform \
     QwtRichTextEngine \
     QwtRoundScaleDraw \
@@ -127,6 +129,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtPlotZoomer \
         QwtScaleWidget \
         QwtRasterData \
+        QwtRingBufferRasterData \
         QwtSetSample \
         QwtSamplingThread \
         QwtSplineCurveFitter \
@@ -134,9 +137,14 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtIntervalSeriesData \
         QwtPoint3DSeriesData \
         QwtPointSeriesData \
+        QwtPointSpan \
+        QwtSetSpan \
         QwtSetSeriesData \
+        QwtSetArrayData \
         QwtSyntheticPointData \
         QwtPointArrayData \
+        QwtLevelOfDetailData \
+        QwtRingBufferPointData \
         QwtTradingChartData \
         QwtCPointerData
 }
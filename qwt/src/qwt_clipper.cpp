@@ -25,7 +25,9 @@ namespace QwtClip
     template <class Point, typename T> class TopEdge;
     template <class Point, typename T> class BottomEdge;
 
-    template <class Point> class PointBuffer;
+    template <class Polygon, class Point> class PolygonWriter;
+    template <class Point, class Edge, class Next> class ClipStage;
+    template <class Polygon, class Point, typename T> class Pipeline;
 }
 
 template <class Point, typename Value>
@@ -123,82 +125,193 @@ private:
     const Value d_y2;
 };
 
-template<class Point>
-class QwtClip::PointBuffer
+template <class Polygon, class Point>
+class QwtClip::PolygonWriter
 {
 public:
-    explicit PointBuffer( int capacity = 0 ):
-        m_capacity( 0 ),
-        m_size( 0 ),
-        m_buffer( NULL )
+    // the last stage of the pipeline: appending to a polygon
+
+    inline PolygonWriter( Polygon &polygon, int capacity ):
+        d_polygon( polygon ),
+        d_size( 0 )
     {
-        if ( capacity > 0 )
-            reserve( capacity );
+        d_polygon.resize( qMax( capacity, 16 ) );
+        d_points = d_polygon.data();
+        d_capacity = d_polygon.size();
     }
 
-    ~PointBuffer()
+    inline void add( const Point &point )
     {
-        if ( m_buffer )
-            ::free( m_buffer );
+        if ( d_size == d_capacity )
+        {
+            d_capacity *= 2;
+
+            d_polygon.resize( d_capacity );
+            d_points = d_polygon.data();
+        }
+
+        d_points[ d_size++ ] = point;
     }
 
-    inline void setPoints( int numPoints, const Point *points )
+    inline void flush()
     {
-        reserve( numPoints );
-
-        m_size = numPoints;
-        ::memcpy( m_buffer, points, m_size * sizeof( Point ) );
+        d_polygon.resize( d_size );
     }
 
-    inline void reset() 
-    { 
-        m_size = 0; 
+    inline int size() const
+    {
+        return d_size;
     }
 
-    inline int size() const 
-    { 
-        return m_size; 
+private:
+    Polygon &d_polygon;
+    Point *d_points;
+    int d_size;
+    int d_capacity;
+};
+
+template <class Point, class Edge, class Next>
+class QwtClip::ClipStage
+{
+public:
+    /*
+      Each stage clips against one edge and passes its output
+      immediately to the following stage, so that all points
+      are processed in one loop without intermediate buffers
+      ( Sutherland-Hodgman as pipeline ).
+
+      For closed polygons the closing edge is processed in
+      flush(). The result is the same polygon as for clipping
+      edge by edge, but might start at a different point.
+
+      When addFirst is set, a closed polygon is started like an open one.
+      Then the output begins with the clipped polyline of the points
+      being added and the closing edge ends with a duplicate of the
+      first point.
+     */
+
+    inline ClipStage( const Edge &edge, Next &next,
+            bool closePolygon, bool addFirst ):
+        d_edge( edge ),
+        d_next( next ),
+        d_closePolygon( closePolygon ),
+        d_addFirst( addFirst || !closePolygon ),
+        d_count( 0 )
+    {
     }
 
-    inline Point *data() const 
-    { 
-        return m_buffer; 
+    inline void add( const Point &point )
+    {
+        if ( d_count++ == 0 )
+        {
+            d_first = point;
+            if ( d_addFirst && d_edge.isInside( point ) )
+                d_next.add( point );
+        }
+        else
+        {
+            clipLine( point, d_last );
+        }
+
+        d_last = point;
     }
 
-    inline Point &operator[]( int i ) 
-    { 
-        return m_buffer[i]; 
+    inline void flush()
+    {
+        if ( d_count == 1 )
+        {
+            // a single point is never clipped
+            if ( !( d_addFirst && d_edge.isInside( d_first ) ) )
+                d_next.add( d_first );
+        }
+        else if ( d_count > 1 && d_closePolygon )
+        {
+            clipLine( d_first, d_last );
+        }
+
+        d_count = 0;
+        d_next.flush();
     }
 
-    inline const Point &operator[]( int i ) const 
-    { 
-        return m_buffer[i]; 
+private:
+    inline void clipLine( const Point &p1, const Point &p2 )
+    {
+        if ( d_edge.isInside( p1 ) )
+        {
+            if ( !d_edge.isInside( p2 ) )
+                d_next.add( d_edge.intersection( p1, p2 ) );
+
+            d_next.add( p1 );
+        }
+        else
+        {
+            if ( d_edge.isInside( p2 ) )
+                d_next.add( d_edge.intersection( p1, p2 ) );
+        }
     }
 
-    inline void add( const Point &point )
+    const Edge d_edge;
+    Next &d_next;
+
+    const bool d_closePolygon;
+    const bool d_addFirst;
+    int d_count;
+
+    Point d_first;
+    Point d_last;
+};
+
+template <class Polygon, class Point, typename T>
+class QwtClip::Pipeline
+{
+public:
+    typedef PolygonWriter<Polygon, Point> Writer;
+    typedef ClipStage< Point, BottomEdge<Point, T>, Writer > Stage4;
+    typedef ClipStage< Point, TopEdge<Point, T>, Stage4 > Stage3;
+    typedef ClipStage< Point, RightEdge<Point, T>, Stage3 > Stage2;
+    typedef ClipStage< Point, LeftEdge<Point, T>, Stage2 > Stage1;
+
+    inline Pipeline( T x1, T x2, T y1, T y2, bool closePolygon,
+            Polygon &clipped, int capacity, bool addFirst = false ):
+        d_writer( clipped, capacity ),
+        d_stage4( BottomEdge<Point, T>( x1, x2, y1, y2 ),
+            d_writer, closePolygon, addFirst ),
+        d_stage3( TopEdge<Point, T>( x1, x2, y1, y2 ),
+            d_stage4, closePolygon, addFirst ),
+        d_stage2( RightEdge<Point, T>( x1, x2, y1, y2 ),
+            d_stage3, closePolygon, addFirst ),
+        d_stage1( LeftEdge<Point, T>( x1, x2, y1, y2 ),
+            d_stage2, closePolygon, addFirst )
     {
-        if ( m_capacity <= m_size )
-            reserve( m_size + 1 );
+    }
 
-        m_buffer[m_size++] = point;
+    inline int size() const
+    {
+        return d_writer.size();
     }
 
-private:
-    inline void reserve( int size )
+    inline void add( const Point *points, int numPoints )
     {
-        if ( m_capacity == 0 )
-            m_capacity = 1;
+        for ( int i = 0; i < numPoints; i++ )
+            d_stage1.add( points[i] );
+    }
 
-        while ( m_capacity < size )
-            m_capacity *= 2;
+    inline void add( const Point &point )
+    {
+        d_stage1.add( point );
+    }
 
-        m_buffer = static_cast<Point *>( 
-            ::realloc( m_buffer, m_capacity * sizeof( Point ) ) );
+    inline void flush()
+    {
+        d_stage1.flush();
     }
 
-    int m_capacity;
-    int m_size;
-    Point *m_buffer;
+private:
+    Writer d_writer;
+    Stage4 d_stage4;
+    Stage3 d_stage3;
+    Stage2 d_stage2;
+    Stage1 d_stage1;
 };
 
 using namespace QwtClip;
@@ -212,92 +325,173 @@ public:
     {
     }
 
-    Polygon clipPolygon( const Polygon &polygon, bool closePolygon ) const
+    void clipPolygon( const Polygon &polygon,
+        bool closePolygon, Polygon &clipped ) const
     {
-#if 0
-        if ( d_clipRect.contains( polygon.boundingRect() ) )
-            return polygon;
-#endif
+        // a shallow copy, in case clipped is the same as polygon
+        const Polygon points = polygon;
 
-        PointBuffer<Point> points1;
-        PointBuffer<Point> points2( qMin( 256, polygon.size() ) );
+        Pipeline<Polygon, Point, T> pipeline(
+            d_clipRect.x(), d_clipRect.x() + d_clipRect.width(),
+            d_clipRect.y(), d_clipRect.y() + d_clipRect.height(),
+            closePolygon, clipped, points.size() + 4 );
 
-        points1.setPoints( polygon.size(), polygon.data() );
-
-        clipEdge< LeftEdge<Point, T> >( closePolygon, points1, points2 );
-        clipEdge< RightEdge<Point, T> >( closePolygon, points2, points1 );
-        clipEdge< TopEdge<Point, T> >( closePolygon, points1, points2 );
-        clipEdge< BottomEdge<Point, T> >( closePolygon, points2, points1 );
+        pipeline.add( points.constData(), points.size() );
+        pipeline.flush();
+    }
 
-        Polygon p;
-        p.resize( points1.size() );
-        ::memcpy( p.data(), points1.data(), points1.size() * sizeof( Point ) );
+    Polygon clipPolygon( const Polygon &polygon, bool closePolygon ) const
+    {
+        Polygon clipped;
+        clipPolygon( polygon, closePolygon, clipped );
 
-        return p;
+        return clipped;
     }
 
 private:
-    template <class Edge>
-    inline void clipEdge( bool closePolygon,
-        PointBuffer<Point> &points, PointBuffer<Point> &clippedPoints ) const
+    const Rect d_clipRect;
+};
+
+class QwtPolylineSplitter
+{
+public:
+    explicit QwtPolylineSplitter( const QRectF &clipRect ):
+        d_x1( clipRect.x() ),
+        d_x2( clipRect.x() + clipRect.width() ),
+        d_y1( clipRect.y() ),
+        d_y2( clipRect.y() + clipRect.height() )
     {
-        clippedPoints.reset();
+    }
 
-        if ( points.size() < 2 )
-        {
-            if ( points.size() == 1 )
-                clippedPoints.add( points[0] );
-            return;
-        }
+    void splitPolyline( const QPointF *points, int numPoints,
+        QPolygonF &runs, QVector<int> &runSizes ) const
+    {
+        // the runs never have more points than 2 * numPoints
+        QPolygonF buffer( qMax( 2 * numPoints, 16 ) );
+        QPointF *out = buffer.data();
 
-        const Edge edge( d_clipRect.x(), d_clipRect.x() + d_clipRect.width(),
-            d_clipRect.y(), d_clipRect.y() + d_clipRect.height() );
+        runSizes.resize( 0 );
 
-        int lastPos, start;
-        if ( closePolygon )
-        {
-            start = 0;
-            lastPos = points.size() - 1;
-        }
-        else
-        {
-            start = 1;
-            lastPos = 0;
+        int size = 0;
+        int runStart = 0;
+        bool isOpen = false;
 
-            if ( edge.isInside( points[0] ) )
-                clippedPoints.add( points[0] );
+        if ( numPoints == 1 )
+        {
+            const QPointF &p = points[0];
+            if ( p.x() >= d_x1 && p.x() <= d_x2
+                && p.y() >= d_y1 && p.y() <= d_y2 )
+            {
+                out[ size++ ] = p;
+                runSizes += 1;
+            }
         }
 
-        const uint nPoints = points.size();
-        for ( uint i = start; i < nPoints; i++ )
+        for ( int i = 1; i < numPoints; i++ )
         {
-            const Point &p1 = points[i];
-            const Point &p2 = points[lastPos];
+            const QPointF &p1 = points[i - 1];
+            const QPointF &p2 = points[i];
+
+            double t1 = 0.0;
+            double t2 = 1.0;
 
-            if ( edge.isInside( p1 ) )
+            if ( !clipLine( p1, p2, t1, t2 ) )
             {
-                if ( edge.isInside( p2 ) )
+                if ( isOpen )
                 {
-                    clippedPoints.add( p1 );
-                }
-                else
-                {
-                    clippedPoints.add( edge.intersection( p1, p2 ) );
-                    clippedPoints.add( p1 );
+                    runSizes += size - runStart;
+                    isOpen = false;
                 }
+
+                continue;
+            }
+
+            if ( t1 > 0.0 || !isOpen )
+            {
+                if ( isOpen )
+                    runSizes += size - runStart;
+
+                // entering the clip rectangle: a new run starts
+                runStart = size;
+                out[ size++ ] = ( t1 > 0.0 ) ? pointAt( p1, p2, t1 ) : p1;
+            }
+
+            if ( t2 < 1.0 )
+            {
+                // leaving the clip rectangle
+                out[ size++ ] = pointAt( p1, p2, t2 );
+                runSizes += size - runStart;
+                isOpen = false;
             }
             else
             {
-                if ( edge.isInside( p2 ) )
-                {
-                    clippedPoints.add( edge.intersection( p1, p2 ) );
-                }
+                out[ size++ ] = p2;
+                isOpen = true;
             }
-            lastPos = i;
         }
+
+        if ( isOpen )
+            runSizes += size - runStart;
+
+        buffer.resize( size );
+        runs = buffer;
     }
 
-    const Rect d_clipRect;
+private:
+    inline bool clipLine( const QPointF &p1, const QPointF &p2,
+        double &t1, double &t2 ) const
+    {
+        // Liang-Barsky
+
+        const double dx = p2.x() - p1.x();
+        const double dy = p2.y() - p1.y();
+
+        return clipT( -dx, p1.x() - d_x1, t1, t2 )
+            && clipT( dx, d_x2 - p1.x(), t1, t2 )
+            && clipT( -dy, p1.y() - d_y1, t1, t2 )
+            && clipT( dy, d_y2 - p1.y(), t1, t2 );
+    }
+
+    static inline bool clipT( double p, double q, double &t1, double &t2 )
+    {
+        if ( p == 0.0 )
+        {
+            // parallel to the edge
+            return q >= 0.0;
+        }
+
+        const double t = q / p;
+        if ( p < 0.0 )
+        {
+            if ( t > t2 )
+                return false;
+
+            if ( t > t1 )
+                t1 = t;
+        }
+        else
+        {
+            if ( t < t1 )
+                return false;
+
+            if ( t < t2 )
+                t2 = t;
+        }
+
+        return true;
+    }
+
+    static inline QPointF pointAt( const QPointF &p1,
+        const QPointF &p2, double t )
+    {
+        return QPointF( p1.x() + t * ( p2.x() - p1.x() ),
+            p1.y() + t * ( p2.y() - p1.y() ) );
+    }
+
+    const double d_x1;
+    const double d_x2;
+    const double d_y1;
+    const double d_y2;
 };
 
 class QwtCircleClipper
@@ -489,6 +683,118 @@ QPolygonF QwtClipper::clipPolygonF(
     return clipper.clipPolygon( polygon, closePolygon );
 }
 
+/*!
+   Sutherland-Hodgman polygon clipping
+
+   The clipped points are written to a polygon, that is
+   provided by the caller. Its memory can be reused, when clipping
+   many polygons.
+
+   \param clipRect Clip rectangle
+   \param polygon Polygon
+   \param clipped Clipped polygon, might be the same object as polygon
+   \param closePolygon True, when the polygon is closed
+*/
+void QwtClipper::clipPolygon( const QRect &clipRect,
+    const QPolygon &polygon, QPolygon &clipped, bool closePolygon )
+{
+    QwtPolygonClipper<QPolygon, QRect, QPoint, int> clipper( clipRect );
+    clipper.clipPolygon( polygon, closePolygon, clipped );
+}
+
+/*!
+   Sutherland-Hodgman polygon clipping
+
+   The clipped points are written to a polygon, that is
+   provided by the caller. Its memory can be reused, when clipping
+   many polygons.
+
+   \param clipRect Clip rectangle
+   \param polygon Polygon
+   \param clipped Clipped polygon, might be the same object as polygon
+   \param closePolygon True, when the polygon is closed
+*/
+void QwtClipper::clipPolygonF( const QRectF &clipRect,
+    const QPolygonF &polygon, QPolygonF &clipped, bool closePolygon )
+{
+    QwtPolygonClipper<QPolygonF, QRectF, QPointF, double> clipper( clipRect );
+    clipper.clipPolygon( polygon, closePolygon, clipped );
+}
+
+/*!
+   Clip a polyline and the area below it in one pass
+
+   The polygon to be clipped is closed and consists of the points
+   of polyline followed by closingPoints - f.e. the points on the baseline
+   of a filled curve. The clipped polygon starts with the points
+   of the clipped polyline, that are identical to the result of
+   clipPolygonF( clipRect, polyline, clipped, false ).
+
+   So the same buffer can be used for filling the area and for drawing
+   its outline, without mapping and clipping the points twice.
+
+   \param clipRect Clip rectangle
+   \param polyline Polyline
+   \param closingPoints Points, that are appended to the polyline
+                        to close the polygon
+   \param numClosingPoints Number of closing points
+   \param clipped Clipped polygon, might be the same object as polyline
+
+   \return Number of points at the beginning of clipped, that
+           belong to the clipped polyline
+*/
+int QwtClipper::clipFilledPolygonF( const QRectF &clipRect,
+    const QPolygonF &polyline, const QPointF *closingPoints,
+    int numClosingPoints, QPolygonF &clipped )
+{
+    // a shallow copy, in case clipped is the same as polyline
+    const QPolygonF points = polyline;
+
+    Pipeline<QPolygonF, QPointF, double> pipeline(
+        clipRect.x(), clipRect.x() + clipRect.width(),
+        clipRect.y(), clipRect.y() + clipRect.height(),
+        true, clipped, points.size() + numClosingPoints + 4, true );
+
+    pipeline.add( points.constData(), points.size() );
+    const int polylineSize = pipeline.size();
+
+    pipeline.add( closingPoints, numClosingPoints );
+    pipeline.flush();
+
+    return polylineSize;
+}
+
+/*!
+   Split a polyline into the runs inside of a rectangle
+
+   In opposite to clipPolygonF() the parts outside of the clip
+   rectangle are dropped instead of being replaced by points
+   on its border. What is left are the visible runs of the polyline,
+   that can be painted as independent polylines
+   - f.e. by QwtPainter::drawPolylines().
+
+   The runs are stored one after the other in runs, the number
+   of points of each run in runSizes. A run has at least 2 points,
+   beside a polyline of a single point inside of the rectangle.
+
+   \param clipRect Clip rectangle
+   \param polyline Polyline
+   \param runs Points of all runs, might be the same object as polyline
+   \param runSizes Number of points for each run
+
+   \sa clipPolygonF(), QwtPainter::drawPolylines()
+*/
+void QwtClipper::splitPolylineF( const QRectF &clipRect,
+    const QPolygonF &polyline, QPolygonF &runs, QVector<int> &runSizes )
+{
+    // a shallow copy, in case runs is the same as polyline
+    const QPolygonF points = polyline;
+
+    QwtPolylineSplitter splitter( clipRect );
+    splitter.splitPolyline( points.constData(), points.size(),
+        runs, runSizes );
+}
+
 /*!
    Circle clipping
 
@@ -508,3 +814,71 @@ QVector<QwtInterval> QwtClipper::clipCircle( const QRectF &clipRect,
     QwtCircleClipper clipper( clipRect );
     return clipper.clipCircle( center, radius );
 }
+
+class QwtPolygonClipperF::PrivateData
+{
+public:
+    PrivateData( const QRectF &clipRect,
+            QPolygonF &clipped, bool closePolygon ):
+        pipeline( clipRect.x(), clipRect.x() + clipRect.width(),
+            clipRect.y(), clipRect.y() + clipRect.height(),
+            closePolygon, clipped, 256 )
+    {
+    }
+
+    Pipeline<QPolygonF, QPointF, double> pipeline;
+};
+
+/*!
+   Constructor
+
+   \param clipRect Clip rectangle
+   \param clipped Polygon, where to write the clipped points.
+                  Its content is replaced.
+   \param closePolygon True, when the polygon is closed
+*/
+QwtPolygonClipperF::QwtPolygonClipperF( const QRectF &clipRect,
+    QPolygonF &clipped, bool closePolygon )
+{
+    d_data = new PrivateData( clipRect, clipped, closePolygon );
+}
+
+//! Destructor
+QwtPolygonClipperF::~QwtPolygonClipperF()
+{
+    delete d_data;
+}
+
+/*!
+   Clip the next points of the polygon
+
+   \param points Points
+   \param numPoints Number of points
+   \sa addPoint(), finish()
+*/
+void QwtPolygonClipperF::addPoints( const QPointF *points, int numPoints )
+{
+    d_data->pipeline.add( points, numPoints );
+}
+
+/*!
+   Clip the next point of the polygon
+
+   \param point Point
+   \sa addPoints(), finish()
+*/
+void QwtPolygonClipperF::addPoint( const QPointF &point )
+{
+    d_data->pipeline.add( point );
+}
+
+/*!
+   Complete the clipped polygon
+
+   finish() needs to be called after the last point has been passed
+   and resizes the clipped polygon to its final size.
+*/
+void QwtPolygonClipperF::finish()
+{
+    d_data->pipeline.flush();
+}
@@ -20,6 +20,13 @@ class QRectF;
 
 /*!
   \brief Some clipping algorithms
+
+  The polygons are clipped by the Sutherland-Hodgman algorithm,
+  running the 4 edges of the clip rectangle as a pipeline.
+  Each point is processed in one loop and written directly
+  to the clipped polygon.
+
+  \sa QwtPolygonClipperF
 */
 
 class QWT_EXPORT QwtClipper
@@ -33,8 +40,63 @@ public:
     static QPolygonF clipPolygonF( const QRectF &, 
         const QPolygonF &, bool closePolygon = false );
 
+    static void clipPolygon( const QRect &, const QPolygon &,
+        QPolygon &clipped, bool closePolygon = false );
+
+    static void clipPolygonF( const QRectF &, const QPolygonF &,
+        QPolygonF &clipped, bool closePolygon = false );
+
+    static int clipFilledPolygonF( const QRectF &, const QPolygonF &,
+        const QPointF *closingPoints, int numClosingPoints,
+        QPolygonF &clipped );
+
+    static void splitPolylineF( const QRectF &, const QPolygonF &,
+        QPolygonF &runs, QVector<int> &runSizes );
+
     static QVector<QwtInterval> clipCircle(
         const QRectF &, const QPointF &, double radius );
 };
 
+/*!
+  \brief Clipping a polygon, whose points are passed in chunks
+
+  QwtPolygonClipperF runs the same algorithm as QwtClipper::clipPolygonF(),
+  but the points can be passed, while they are generated. This way
+  a polygon can be mapped and clipped in one loop without having
+  the unclipped polygon in memory.
+
+  \code
+QPolygonF clipped;
+
+QwtPolygonClipperF clipper( clipRect, clipped );
+while ( ... )
+{
+    const int numPoints = mapNextChunk( buffer );
+    clipper.addPoints( buffer, numPoints );
+}
+clipper.finish();
+  \endcode
+
+  \sa QwtClipper, QwtPointMapper::setClipRect()
+*/
+class QWT_EXPORT QwtPolygonClipperF
+{
+public:
+    QwtPolygonClipperF( const QRectF &clipRect,
+        QPolygonF &clipped, bool closePolygon = false );
+
+    ~QwtPolygonClipperF();
+
+    void addPoints( const QPointF *points, int numPoints );
+    void addPoint( const QPointF & );
+
+    void finish();
+
+private:
+    Q_DISABLE_COPY(QwtPolygonClipperF)
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
 #endif
@@ -10,6 +10,7 @@
 #include "qwt_color_map.h"
 #include "qwt_math.h"
 #include "qwt_interval.h"
+#include <qnumeric.h>
 
 #if (__GNUC__ * 100 + __GNUC_MINOR__) >= 408
 
@@ -357,6 +358,134 @@ QVector<QRgb> QwtColorMap::colorTable( int numColors ) const
     return table;
 }
 
+/*!
+   \brief Build a lookup table for mapping values of an interval
+
+   A lookup table can replace the virtual colorIndex() and rgb()
+   calls only, when it maps values in exactly the same way. As this
+   can't be guaranteed for an arbitrary implementation of colorIndex()
+   the default implementation returns a null table. Then the
+   values have to be mapped by colorIndex() and rgb().
+
+   Color maps, that can be compiled into a table, reimplement
+   lookupTable() - like QwtLinearColorMap.
+
+   \param interval Range for the values
+   \param numColors Number of colors of the table, at least 2
+   \return A null table
+
+   \sa QwtColorLookupTable::isNull(), QwtColorLookupTable::setInterval()
+*/
+QwtColorLookupTable QwtColorMap::lookupTable(
+    const QwtInterval &interval, int numColors ) const
+{
+    Q_UNUSED( interval );
+    Q_UNUSED( numColors );
+
+    return QwtColorLookupTable();
+}
+
+//! Constructs a null table
+QwtColorLookupTable::QwtColorLookupTable():
+    d_rounding( RoundToNearest ),
+    d_nanColor( 0u ),
+    d_lowerColor( 0u ),
+    d_upperColor( 0u )
+{
+    updateScale();
+}
+
+/*!
+   Constructor
+
+   The out of range colors are initialized with the first and
+   the last color of the table.
+
+   \param interval Range for the values
+   \param colors Colors of the table
+   \param rounding Rounding of a value to the index of the table
+*/
+QwtColorLookupTable::QwtColorLookupTable( const QwtInterval &interval,
+        const QVector<QRgb> &colors, Rounding rounding ):
+    d_interval( interval ),
+    d_colors( colors ),
+    d_rounding( rounding ),
+    d_nanColor( 0u ),
+    d_lowerColor( 0u ),
+    d_upperColor( 0u )
+{
+    if ( !d_colors.isEmpty() )
+    {
+        d_lowerColor = d_colors.first();
+        d_upperColor = d_colors.last();
+    }
+
+    updateScale();
+}
+
+/*!
+   \brief Set the range of the values
+
+   The colors of the table are distributed over the interval,
+   so that a table can be built once and then be used for
+   different ranges.
+
+   \param interval Range for the values
+   \sa interval()
+*/
+void QwtColorLookupTable::setInterval( const QwtInterval &interval )
+{
+    d_interval = interval;
+    updateScale();
+}
+
+/*!
+   Set the color for NaN values, the default setting is 0u
+   ( fully transparent )
+
+   \param color Color for NaN values
+   \sa nanColor()
+*/
+void QwtColorLookupTable::setNaNColor( QRgb color )
+{
+    d_nanColor = color;
+}
+
+/*!
+   Set the colors for values outside of interval()
+
+   \param lower Color for values below interval()
+   \param upper Color for values above interval()
+   \sa lowerColor(), upperColor()
+*/
+void QwtColorLookupTable::setOutOfRangeColors( QRgb lower, QRgb upper )
+{
+    d_lowerColor = lower;
+    d_upperColor = upper;
+}
+
+void QwtColorLookupTable::updateScale()
+{
+    d_maxIndex = d_colors.size() - 1;
+
+    if ( d_maxIndex < 0 )
+    {
+        // all comparisons fail: every value is mapped to d_nanColor
+        d_min = d_max = qQNaN();
+        d_scale = d_bias = 0.0;
+        d_maxIndex = 0;
+
+        return;
+    }
+
+    d_min = d_interval.minValue();
+    d_max = d_interval.maxValue();
+
+    const double width = d_interval.width();
+    d_scale = ( width > 0.0 ) ? d_maxIndex / width : 0.0;
+    d_bias = ( d_rounding == RoundToNearest ) ? 0.5 : 0.0;
+}
+
 class QwtLinearColorMap::PrivateData
 {
 public:
@@ -545,6 +674,31 @@ uint QwtLinearColorMap::colorIndex( int numColors,
 #pragma GCC pop_options
 #endif
 
+/*!
+   \brief Build a lookup table for mapping values of an interval
+
+   In FixedColors mode values are rounded to the next lower color
+   like in colorIndex().
+
+   \param interval Range for the values
+   \param numColors Number of colors of the table, at least 2
+   \return Lookup table
+
+   \note Derived classes, that reimplement colorIndex() or rgb(),
+         need to reimplement lookupTable() as well - f.e. returning
+         a null table, so that their mapping is used.
+*/
+QwtColorLookupTable QwtLinearColorMap::lookupTable(
+    const QwtInterval &interval, int numColors ) const
+{
+    const QwtColorLookupTable::Rounding rounding =
+        ( d_data->mode == FixedColors ) ? QwtColorLookupTable::RoundDown
+            : QwtColorLookupTable::RoundToNearest;
+
+    return QwtColorLookupTable( interval,
+        colorTable( qMax( numColors, 2 ) ), rounding );
+}
+
 class QwtAlphaColorMap::PrivateData
 {
 public:
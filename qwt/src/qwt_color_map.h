@@ -15,6 +15,90 @@
 #include <qcolor.h>
 #include <qvector.h>
 
+/*!
+  \brief A precalculated table for mapping values into colors
+
+  QwtColorLookupTable is a compiled version of a QwtColorMap for
+  a fixed number of colors: the mapping of a value into a color
+  is reduced to a multiplication with a precalculated scale factor
+  and a lookup in a table of RGB values. As all methods for mapping
+  values are inline and non virtual it is intended to be used in
+  loops, where a huge number of values has to be mapped - like in
+  QwtPlotSpectrogram::renderTile().
+
+  Values below or above interval() are mapped to the out of range
+  colors, NaN values are mapped to nanColor().
+
+  \code
+QwtColorLookupTable table = colorMap->lookupTable( range, 1024 );
+for ( int x = 0; x < numValues; x++ )
+    line[x] = table.rgb( values[x] );
+  \endcode
+
+  \sa QwtColorMap::lookupTable()
+ */
+class QWT_EXPORT QwtColorLookupTable
+{
+public:
+    /*!
+       How to round a value to the index of the table
+       \sa QwtColorMap::colorIndex()
+     */
+    enum Rounding
+    {
+        //! Round to the nearest index
+        RoundToNearest,
+
+        //! Round to the next lower index
+        RoundDown
+    };
+
+    QwtColorLookupTable();
+    QwtColorLookupTable( const QwtInterval &,
+        const QVector<QRgb> &colors, Rounding = RoundToNearest );
+
+    bool isNull() const;
+
+    void setInterval( const QwtInterval & );
+    QwtInterval interval() const;
+
+    QVector<QRgb> colors() const;
+    int numColors() const;
+
+    Rounding rounding() const;
+
+    void setNaNColor( QRgb );
+    QRgb nanColor() const;
+
+    void setOutOfRangeColors( QRgb lower, QRgb upper );
+    QRgb lowerColor() const;
+    QRgb upperColor() const;
+
+    QRgb rgb( double value ) const;
+    uint colorIndex( double value ) const;
+
+    void rgb( const double *values, QRgb *rgbs, int numValues ) const;
+    void colorIndex( const double *values,
+        unsigned char *indexes, int numValues ) const;
+
+private:
+    void updateScale();
+
+    QwtInterval d_interval;
+    QVector<QRgb> d_colors;
+    Rounding d_rounding;
+
+    QRgb d_nanColor;
+    QRgb d_lowerColor;
+    QRgb d_upperColor;
+
+    double d_min;
+    double d_max;
+    double d_scale;
+    double d_bias;
+    int d_maxIndex;
+};
+
 /*!
   \brief QwtColorMap is used to map values into colors.
 
@@ -79,6 +163,9 @@ public:
     virtual QVector<QRgb> colorTable( int numColors ) const;
     virtual QVector<QRgb> colorTable256() const;
 
+    virtual QwtColorLookupTable lookupTable(
+        const QwtInterval &, int numColors ) const;
+
 private:
     Q_DISABLE_COPY(QwtColorMap)
 
@@ -128,6 +215,9 @@ public:
     virtual uint colorIndex( int numColors,
         const QwtInterval &, double value ) const;
 
+    virtual QwtColorLookupTable lookupTable(
+        const QwtInterval &, int numColors ) const;
+
     class ColorStops;
 
 private:
@@ -251,4 +341,136 @@ inline QwtColorMap::Format QwtColorMap::format() const
     return d_format;
 }
 
+//! \return True, when the table has no colors
+inline bool QwtColorLookupTable::isNull() const
+{
+    return d_colors.isEmpty();
+}
+
+//! \return Interval of the values, that are mapped to the table
+inline QwtInterval QwtColorLookupTable::interval() const
+{
+    return d_interval;
+}
+
+//! \return Colors of the table
+inline QVector<QRgb> QwtColorLookupTable::colors() const
+{
+    return d_colors;
+}
+
+//! \return Number of colors of the table
+inline int QwtColorLookupTable::numColors() const
+{
+    return d_colors.size();
+}
+
+//! \return Rounding of a value to the index of the table
+inline QwtColorLookupTable::Rounding QwtColorLookupTable::rounding() const
+{
+    return d_rounding;
+}
+
+/*!
+   \return Color for NaN values
+   \sa setNaNColor()
+*/
+inline QRgb QwtColorLookupTable::nanColor() const
+{
+    return d_nanColor;
+}
+
+/*!
+   \return Color for values below interval()
+   \sa setOutOfRangeColors()
+*/
+inline QRgb QwtColorLookupTable::lowerColor() const
+{
+    return d_lowerColor;
+}
+
+/*!
+   \return Color for values above interval()
+   \sa setOutOfRangeColors()
+*/
+inline QRgb QwtColorLookupTable::upperColor() const
+{
+    return d_upperColor;
+}
+
+/*!
+   Map a value into a RGB value
+
+   \param value Value
+   \return RGB value, corresponding to value
+   \note A null table maps all values to nanColor()
+*/
+inline QRgb QwtColorLookupTable::rgb( double value ) const
+{
+    if ( value >= d_min )
+    {
+        if ( value > d_max )
+            return d_upperColor;
+
+        const int index = static_cast<int>( ( value - d_min ) * d_scale + d_bias );
+        return d_colors.constData()[ qMin( index, d_maxIndex ) ];
+    }
+
+    // comparisons with NaN are always false
+    return ( value < d_min ) ? d_lowerColor : d_nanColor;
+}
+
+/*!
+   Map a value into an index of the table
+
+   \param value Value
+   \return Index, between 0 and numColors() - 1
+
+   \note Values below interval() and NaN values are mapped to 0,
+         values above to numColors() - 1
+*/
+inline uint QwtColorLookupTable::colorIndex( double value ) const
+{
+    if ( value >= d_min )
+    {
+        if ( value > d_max )
+            return d_maxIndex;
+
+        const int index = static_cast<int>( ( value - d_min ) * d_scale + d_bias );
+        return qMin( index, d_maxIndex );
+    }
+
+    return 0;
+}
+
+/*!
+   Map an array of values into RGB values
+
+   \param values Values
+   \param rgbs Array for the RGB values, of at least numValues elements
+   \param numValues Number of values
+*/
+inline void QwtColorLookupTable::rgb(
+    const double *values, QRgb *rgbs, int numValues ) const
+{
+    for ( int i = 0; i < numValues; i++ )
+        rgbs[i] = rgb( values[i] );
+}
+
+/*!
+   Map an array of values into indexes of the table
+
+   \param values Values
+   \param indexes Array for the indexes, of at least numValues elements
+   \param numValues Number of values
+
+   \note The table must not have more than 256 colors
+*/
+inline void QwtColorLookupTable::colorIndex( const double *values,
+    unsigned char *indexes, int numValues ) const
+{
+    for ( int i = 0; i < numValues; i++ )
+        indexes[i] = static_cast<unsigned char>( colorIndex( values[i] ) );
+}
+
 #endif
@@ -11,7 +11,9 @@
 #include "qwt_math.h"
 #include "qwt_painter.h"
 #include <qpainter.h>
+#include <qpainterpath.h>
 #include <qpalette.h>
+#include <qvector.h>
 
 static void qwtDrawBox( QPainter *p, const QRectF &rect,
     const QPalette &pal, double lw )
@@ -253,6 +255,200 @@ void QwtColumnSymbol::draw( QPainter *painter,
     painter->restore();
 }
 
+/*!
+  Draw a series of columns
+
+  In Box style the columns are collected and painted in a couple
+  of QPainter calls - one for each color of the palette. For all
+  other styles draw() is called for each column.
+
+  \param painter Painter
+  \param columns Directed rectangles
+  \param numColumns Number of columns
+
+  \note Derived classes, that overload draw() for the Box style,
+        need to overload drawColumns() as well.
+  \sa draw(), drawBoxes()
+*/
+void QwtColumnSymbol::drawColumns( QPainter *painter,
+    const QwtColumnRect *columns, int numColumns ) const
+{
+    if ( numColumns <= 0 )
+        return;
+
+    switch ( d_data->style )
+    {
+        case QwtColumnSymbol::NoStyle:
+        {
+            break;
+        }
+        case QwtColumnSymbol::Box:
+        {
+            painter->save();
+            drawBoxes( painter, columns, numColumns );
+            painter->restore();
+
+            break;
+        }
+        default:
+        {
+            for ( int i = 0; i < numColumns; i++ )
+                draw( painter, columns[i] );
+        }
+    }
+}
+
+/*!
+  Draw a series of columns in Box style.
+
+  The result is the same as calling drawBox() for each of
+  the columns, as long as they do not overlap.
+
+  \param painter Painter
+  \param columns Directed rectangles
+  \param numColumns Number of columns
+
+  \sa drawColumns(), drawBox()
+*/
+void QwtColumnSymbol::drawBoxes( QPainter *painter,
+    const QwtColumnRect *columns, int numColumns ) const
+{
+    const QPalette &pal = d_data->palette;
+    const FrameStyle frameStyle = d_data->frameStyle;
+    const bool doAlign = QwtPainter::roundingAlignment( painter );
+
+    QVector<QRectF> windowRects;
+    windowRects.reserve( numColumns );
+
+    QVector<QLineF> lines;
+
+    QPainterPath lightPath;
+    QPainterPath darkPath;
+
+    // the rings of the Plain frames, as columns do not overlap
+    QPainterPath framePath;
+    framePath.setFillRule( Qt::OddEvenFill );
+
+    for ( int i = 0; i < numColumns; i++ )
+    {
+        QRectF r = columns[i].toRect();
+        if ( doAlign )
+        {
+            r.setLeft( qRound( r.left() ) );
+            r.setRight( qRound( r.right() ) );
+            r.setTop( qRound( r.top() ) );
+            r.setBottom( qRound( r.bottom() ) );
+        }
+
+        if ( frameStyle == QwtColumnSymbol::NoFrame )
+        {
+            windowRects += r;
+            continue;
+        }
+
+        double lw = d_data->lineWidth;
+        if ( lw > 0.0 )
+        {
+            if ( r.width() == 0.0 )
+            {
+                lines += QLineF( r.topLeft(), r.bottomLeft() );
+                continue;
+            }
+
+            if ( r.height() == 0.0 )
+            {
+                lines += QLineF( r.topLeft(), r.topRight() );
+                continue;
+            }
+
+            lw = qMin( lw, r.height() / 2.0 - 1.0 );
+            lw = qMin( lw, r.width() / 2.0 - 1.0 );
+
+            // the same geometry as in qwtDrawBox/qwtDrawPanel
+
+            const QRectF outerRect = r.adjusted( 0, 0, 1, 1 );
+
+            if ( frameStyle == QwtColumnSymbol::Raised )
+            {
+                const QRectF innerRect = outerRect.adjusted( lw, lw, -lw, -lw );
+
+                QPolygonF light;
+                light += outerRect.bottomLeft();
+                light += outerRect.topLeft();
+                light += outerRect.topRight();
+                light += innerRect.topRight();
+                light += innerRect.topLeft();
+                light += innerRect.bottomLeft();
+
+                QPolygonF dark;
+                dark += outerRect.topRight();
+                dark += outerRect.bottomRight();
+                dark += outerRect.bottomLeft();
+                dark += innerRect.bottomLeft();
+                dark += innerRect.bottomRight();
+                dark += innerRect.topRight();
+
+                lightPath.addPolygon( light );
+                lightPath.closeSubpath();
+
+                darkPath.addPolygon( dark );
+                darkPath.closeSubpath();
+            }
+            else
+            {
+                framePath.addRect( outerRect );
+
+                if ( outerRect.width() > 2 * lw &&
+                    outerRect.height() > 2 * lw )
+                {
+                    framePath.addRect(
+                        outerRect.adjusted( lw, lw, -lw, -lw ) );
+                }
+            }
+        }
+
+        const QRectF windowRect = r.adjusted( lw, lw, -lw + 1, -lw + 1 );
+        if ( windowRect.isValid() || frameStyle == QwtColumnSymbol::Raised )
+            windowRects += windowRect;
+    }
+
+    painter->setPen( Qt::NoPen );
+
+    if ( !lightPath.isEmpty() )
+    {
+        painter->setBrush( pal.light() );
+        painter->drawPath( lightPath );
+    }
+
+    if ( !darkPath.isEmpty() )
+    {
+        painter->setBrush( pal.dark() );
+        painter->drawPath( darkPath );
+    }
+
+    if ( !framePath.isEmpty() )
+    {
+        painter->setBrush( pal.dark() );
+        painter->drawPath( framePath );
+    }
+
+    if ( !windowRects.isEmpty() )
+    {
+        painter->setBrush( pal.window() );
+        painter->drawRects( windowRects.constData(), windowRects.size() );
+    }
+
+    if ( !lines.isEmpty() )
+    {
+        if ( frameStyle == QwtColumnSymbol::Raised )
+            painter->setPen( pal.window().color() );
+        else
+            painter->setPen( pal.dark().color() );
+
+        painter->drawLines( lines.constData(), lines.size() );
+    }
+}
+
 /*!
   Draw the symbol when it is in Box style.
 
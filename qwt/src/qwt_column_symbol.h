@@ -150,8 +150,12 @@ public:
 
     virtual void draw( QPainter *, const QwtColumnRect & ) const;
 
+    virtual void drawColumns( QPainter *,
+        const QwtColumnRect *, int numColumns ) const;
+
 protected:
     void drawBox( QPainter *, const QwtColumnRect & ) const;
+    void drawBoxes( QPainter *, const QwtColumnRect *, int numColumns ) const;
 
 private:
     Q_DISABLE_COPY(QwtColumnSymbol)
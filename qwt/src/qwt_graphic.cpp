@@ -63,53 +63,129 @@ static QRectF qwtStrokedPathRect(
     return rect;
 }
 
-static inline void qwtExecCommand( 
-    QPainter *painter, const QwtPainterCommand &cmd, 
-    QwtGraphic::RenderHints renderHints,
-    const QTransform &transform,
-    const QTransform *initialTransform )
+static inline bool qwtDoMapPath( const QPainter *painter,
+    QwtGraphic::RenderHints renderHints )
 {
-    switch( cmd.type() )
+    bool doMap = false;
+
+    if ( renderHints.testFlag( QwtGraphic::RenderPensUnscaled )
+        && painter->transform().isScaling() )
     {
-        case QwtPainterCommand::Path:
+        bool isCosmetic = painter->pen().isCosmetic();
+        if ( isCosmetic && painter->pen().widthF() == 0.0 )
         {
-            bool doMap = false;
+            QPainter::RenderHints hints = painter->renderHints();
+            if ( hints.testFlag( QPainter::NonCosmeticDefaultPen ) )
+                isCosmetic = false;
+        }
 
-            if ( renderHints.testFlag( QwtGraphic::RenderPensUnscaled )
-                && painter->transform().isScaling() )
-            {
-                bool isCosmetic = painter->pen().isCosmetic();
-                if ( isCosmetic && painter->pen().widthF() == 0.0 )
-                {
-                    QPainter::RenderHints hints = painter->renderHints();
-                    if ( hints.testFlag( QPainter::NonCosmeticDefaultPen ) )
-                        isCosmetic = false;
-                }
+        doMap = !isCosmetic;
+    }
 
-                doMap = !isCosmetic;
-            }
+    return doMap;
+}
 
-            if ( doMap )
-            {
-                const QTransform tr = painter->transform();
+static void qwtDrawMappedPath( QPainter *painter,
+    const QPainterPath &painterPath, const QTransform *initialTransform )
+{
+    const QTransform tr = painter->transform();
 
-                painter->resetTransform();
+    painter->resetTransform();
 
-                QPainterPath path = tr.map( *cmd.path() );
-                if ( initialTransform )
-                {
-                    painter->setTransform( *initialTransform );
-                    path = initialTransform->inverted().map( path );
-                }
+    QPainterPath path = tr.map( painterPath );
+    if ( initialTransform )
+    {
+        painter->setTransform( *initialTransform );
+        path = initialTransform->inverted().map( path );
+    }
 
-                painter->drawPath( path );
+    painter->drawPath( path );
 
-                painter->setTransform( tr );
-            }
+    painter->setTransform( tr );
+}
+
+static void qwtExecState( QPainter *painter,
+    const QwtPainterCommand::StateData *data, const QTransform &transform )
+{
+    if ( data->flags & QPaintEngine::DirtyPen ) 
+        painter->setPen( data->pen );
+
+    if ( data->flags & QPaintEngine::DirtyBrush ) 
+        painter->setBrush( data->brush );
+
+    if ( data->flags & QPaintEngine::DirtyBrushOrigin ) 
+        painter->setBrushOrigin( data->brushOrigin );
+
+    if ( data->flags & QPaintEngine::DirtyFont ) 
+        painter->setFont( data->font );
+
+    if ( data->flags & QPaintEngine::DirtyBackground ) 
+    {
+        painter->setBackgroundMode( data->backgroundMode );
+        painter->setBackground( data->backgroundBrush );
+    }
+
+    if ( data->flags & QPaintEngine::DirtyTransform ) 
+    {
+        painter->setTransform( data->transform * transform );
+    }
+
+    if ( data->flags & QPaintEngine::DirtyClipEnabled ) 
+        painter->setClipping( data->isClipEnabled );
+
+    if ( data->flags & QPaintEngine::DirtyClipRegion) 
+    {
+        painter->setClipRegion( data->clipRegion, 
+            data->clipOperation );
+    }
+
+    if ( data->flags & QPaintEngine::DirtyClipPath ) 
+    {
+        painter->setClipPath( data->clipPath, data->clipOperation );
+    }
+
+    if ( data->flags & QPaintEngine::DirtyHints) 
+    {
+        const QPainter::RenderHints hints = data->renderHints;
+
+        painter->setRenderHint( QPainter::Antialiasing,
+            hints.testFlag( QPainter::Antialiasing ) );
+
+        painter->setRenderHint( QPainter::TextAntialiasing,
+            hints.testFlag( QPainter::TextAntialiasing ) );
+
+        painter->setRenderHint( QPainter::SmoothPixmapTransform,
+            hints.testFlag( QPainter::SmoothPixmapTransform ) );
+
+        painter->setRenderHint( QPainter::HighQualityAntialiasing,
+            hints.testFlag( QPainter::HighQualityAntialiasing ) );
+
+        painter->setRenderHint( QPainter::NonCosmeticDefaultPen,
+            hints.testFlag( QPainter::NonCosmeticDefaultPen ) );
+    }
+
+    if ( data->flags & QPaintEngine::DirtyCompositionMode) 
+        painter->setCompositionMode( data->compositionMode );
+
+    if ( data->flags & QPaintEngine::DirtyOpacity) 
+        painter->setOpacity( data->opacity );
+}
+
+static inline void qwtExecCommand( 
+    QPainter *painter, const QwtPainterCommand &cmd, 
+    QwtGraphic::RenderHints renderHints,
+    const QTransform &transform,
+    const QTransform *initialTransform )
+{
+    switch( cmd.type() )
+    {
+        case QwtPainterCommand::Path:
+        {
+            if ( qwtDoMapPath( painter, renderHints ) )
+                qwtDrawMappedPath( painter, *cmd.path(), initialTransform );
             else
-            {
                 painter->drawPath( *cmd.path() );
-            }
+
             break;
         }
         case QwtPainterCommand::Pixmap:
@@ -127,77 +203,336 @@ static inline void qwtExecCommand(
         }
         case QwtPainterCommand::State:
         {
-            const QwtPainterCommand::StateData *data = cmd.stateData();
+            qwtExecState( painter, cmd.stateData(), transform );
+            break;
+        }
+        default:
+            break;
+    }
 
-            if ( data->flags & QPaintEngine::DirtyPen ) 
-                painter->setPen( data->pen );
+}
 
-            if ( data->flags & QPaintEngine::DirtyBrush ) 
-                painter->setBrush( data->brush );
+/*
+   A flattened representation of the recorded commands, that is
+   compiled once and replayed, whenever the graphic is rendered:
 
-            if ( data->flags & QPaintEngine::DirtyBrushOrigin ) 
-                painter->setBrushOrigin( data->brushOrigin );
+   - consecutive state changes are merged, and attributes, that
+     are set to the value they already have, are dropped
+   - paths made of a single subpath of lines are stored as
+     points and replayed as polygon/polyline
+ */
+class QwtGraphicStream
+{
+public:
+    enum OpType
+    {
+        // replaying the recorded command
+        Command,
 
-            if ( data->flags & QPaintEngine::DirtyFont ) 
-                painter->setFont( data->font );
+        // merged state change
+        State,
 
-            if ( data->flags & QPaintEngine::DirtyBackground ) 
-            {
-                painter->setBackgroundMode( data->backgroundMode );
-                painter->setBackground( data->backgroundBrush );
-            }
+        // single closed subpath of lines
+        Polygon,
 
-            if ( data->flags & QPaintEngine::DirtyTransform ) 
-            {
-                painter->setTransform( data->transform * transform );
-            }
+        // single open subpath of lines painted without brush
+        Polyline
+    };
 
-            if ( data->flags & QPaintEngine::DirtyClipEnabled ) 
-                painter->setClipping( data->isClipEnabled );
+    class Op
+    {
+    public:
+        OpType type;
 
-            if ( data->flags & QPaintEngine::DirtyClipRegion) 
-            {
-                painter->setClipRegion( data->clipRegion, 
-                    data->clipOperation );
-            }
+        // index of the recorded command or the merged state
+        int index;
 
-            if ( data->flags & QPaintEngine::DirtyClipPath ) 
-            {
-                painter->setClipPath( data->clipPath, data->clipOperation );
-            }
+        // range of points for Polygon/Polyline
+        int from;
+        int count;
+    };
 
-            if ( data->flags & QPaintEngine::DirtyHints) 
-            {
-                const QPainter::RenderHints hints = data->renderHints;
+    QwtGraphicStream():
+        isValid( false )
+    {
+    }
 
-                painter->setRenderHint( QPainter::Antialiasing,
-                    hints.testFlag( QPainter::Antialiasing ) );
+    void invalidate()
+    {
+        isValid = false;
 
-                painter->setRenderHint( QPainter::TextAntialiasing,
-                    hints.testFlag( QPainter::TextAntialiasing ) );
+        ops.clear();
+        states.clear();
+        points.clear();
+    }
 
-                painter->setRenderHint( QPainter::SmoothPixmapTransform,
-                    hints.testFlag( QPainter::SmoothPixmapTransform ) );
+    void compile( const QVector<QwtPainterCommand> &commands );
 
-                painter->setRenderHint( QPainter::HighQualityAntialiasing,
-                    hints.testFlag( QPainter::HighQualityAntialiasing ) );
+    void replay( QPainter *, const QVector<QwtPainterCommand> &commands,
+        QwtGraphic::RenderHints, const QTransform &transform,
+        const QTransform *initialTransform ) const;
 
-                painter->setRenderHint( QPainter::NonCosmeticDefaultPen,
-                    hints.testFlag( QPainter::NonCosmeticDefaultPen ) );
-            }
+    bool isValid;
 
-            if ( data->flags & QPaintEngine::DirtyCompositionMode) 
-                painter->setCompositionMode( data->compositionMode );
+    QVector<Op> ops;
+    QVector<QwtPainterCommand::StateData> states;
+    QVector<QPointF> points;
 
-            if ( data->flags & QPaintEngine::DirtyOpacity) 
-                painter->setOpacity( data->opacity );
+private:
+    void appendState( const QwtPainterCommand::StateData & );
+    bool appendPath( int index, const QPainterPath & );
 
-            break;
+    // the state, that is known at the current position of the stream
+    QwtPainterCommand::StateData d_state;
+    QPaintEngine::DirtyFlags d_knownFlags;
+};
+
+static inline bool qwtIsClipState( QPaintEngine::DirtyFlags flags )
+{
+    return flags & ( QPaintEngine::DirtyClipEnabled
+        | QPaintEngine::DirtyClipRegion | QPaintEngine::DirtyClipPath );
+}
+
+static void qwtMergeState( QwtPainterCommand::StateData &to,
+    const QwtPainterCommand::StateData &from )
+{
+    const QPaintEngine::DirtyFlags flags = from.flags;
+
+    if ( flags & QPaintEngine::DirtyPen )
+        to.pen = from.pen;
+
+    if ( flags & QPaintEngine::DirtyBrush )
+        to.brush = from.brush;
+
+    if ( flags & QPaintEngine::DirtyBrushOrigin )
+        to.brushOrigin = from.brushOrigin;
+
+    if ( flags & QPaintEngine::DirtyFont )
+        to.font = from.font;
+
+    if ( flags & QPaintEngine::DirtyBackground )
+    {
+        to.backgroundMode = from.backgroundMode;
+        to.backgroundBrush = from.backgroundBrush;
+    }
+
+    if ( flags & QPaintEngine::DirtyTransform )
+        to.transform = from.transform;
+
+    if ( flags & QPaintEngine::DirtyHints )
+        to.renderHints = from.renderHints;
+
+    if ( flags & QPaintEngine::DirtyCompositionMode )
+        to.compositionMode = from.compositionMode;
+
+    if ( flags & QPaintEngine::DirtyOpacity )
+        to.opacity = from.opacity;
+
+    to.flags |= flags;
+}
+
+void QwtGraphicStream::compile( const QVector<QwtPainterCommand> &commands )
+{
+    invalidate();
+
+    d_state = QwtPainterCommand::StateData();
+    d_knownFlags = QPaintEngine::DirtyFlags();
+
+    for ( int i = 0; i < commands.size(); i++ )
+    {
+        const QwtPainterCommand &cmd = commands[i];
+
+        if ( cmd.type() == QwtPainterCommand::State )
+        {
+            appendState( *cmd.stateData() );
+            continue;
         }
-        default:
-            break;
+
+        if ( cmd.type() == QwtPainterCommand::Path )
+        {
+            if ( appendPath( i, *cmd.path() ) )
+                continue;
+        }
+
+        Op op;
+        op.type = Command;
+        op.index = i;
+        op.from = op.count = 0;
+
+        ops += op;
     }
 
+    isValid = true;
+}
+
+void QwtGraphicStream::appendState( const QwtPainterCommand::StateData &state )
+{
+    QwtPainterCommand::StateData delta = state;
+
+    // dropping changes to what is already set
+
+    const QPaintEngine::DirtyFlags known = d_knownFlags & state.flags;
+
+    if ( ( known & QPaintEngine::DirtyPen ) && state.pen == d_state.pen )
+        delta.flags &= ~QPaintEngine::DirtyPen;
+
+    if ( ( known & QPaintEngine::DirtyBrush ) && state.brush == d_state.brush )
+        delta.flags &= ~QPaintEngine::DirtyBrush;
+
+    if ( ( known & QPaintEngine::DirtyBrushOrigin )
+        && state.brushOrigin == d_state.brushOrigin )
+    {
+        delta.flags &= ~QPaintEngine::DirtyBrushOrigin;
+    }
+
+    if ( ( known & QPaintEngine::DirtyFont ) && state.font == d_state.font )
+        delta.flags &= ~QPaintEngine::DirtyFont;
+
+    if ( ( known & QPaintEngine::DirtyTransform )
+        && state.transform == d_state.transform )
+    {
+        delta.flags &= ~QPaintEngine::DirtyTransform;
+    }
+
+    if ( ( known & QPaintEngine::DirtyHints )
+        && state.renderHints == d_state.renderHints )
+    {
+        delta.flags &= ~QPaintEngine::DirtyHints;
+    }
+
+    if ( ( known & QPaintEngine::DirtyCompositionMode )
+        && state.compositionMode == d_state.compositionMode )
+    {
+        delta.flags &= ~QPaintEngine::DirtyCompositionMode;
+    }
+
+    if ( ( known & QPaintEngine::DirtyOpacity )
+        && state.opacity == d_state.opacity )
+    {
+        delta.flags &= ~QPaintEngine::DirtyOpacity;
+    }
+
+    if ( delta.flags == 0 )
+        return;
+
+    if ( !qwtIsClipState( delta.flags ) )
+    {
+        qwtMergeState( d_state, delta );
+        d_knownFlags |= delta.flags;
+    }
+
+    // clip operations depend on the order of the state changes and
+    // are never merged
+
+    if ( !ops.isEmpty() && ops.last().type == State
+        && !qwtIsClipState( delta.flags )
+        && !qwtIsClipState( states[ ops.last().index ].flags ) )
+    {
+        qwtMergeState( states[ ops.last().index ], delta );
+    }
+    else
+    {
+        Op op;
+        op.type = State;
+        op.index = states.size();
+        op.from = op.count = 0;
+
+        ops += op;
+        states += delta;
+    }
+}
+
+bool QwtGraphicStream::appendPath( int index, const QPainterPath &path )
+{
+    const int numElements = path.elementCount();
+    if ( numElements < 2 || !path.elementAt( 0 ).isMoveTo() )
+        return false;
+
+    for ( int i = 1; i < numElements; i++ )
+    {
+        if ( !path.elementAt( i ).isLineTo() )
+            return false;
+    }
+
+    const QPointF p1 = path.elementAt( 0 );
+    const QPointF p2 = path.elementAt( numElements - 1 );
+
+    Op op;
+    op.index = index;
+    op.from = points.size();
+
+    if ( p1 == p2 )
+    {
+        op.type = Polygon;
+        op.count = numElements - 1;
+    }
+    else
+    {
+        // an open path would be closed, when being filled
+
+        const bool noBrush = ( d_knownFlags & QPaintEngine::DirtyBrush )
+            && d_state.brush.style() == Qt::NoBrush;
+
+        if ( !noBrush )
+            return false;
+
+        op.type = Polyline;
+        op.count = numElements;
+    }
+
+    for ( int i = 0; i < op.count; i++ )
+        points += path.elementAt( i );
+
+    ops += op;
+    return true;
+}
+
+void QwtGraphicStream::replay( QPainter *painter,
+    const QVector<QwtPainterCommand> &commands,
+    QwtGraphic::RenderHints renderHints, const QTransform &transform,
+    const QTransform *initialTransform ) const
+{
+    const Op *o = ops.constData();
+    const QwtPainterCommand *cmds = commands.constData();
+
+    for ( int i = 0; i < ops.size(); i++ )
+    {
+        const Op &op = o[i];
+
+        switch( op.type )
+        {
+            case State:
+            {
+                qwtExecState( painter, &states[ op.index ], transform );
+                break;
+            }
+            case Polygon:
+            case Polyline:
+            {
+                if ( qwtDoMapPath( painter, renderHints ) )
+                {
+                    qwtDrawMappedPath( painter,
+                        *cmds[ op.index ].path(), initialTransform );
+                }
+                else if ( op.type == Polygon )
+                {
+                    painter->drawPolygon( points.constData() + op.from,
+                        op.count, cmds[ op.index ].path()->fillRule() );
+                }
+                else
+                {
+                    painter->drawPolyline(
+                        points.constData() + op.from, op.count );
+                }
+                break;
+            }
+            default:
+            {
+                qwtExecCommand( painter, cmds[ op.index ],
+                    renderHints, transform, initialTransform );
+            }
+        }
+    }
 }
 
 class QwtGraphic::PathInfo
@@ -319,11 +654,30 @@ class QwtGraphic::PrivateData
 public:
     PrivateData():
         boundingRect( 0.0, 0.0, -1.0, -1.0 ),
-        pointRect( 0.0, 0.0, -1.0, -1.0 ),
-        initialTransform( NULL )
+        pointRect( 0.0, 0.0, -1.0, -1.0 )
     {
     }
 
+    void invalidateCaches()
+    {
+        stream.invalidate();
+        invalidateScaleCache();
+    }
+
+    void invalidateScaleCache()
+    {
+        scaleCache.size = QSizeF();
+        scaleCache.boundingRectScale = QSizeF();
+    }
+
+    const QwtGraphicStream &compiledStream()
+    {
+        if ( !stream.isValid )
+            stream.compile( commands );
+
+        return stream;
+    }
+
     QSizeF defaultSize;
     QVector<QwtPainterCommand> commands;
     QVector<QwtGraphic::PathInfo> pathInfos;
@@ -332,7 +686,21 @@ public:
     QRectF pointRect;
 
     QwtGraphic::RenderHints renderHints;
-    QTransform *initialTransform;
+
+    QwtGraphicStream stream;
+
+    struct ScaleCache
+    {
+        // scale factors of the last target size
+        QSizeF size;
+        double sx;
+        double sy;
+
+        // last result of scaledBoundingRect()
+        QSizeF boundingRectScale;
+        QRectF boundingRect;
+
+    } scaleCache;
 };
 
 /*!
@@ -394,6 +762,7 @@ void QwtGraphic::reset()
     d_data->pointRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
     d_data->defaultSize = QSizeF();
 
+    d_data->invalidateCaches();
 }
 
 /*!
@@ -428,6 +797,8 @@ void QwtGraphic::setRenderHint( RenderHint hint, bool on )
         d_data->renderHints |= hint;
     else
         d_data->renderHints &= ~hint;
+
+    d_data->invalidateScaleCache();
 }
 
 /*!
@@ -492,6 +863,10 @@ QRectF QwtGraphic::scaledBoundingRect( double sx, double sy ) const
     if ( sx == 1.0 && sy == 1.0 )
         return d_data->boundingRect;
 
+    PrivateData::ScaleCache &cache = d_data->scaleCache;
+    if ( cache.boundingRectScale == QSizeF( sx, sy ) )
+        return cache.boundingRect;
+
     QTransform transform;
     transform.scale( sx, sy );
 
@@ -503,6 +878,9 @@ QRectF QwtGraphic::scaledBoundingRect( double sx, double sy ) const
             !d_data->renderHints.testFlag( RenderPensUnscaled ) );
     }
 
+    cache.boundingRectScale = QSizeF( sx, sy );
+    cache.boundingRect = rect;
+
     return rect;
 }
 
@@ -558,6 +936,10 @@ QSizeF QwtGraphic::defaultSize() const
 
 /*!
   \brief Replay all recorded painter commands
+
+  The commands are compiled into a flattened stream with merged
+  state changes, when the graphic is rendered for the first time.
+
   \param painter Qt painter
  */
 void QwtGraphic::render( QPainter *painter ) const
@@ -565,18 +947,12 @@ void QwtGraphic::render( QPainter *painter ) const
     if ( isNull() )
         return;
 
-    const int numCommands = d_data->commands.size();
-    const QwtPainterCommand *commands = d_data->commands.constData();
-
     const QTransform transform = painter->transform();
 
     painter->save();
 
-    for ( int i = 0; i < numCommands; i++ )
-    {
-        qwtExecCommand( painter, commands[i], 
-            d_data->renderHints, transform, d_data->initialTransform );
-    }
+    d_data->compiledStream().replay( painter, d_data->commands,
+        d_data->renderHints, transform, NULL );
 
     painter->restore();
 }
@@ -613,35 +989,48 @@ void QwtGraphic::render( QPainter *painter, const QRectF &rect,
     if ( isEmpty() || rect.isEmpty() )
         return;
 
-    double sx = 1.0; 
-    double sy = 1.0;
-
-    if ( d_data->pointRect.width() > 0.0 )
-        sx = rect.width() / d_data->pointRect.width();
-
-    if ( d_data->pointRect.height() > 0.0 )
-        sy = rect.height() / d_data->pointRect.height();
-
     const bool scalePens = 
         !d_data->renderHints.testFlag( RenderPensUnscaled );
 
-    for ( int i = 0; i < d_data->pathInfos.size(); i++ )
+    PrivateData::ScaleCache &cache = d_data->scaleCache;
+    if ( cache.size != rect.size() )
     {
-        const PathInfo info = d_data->pathInfos[i];
+        // the scale factors depend on the size of the target only
 
-        const double ssx = info.scaleFactorX( 
-            d_data->pointRect, rect, scalePens );
+        double sx = 1.0; 
+        double sy = 1.0;
 
-        if ( ssx > 0.0 )
-            sx = qMin( sx, ssx );
+        if ( d_data->pointRect.width() > 0.0 )
+            sx = rect.width() / d_data->pointRect.width();
 
-        const double ssy = info.scaleFactorY( 
-            d_data->pointRect, rect, scalePens );
+        if ( d_data->pointRect.height() > 0.0 )
+            sy = rect.height() / d_data->pointRect.height();
 
-        if ( ssy > 0.0 )
-            sy = qMin( sy, ssy );
+        for ( int i = 0; i < d_data->pathInfos.size(); i++ )
+        {
+            const PathInfo &info = d_data->pathInfos[i];
+
+            const double ssx = info.scaleFactorX( 
+                d_data->pointRect, rect, scalePens );
+
+            if ( ssx > 0.0 )
+                sx = qMin( sx, ssx );
+
+            const double ssy = info.scaleFactorY( 
+                d_data->pointRect, rect, scalePens );
+
+            if ( ssy > 0.0 )
+                sy = qMin( sy, ssy );
+        }
+
+        cache.size = rect.size();
+        cache.sx = sx;
+        cache.sy = sy;
     }
 
+    double sx = cache.sx;
+    double sy = cache.sy;
+
     if ( aspectRatioMode == Qt::KeepAspectRatio )
     {
         const double s = qMin( sx, sy );
@@ -662,23 +1051,33 @@ void QwtGraphic::render( QPainter *painter, const QRectF &rect,
     tr.translate( -d_data->pointRect.x(), -d_data->pointRect.y() );
 
     const QTransform transform = painter->transform();
-    if ( !scalePens && transform.isScaling() )
+
+    QTransform initialTransform;
+    const bool hasInitialTransform = !scalePens && transform.isScaling();
+
+    if ( hasInitialTransform )
     {
         // we don't want to scale pens according to sx/sy,
         // but we want to apply the scaling from the 
         // painter transformation later
 
-        d_data->initialTransform = new QTransform();
-        d_data->initialTransform->scale( transform.m11(), transform.m22() );
+        initialTransform.scale( transform.m11(), transform.m22() );
     }
 
     painter->setTransform( tr, true );
-    render( painter );
 
-    painter->setTransform( transform );
+    if ( !isNull() )
+    {
+        painter->save();
+
+        d_data->compiledStream().replay( painter, d_data->commands,
+            d_data->renderHints, painter->transform(),
+            hasInitialTransform ? &initialTransform : NULL );
 
-    delete d_data->initialTransform;
-    d_data->initialTransform = NULL;
+        painter->restore();
+    }
+
+    painter->setTransform( transform );
 }
 
 /*!
@@ -865,6 +1264,7 @@ void QwtGraphic::drawPath( const QPainterPath &path )
         return;
 
     d_data->commands += QwtPainterCommand( path );
+    d_data->invalidateCaches();
 
     if ( !path.isEmpty() )
     {
@@ -904,6 +1304,7 @@ void QwtGraphic::drawPixmap( const QRectF &rect,
         return;
 
     d_data->commands += QwtPainterCommand( rect, pixmap, subRect );
+    d_data->invalidateCaches();
 
     const QRectF r = painter->transform().mapRect( rect );
     updateControlPointRect( r );
@@ -928,6 +1329,7 @@ void QwtGraphic::drawImage( const QRectF &rect, const QImage &image,
         return;
 
     d_data->commands += QwtPainterCommand( rect, image, subRect, flags );
+    d_data->invalidateCaches();
 
     const QRectF r = painter->transform().mapRect( rect );
 
@@ -944,6 +1346,7 @@ void QwtGraphic::drawImage( const QRectF &rect, const QImage &image,
 void QwtGraphic::updateState( const QPaintEngineState &state)
 {
     d_data->commands += QwtPainterCommand( state );
+    d_data->stream.invalidate();
 }
 
 void QwtGraphic::updateBoundingRect( const QRectF &rect )
@@ -278,6 +278,184 @@ double QwtMatrixRasterData::value( double x, double y ) const
     return value;
 }
 
+/*!
+   \brief Calculate the values for a row of positions
+
+   The row of the matrix ( BilinearInterpolation: the 2 rows and
+   their weights ) is looked up only once for all positions.
+   The results are the same as for calling value() for each position.
+
+   \param y Y value in plot coordinates
+   \param xValues Array of X values in plot coordinates
+   \param out Array, where to store the values
+   \param numValues Size of xValues and out
+
+   \sa value(), tileValues(), ResampleMode
+*/
+void QwtMatrixRasterData::values( double y,
+    const double *xValues, double *out, int numValues ) const
+{
+    tileValues( &y, 1, xValues, numValues, out );
+}
+
+/*!
+   \brief Calculate the values for a block of rows
+
+   The columns of the matrix ( BilinearInterpolation: the 2 columns and
+   their weights ) are looked up only once for all rows, the rows
+   only once for all columns. The results are the same as for calling
+   value() for each position.
+
+   \param yValues Array of Y values in plot coordinates, one for each row
+   \param numRows Size of yValues
+   \param xValues Array of X values in plot coordinates, one for each column
+   \param numColumns Size of xValues
+   \param out Array of numRows * numColumns values, where to store
+              the values row by row
+
+   \sa value(), values(), ResampleMode
+*/
+void QwtMatrixRasterData::tileValues( const double *yValues, int numRows,
+    const double *xValues, int numColumns, double *out ) const
+{
+    const QwtInterval xInterval = interval( Qt::XAxis );
+    const QwtInterval yInterval = interval( Qt::YAxis );
+
+    if ( !xInterval.isValid() || d_data->numRows <= 0 )
+    {
+        for ( int i = 0; i < numRows * numColumns; i++ )
+            out[i] = qQNaN();
+
+        return;
+    }
+
+    const bool isBilinear = ( d_data->resampleMode == BilinearInterpolation );
+
+    const double xMin = xInterval.minValue();
+    const double xMax = xInterval.maxValue();
+
+    const bool excludeMin = xInterval.borderFlags() & QwtInterval::ExcludeMinimum;
+    const bool excludeMax = xInterval.borderFlags() & QwtInterval::ExcludeMaximum;
+
+    const int matrixColumns = d_data->numColumns;
+    const double dx = d_data->dx;
+
+    /*
+      The columns of the matrix, that are used for each position:
+      col1 is -1 for positions outside of the matrix.
+      NearestNeighbour uses col1 only.
+     */
+    QVector<int> columns1( numColumns );
+    QVector<int> columns2;
+    QVector<double> weights;
+
+    if ( isBilinear )
+    {
+        columns2.resize( numColumns );
+        weights.resize( numColumns );
+    }
+
+    for ( int i = 0; i < numColumns; i++ )
+    {
+        const double x = xValues[i];
+
+        if ( x < xMin || x > xMax || ( x == xMin && excludeMin )
+            || ( x == xMax && excludeMax ) )
+        {
+            columns1[i] = -1;
+            continue;
+        }
+
+        if ( isBilinear )
+        {
+            int col1 = qRound( ( x - xMin ) / dx ) - 1;
+            int col2 = col1 + 1;
+
+            if ( col1 < 0 )
+                col1 = col2;
+            else if ( col2 >= matrixColumns )
+                col2 = col1;
+
+            const double x2 = xMin + ( col2 + 0.5 ) * dx;
+
+            columns1[i] = col1;
+            columns2[i] = col2;
+            weights[i] = ( x2 - x ) / dx;
+        }
+        else
+        {
+            int col = int( ( x - xMin ) / dx );
+            if ( col >= matrixColumns )
+                col = matrixColumns - 1;
+
+            columns1[i] = col;
+        }
+    }
+
+    const int *cols1 = columns1.constData();
+    const int *cols2 = columns2.constData();
+    const double *rx = weights.constData();
+
+    for ( int row = 0; row < numRows; row++ )
+    {
+        const double y = yValues[row];
+        double *rowValues = out + row * numColumns;
+
+        if ( !yInterval.contains( y ) )
+        {
+            for ( int i = 0; i < numColumns; i++ )
+                rowValues[i] = qQNaN();
+
+            continue;
+        }
+
+        if ( isBilinear )
+        {
+            int row1 = qRound( ( y - yInterval.minValue() ) / d_data->dy ) - 1;
+            int row2 = row1 + 1;
+
+            if ( row1 < 0 )
+                row1 = row2;
+            else if ( row2 >= d_data->numRows )
+                row2 = row1;
+
+            const double *line1 = d_data->values.constData() + row1 * matrixColumns;
+            const double *line2 = d_data->values.constData() + row2 * matrixColumns;
+
+            const double y2 = yInterval.minValue() + ( row2 + 0.5 ) * d_data->dy;
+            const double ry = ( y2 - y ) / d_data->dy;
+
+            for ( int i = 0; i < numColumns; i++ )
+            {
+                const int col1 = cols1[i];
+                if ( col1 < 0 )
+                {
+                    rowValues[i] = qQNaN();
+                    continue;
+                }
+
+                const int col2 = cols2[i];
+
+                const double vr1 = rx[i] * line1[col1] + ( 1.0 - rx[i] ) * line1[col2];
+                const double vr2 = rx[i] * line2[col1] + ( 1.0 - rx[i] ) * line2[col2];
+
+                rowValues[i] = ry * vr1 + ( 1.0 - ry ) * vr2;
+            }
+        }
+        else
+        {
+            int matrixRow = int( ( y - yInterval.minValue() ) / d_data->dy );
+            if ( matrixRow >= d_data->numRows )
+                matrixRow = d_data->numRows - 1;
+
+            const double *line = d_data->values.constData() + matrixRow * matrixColumns;
+
+            for ( int i = 0; i < numColumns; i++ )
+                rowValues[i] = ( cols1[i] >= 0 ) ? line[cols1[i]] : qQNaN();
+        }
+    }
+}
+
 void QwtMatrixRasterData::update()
 {
     d_data->numRows = 0;
@@ -64,6 +64,12 @@ public:
 
     virtual double value( double x, double y ) const;
 
+    virtual void values( double y, const double *xValues,
+        double *out, int numValues ) const;
+
+    virtual void tileValues( const double *yValues, int numRows,
+        const double *xValues, int numColumns, double *out ) const;
+
 private:
     void update();
 
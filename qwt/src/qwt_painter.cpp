@@ -103,46 +103,53 @@ static inline bool qwtIsClippingNeeded(
     return doClipping;
 }
 
-template <class T>
-static inline void qwtDrawPolyline( QPainter *painter,
-    const T *points, int pointCount, bool polylineSplitting )
+static inline bool qwtIsSplittingNeeded( const QPainter *painter )
 {
     bool doSplit = false;
-    if ( polylineSplitting && pointCount > 3 )
+
+    const QPaintEngine *pe = painter->paintEngine();
+    if ( pe && pe->type() == QPaintEngine::Raster )
     {
-        const QPaintEngine *pe = painter->paintEngine();
-        if ( pe && pe->type() == QPaintEngine::Raster )
+        if ( painter->pen().width() <= 1 )
         {
-            if ( painter->pen().width() <= 1 )
-            {
 #if QT_VERSION < 0x040800
-                if ( painter->renderHints() & QPainter::Antialiasing )
-                {
-                    /*
-                        all versions <= 4.7 have issues with 
-                        antialiased lines
-                     */
-
-                    doSplit = true;
-                }
-#endif
-                // work around a bug with short lines below 2 pixels difference
-                // in height and width
-
-                doSplit = qwtIsRasterPaintEngineBuggy();
-            }
-            else
+            if ( painter->renderHints() & QPainter::Antialiasing )
             {
                 /*
-                   Raster paint engine is much faster when splitting
-                   the polygon, but of course we might see some issues where
-                   the pieces are joining
+                    all versions <= 4.7 have issues with 
+                    antialiased lines
                  */
+
                 doSplit = true;
             }
+#endif
+            // work around a bug with short lines below 2 pixels difference
+            // in height and width
+
+            doSplit = qwtIsRasterPaintEngineBuggy();
+        }
+        else
+        {
+            /*
+               Raster paint engine is much faster when splitting
+               the polygon, but of course we might see some issues where
+               the pieces are joining
+             */
+            doSplit = true;
         }
     }
 
+    return doSplit;
+}
+
+template <class T>
+static inline void qwtDrawPolyline( QPainter *painter,
+    const T *points, int pointCount, bool polylineSplitting )
+{
+    bool doSplit = false;
+    if ( polylineSplitting && pointCount > 3 )
+        doSplit = qwtIsSplittingNeeded( painter );
+
     if ( doSplit )
     {
         QPen pen = painter->pen();
@@ -590,6 +597,73 @@ void QwtPainter::drawPolyline( QPainter *painter,
     }
 }
 
+/*!
+  Draw many polylines in one call
+
+  The polylines are stored one after the other in points, like
+  the runs being returned from QwtClipper::splitPolylineF().
+  They are painted as subpaths of one QPainterPath, so that
+  the paint engine is called only once. When the polylines
+  have to be split ( see polylineSplitting() ) or clipped
+  for the paint device, they are painted one by one.
+
+  \param painter Painter
+  \param points Points of all polylines
+  \param pointCounts Number of points of each polyline
+  \param polylineCount Number of polylines
+
+  \sa drawPolyline(), QwtClipper::splitPolylineF()
+*/
+void QwtPainter::drawPolylines( QPainter *painter, const QPointF *points,
+    const int *pointCounts, int polylineCount )
+{
+    QRectF clipRect;
+    const bool deviceClipping = qwtIsClippingNeeded( painter, clipRect );
+
+    if ( deviceClipping || ( d_polylineSplitting
+        && qwtIsSplittingNeeded( painter ) ) )
+    {
+        for ( int i = 0; i < polylineCount; i++ )
+        {
+            drawPolyline( painter, points, pointCounts[i] );
+            points += pointCounts[i];
+        }
+
+        return;
+    }
+
+    QPainterPath path;
+
+    for ( int i = 0; i < polylineCount; i++ )
+    {
+        const int n = pointCounts[i];
+        if ( n > 1 )
+        {
+            path.moveTo( points[0] );
+            for ( int j = 1; j < n; j++ )
+                path.lineTo( points[j] );
+        }
+
+        points += n;
+    }
+
+    if ( path.isEmpty() )
+        return;
+
+    const QBrush brush = painter->brush();
+    if ( brush.style() != Qt::NoBrush )
+    {
+        // a polyline is never filled
+        painter->setBrush( Qt::NoBrush );
+        painter->drawPath( path );
+        painter->setBrush( brush );
+    }
+    else
+    {
+        painter->drawPath( path );
+    }
+}
+
 //! Wrapper for QPainter::drawPolygon()
 void QwtPainter::drawPolygon( QPainter *painter, const QPolygon &polygon )
 {
@@ -72,6 +72,8 @@ public:
     static void drawPolygon( QPainter *, const QPolygonF & );
     static void drawPolyline( QPainter *, const QPolygonF & );
     static void drawPolyline( QPainter *, const QPointF *, int pointCount );
+    static void drawPolylines( QPainter *, const QPointF *,
+        const int *pointCounts, int polylineCount );
 
     static void drawPolygon( QPainter *, const QPolygon & );
     static void drawPolyline( QPainter *, const QPolygon & );
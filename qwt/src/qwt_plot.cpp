@@ -18,10 +18,19 @@
 #include "qwt_plot_canvas.h"
 #include <qmath.h>
 #include <qpainter.h>
+#include <qpixmap.h>
 #include <qpointer.h>
 #include <qpaintengine.h>
 #include <qapplication.h>
 #include <qevent.h>
+#include <qimage.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#if !defined(QT_NO_QFUTURE)
+#define QWT_USE_THREADS 1
+#endif
 
 static inline void qwtEnableLegendItems( QwtPlot *plot, bool on )
 {
@@ -91,6 +100,260 @@ static void qwtSetTabOrder(
     }
 }
 
+static void qwtDrawItem( QPainter *painter, const QwtPlotItem *item,
+    const QRectF &canvasRect, const QwtScaleMap maps[QwtPlot::axisCnt] )
+{
+    painter->save();
+
+    painter->setRenderHint( QPainter::Antialiasing,
+        item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+    painter->setRenderHint( QPainter::HighQualityAntialiasing,
+        item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+    item->draw( painter,
+        maps[item->xAxis()], maps[item->yAxis()],
+        canvasRect );
+
+    painter->restore();
+}
+
+static inline bool qwtMapsEqual( const QwtScaleMap &map1, const QwtScaleMap &map2 )
+{
+    if ( map1.s1() != map2.s1() || map1.s2() != map2.s2()
+        || map1.p1() != map2.p1() || map1.p2() != map2.p2() )
+    {
+        return false;
+    }
+
+    // f.e linear and logarithmic maps with the same intervals
+    const double s = 0.5 * ( map1.s1() + map1.s2() );
+    return map1.transform( s ) == map2.transform( s );
+}
+
+class QwtPlotCacheRun
+{
+public:
+    // consecutive items of the same cache layer
+    int layer;
+    QList<const QwtPlotItem *> items;
+    QPixmap pixmap;
+};
+
+class QwtPlotLayerCache
+{
+public:
+    QwtPlotLayerCache():
+        pixelRatio( 1.0 )
+    {
+    }
+
+    void invalidate()
+    {
+        runs.clear();
+        dirtyLayers.clear();
+    }
+
+    void invalidate( int layer )
+    {
+        if ( !runs.isEmpty() && !dirtyLayers.contains( layer ) )
+            dirtyLayers += layer;
+    }
+
+    void begin( const QPainter *painter, const QRectF &canvasRect,
+        const QwtScaleMap maps[QwtPlot::axisCnt] )
+    {
+        qreal ratio = 1.0;
+#if QT_VERSION >= 0x050100
+        ratio = painter->device()->devicePixelRatio();
+#else
+        Q_UNUSED( painter )
+#endif
+        bool isValid = ( ratio == pixelRatio ) && ( canvasRect == rect );
+        for ( int axisId = 0; isValid && axisId < QwtPlot::axisCnt; axisId++ )
+            isValid = qwtMapsEqual( maps[axisId], scaleMaps[axisId] );
+
+        if ( !isValid )
+        {
+            invalidate();
+
+            pixelRatio = ratio;
+            rect = canvasRect;
+            for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+                scaleMaps[axisId] = maps[axisId];
+        }
+
+        oldRuns = runs;
+        runs.clear();
+    }
+
+    QPixmap pixmap( int layer, const QList<const QwtPlotItem *> &items )
+    {
+        QwtPlotCacheRun run;
+        run.layer = layer;
+        run.items = items;
+
+        if ( !dirtyLayers.contains( layer ) )
+        {
+            for ( int i = 0; i < oldRuns.size(); i++ )
+            {
+                if ( oldRuns[i].layer == layer && oldRuns[i].items == items )
+                {
+                    run.pixmap = oldRuns[i].pixmap;
+                    break;
+                }
+            }
+        }
+
+        if ( run.pixmap.isNull() )
+            render( run );
+
+        runs += run;
+        return run.pixmap;
+    }
+
+    void end()
+    {
+        oldRuns.clear();
+        dirtyLayers.clear();
+    }
+
+private:
+    void render( QwtPlotCacheRun &run ) const
+    {
+        const QSize size = rect.size().toSize();
+
+#if QT_VERSION >= 0x050100
+        run.pixmap = QPixmap( size * pixelRatio );
+        run.pixmap.setDevicePixelRatio( pixelRatio );
+#else
+        run.pixmap = QPixmap( size );
+#endif
+        run.pixmap.fill( Qt::transparent );
+
+        QPainter painter( &run.pixmap );
+        painter.translate( -rect.topLeft() );
+
+        for ( int i = 0; i < run.items.size(); i++ )
+            qwtDrawItem( &painter, run.items[i], rect, scaleMaps );
+    }
+
+    qreal pixelRatio;
+    QRectF rect;
+    QwtScaleMap scaleMaps[QwtPlot::axisCnt];
+
+    QList<QwtPlotCacheRun> runs;
+    QList<QwtPlotCacheRun> oldRuns;
+    QList<int> dirtyLayers;
+};
+
+class QwtPlotDrawEntry
+{
+public:
+    enum Type
+    {
+        // painted directly
+        Item,
+
+        // painted from a pixmap of the layer cache
+        CacheRun,
+
+        // rendered in a different thread into an image
+        RenderJob
+    };
+
+    Type type;
+    int layer;
+    QList<const QwtPlotItem *> items;
+
+    QImage image;
+#if QWT_USE_THREADS
+    QFuture<void> future;
+#endif
+};
+
+static void qwtRenderItems( QwtPlotDrawEntry *entry, const QRectF &canvasRect,
+    const QwtScaleMap *maps, qreal pixelRatio )
+{
+    const QSize size = canvasRect.size().toSize();
+
+#if QT_VERSION >= 0x050100
+    entry->image = QImage( size * pixelRatio, QImage::Format_ARGB32_Premultiplied );
+    entry->image.setDevicePixelRatio( pixelRatio );
+#else
+    Q_UNUSED( pixelRatio )
+    entry->image = QImage( size, QImage::Format_ARGB32_Premultiplied );
+#endif
+    entry->image.fill( Qt::transparent );
+
+    QPainter painter( &entry->image );
+    painter.translate( -canvasRect.topLeft() );
+
+    for ( int i = 0; i < entry->items.size(); i++ )
+        qwtDrawItem( &painter, entry->items[i], canvasRect, maps );
+}
+
+static void qwtAppendRenderJobs( QList<QwtPlotDrawEntry> &entries,
+    const QList<const QwtPlotItem *> &items, int numThreads )
+{
+    // consecutive items are distributed to numThreads images,
+    // so that the z order is kept, when composing them
+
+    const int numJobs = qMin( numThreads, items.size() );
+
+    for ( int i = 0; i < numJobs; i++ )
+    {
+        const int from = i * items.size() / numJobs;
+        const int to = ( i + 1 ) * items.size() / numJobs;
+
+        QwtPlotDrawEntry entry;
+        entry.type = QwtPlotDrawEntry::RenderJob;
+        entry.layer = QwtPlotItem::NoCacheLayer;
+        entry.items = items.mid( from, to - from );
+
+        entries += entry;
+    }
+}
+
+class QwtPlotCanvasImage
+{
+public:
+    QwtPlotCanvasImage():
+        isPending( false ),
+        revision( 0 )
+    {
+    }
+
+    bool isValid( const QRectF &canvasRect, qreal pixelRatio,
+        const QwtScaleMap scaleMaps[QwtPlot::axisCnt], uint itemRevision ) const
+    {
+        if ( image.isNull() || canvasRect != rect || revision != itemRevision )
+            return false;
+
+#if QT_VERSION >= 0x050100
+        if ( image.devicePixelRatio() != pixelRatio )
+            return false;
+#else
+        Q_UNUSED( pixelRatio )
+#endif
+
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        {
+            if ( !qwtMapsEqual( scaleMaps[axisId], maps[axisId] ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    // the next drawCanvas() renders into the image
+    bool isPending;
+
+    QImage image;
+    QRectF rect;
+    uint revision;
+    QwtScaleMap maps[QwtPlot::axisCnt];
+};
+
 class QwtPlot::PrivateData
 {
 public:
@@ -101,6 +364,11 @@ public:
     QwtPlotLayout *layout;
 
     bool autoReplot;
+    uint renderThreadCount;
+    uint itemRevision;
+
+    QwtPlotLayerCache layerCache;
+    QwtPlotCanvasImage canvasImage;
 };
 
 /*!
@@ -145,6 +413,8 @@ void QwtPlot::initPlot( const QwtText &title )
 
     d_data->layout = new QwtPlotLayout;
     d_data->autoReplot = false;
+    d_data->renderThreadCount = 1;
+    d_data->itemRevision = 0;
 
     // title
     d_data->titleLabel = new QwtTextLabel( this );
@@ -557,6 +827,14 @@ void QwtPlot::replot()
      */
     QApplication::sendPostedEvents( this, QEvent::LayoutRequest );
 
+    if ( !d_data->canvasImage.isPending )
+    {
+        // the image of the last rescaling of a zoomer
+        // might not reflect the current state of the items
+
+        d_data->canvasImage.image = QImage();
+    }
+
     if ( d_data->canvas )
     {
         const bool ok = QMetaObject::invokeMethod( 
@@ -730,10 +1008,16 @@ void QwtPlot::updateCanvasMargins()
   Redraw the canvas.
   \param painter Painter used for drawing
 
+  When items have been assigned to cache layers, the consecutive
+  items of a layer are painted from a pixmap, that is reused
+  until one of the items has changed. With more than one render thread
+  the items with the QwtPlotItem::ThreadSafe attribute are rendered
+  in parallel. All other items are painted in z order like in drawItems().
+
   \warning drawCanvas calls drawItems what is also used
            for printing. Applications that like to add individual
            plot items better overload drawItems()
-  \sa drawItems()
+  \sa drawItems(), QwtPlotItem::setCacheLayer()
 */
 void QwtPlot::drawCanvas( QPainter *painter )
 {
@@ -741,7 +1025,305 @@ void QwtPlot::drawCanvas( QPainter *painter )
     for ( int axisId = 0; axisId < axisCnt; axisId++ )
         maps[axisId] = canvasMap( axisId );
 
-    drawItems( painter, d_data->canvas->contentsRect(), maps );
+    const QRectF canvasRect = d_data->canvas->contentsRect();
+
+    QwtPlotCanvasImage &canvasImage = d_data->canvasImage;
+    if ( !canvasImage.isPending )
+    {
+        drawCanvasItems( painter, canvasRect, maps );
+        return;
+    }
+
+    /*
+      The replot of a QwtPlotZoomer, that has rescaled the plot:
+      the items are rendered into an image, that can be taken over
+      by the zoomer - or an image of its cache is painted instead.
+     */
+    canvasImage.isPending = false;
+
+    qreal pixelRatio = 1.0;
+#if QT_VERSION >= 0x050100
+    pixelRatio = painter->device()->devicePixelRatio();
+#endif
+
+    if ( !canvasImage.isValid( canvasRect, pixelRatio,
+        maps, d_data->itemRevision ) )
+    {
+        const QSize size = canvasRect.size().toSize();
+
+        QImage image( size * pixelRatio, QImage::Format_ARGB32_Premultiplied );
+#if QT_VERSION >= 0x050100
+        image.setDevicePixelRatio( pixelRatio );
+#endif
+        image.fill( Qt::transparent );
+
+        QPainter imagePainter( &image );
+        imagePainter.translate( -canvasRect.topLeft() );
+
+        drawCanvasItems( &imagePainter, canvasRect, maps );
+        imagePainter.end();
+
+        canvasImage.image = image;
+        canvasImage.rect = canvasRect;
+        canvasImage.revision = d_data->itemRevision;
+
+        for ( int axisId = 0; axisId < axisCnt; axisId++ )
+            canvasImage.maps[axisId] = maps[axisId];
+    }
+
+    painter->drawImage( canvasRect.topLeft(), canvasImage.image );
+}
+
+void QwtPlot::drawCanvasItems( QPainter *painter, const QRectF &canvasRect,
+    const QwtScaleMap maps[axisCnt] )
+{
+    int numThreads = 1;
+#if QWT_USE_THREADS
+    numThreads = static_cast<int>( d_data->renderThreadCount );
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+#endif
+
+    bool hasCacheLayers = false;
+    int numThreadSafeItems = 0;
+
+    const QwtPlotItemList& itmList = itemList();
+    for ( QwtPlotItemIterator it = itmList.begin();
+        it != itmList.end(); ++it )
+    {
+        const QwtPlotItem *item = *it;
+
+        if ( item->cacheLayer() >= 0 )
+            hasCacheLayers = true;
+        else if ( item->isVisible()
+            && item->testItemAttribute( QwtPlotItem::ThreadSafe ) )
+        {
+            numThreadSafeItems++;
+        }
+    }
+
+    if ( numThreadSafeItems < 2 )
+        numThreads = 1;
+
+    if ( !hasCacheLayers && numThreads == 1 )
+    {
+        d_data->layerCache.invalidate();
+        drawItems( painter, canvasRect, maps );
+        return;
+    }
+
+    // splitting the items into entries in z order
+
+    QList<QwtPlotDrawEntry> entries;
+    QList<const QwtPlotItem *> threadSafeItems;
+
+    for ( int i = 0; i < itmList.size(); i++ )
+    {
+        const QwtPlotItem *item = itmList[i];
+        if ( !item->isVisible() )
+            continue;
+
+        if ( numThreads > 1 && item->cacheLayer() < 0
+            && item->testItemAttribute( QwtPlotItem::ThreadSafe ) )
+        {
+            threadSafeItems += item;
+            continue;
+        }
+
+        if ( !threadSafeItems.isEmpty() )
+        {
+            qwtAppendRenderJobs( entries, threadSafeItems, numThreads );
+            threadSafeItems.clear();
+        }
+
+        if ( item->cacheLayer() >= 0 && !entries.isEmpty()
+            && entries.last().type == QwtPlotDrawEntry::CacheRun
+            && entries.last().layer == item->cacheLayer() )
+        {
+            entries.last().items += item;
+        }
+        else
+        {
+            QwtPlotDrawEntry entry;
+            entry.type = ( item->cacheLayer() >= 0 )
+                ? QwtPlotDrawEntry::CacheRun : QwtPlotDrawEntry::Item;
+            entry.layer = item->cacheLayer();
+            entry.items += item;
+
+            entries += entry;
+        }
+    }
+
+    if ( !threadSafeItems.isEmpty() )
+        qwtAppendRenderJobs( entries, threadSafeItems, numThreads );
+
+    qreal pixelRatio = 1.0;
+#if QT_VERSION >= 0x050100
+    pixelRatio = painter->device()->devicePixelRatio();
+#endif
+
+#if QWT_USE_THREADS
+    for ( int i = 0; i < entries.size(); i++ )
+    {
+        QwtPlotDrawEntry &entry = entries[i];
+        if ( entry.type == QwtPlotDrawEntry::RenderJob )
+        {
+            entry.future = QtConcurrent::run( &qwtRenderItems,
+                &entry, canvasRect, maps, pixelRatio );
+        }
+    }
+#endif
+
+    // painting/composing the entries in z order
+
+    d_data->layerCache.begin( painter, canvasRect, maps );
+
+    for ( int i = 0; i < entries.size(); i++ )
+    {
+        QwtPlotDrawEntry &entry = entries[i];
+
+        switch( entry.type )
+        {
+            case QwtPlotDrawEntry::Item:
+            {
+                qwtDrawItem( painter, entry.items[0], canvasRect, maps );
+                break;
+            }
+            case QwtPlotDrawEntry::CacheRun:
+            {
+                painter->drawPixmap( canvasRect.topLeft(),
+                    d_data->layerCache.pixmap( entry.layer, entry.items ) );
+                break;
+            }
+            case QwtPlotDrawEntry::RenderJob:
+            {
+#if QWT_USE_THREADS
+                entry.future.waitForFinished();
+#endif
+                painter->drawImage( canvasRect.topLeft(), entry.image );
+                break;
+            }
+        }
+    }
+
+    d_data->layerCache.end();
+}
+
+/*!
+  Set the number of threads for rendering the plot items
+
+  When the number of threads is > 1, plot items with the
+  QwtPlotItem::ThreadSafe attribute are rendered in parallel
+  into images, that are composed in z order afterwards.
+  Consecutive items are grouped, so that the number of images is
+  limited by the number of threads.
+
+  Only items, that are not assigned to a cache layer, are rendered
+  in parallel. All other items are painted in the GUI thread.
+
+  \param numThreads Number of threads to be used for rendering.
+                    If numThreads is set to 0, the system specific
+                    ideal thread count is used.
+                    The default setting is 1 ( = no additional threads ).
+
+  \note The threads are used for drawCanvas() only. drawItems(), that
+        is also used for printing, renders all items sequentially.
+  \sa renderThreadCount(), QwtPlotItem::ThreadSafe
+*/
+void QwtPlot::setRenderThreadCount( uint numThreads )
+{
+    d_data->renderThreadCount = numThreads;
+}
+
+/*!
+  \return Number of threads for rendering the plot items
+  \sa setRenderThreadCount()
+*/
+uint QwtPlot::renderThreadCount() const
+{
+    return d_data->renderThreadCount;
+}
+
+/*!
+  The item revision is a counter, that is increased, whenever
+  an item has been attached, detached or has indicated a
+  change by QwtPlotItem::itemChanged().
+
+  It can be used to identify outdated images of the canvas.
+
+  \return Revision of the plot items
+  \sa QwtPlotItem::itemChanged()
+*/
+uint QwtPlot::itemRevision() const
+{
+    return d_data->itemRevision;
+}
+
+void QwtPlot::increaseItemRevision()
+{
+    d_data->itemRevision++;
+}
+
+void QwtPlot::retainCanvasImage( bool on )
+{
+    d_data->canvasImage.isPending = on;
+    if ( !on )
+        d_data->canvasImage.image = QImage();
+}
+
+void QwtPlot::setCanvasImage( const QImage &image,
+    const QwtScaleMap maps[axisCnt] )
+{
+    QwtPlotCanvasImage &canvasImage = d_data->canvasImage;
+
+    canvasImage.image = image;
+    canvasImage.rect = d_data->canvas ?
+        QRectF( d_data->canvas->contentsRect() ) : QRectF();
+    canvasImage.revision = d_data->itemRevision;
+
+    for ( int axisId = 0; axisId < axisCnt; axisId++ )
+        canvasImage.maps[axisId] = maps[axisId];
+}
+
+QImage QwtPlot::canvasImage( QwtScaleMap maps[axisCnt] ) const
+{
+    const QwtPlotCanvasImage &canvasImage = d_data->canvasImage;
+    if ( canvasImage.revision != d_data->itemRevision )
+        return QImage();
+
+    for ( int axisId = 0; axisId < axisCnt; axisId++ )
+        maps[axisId] = canvasImage.maps[axisId];
+
+    return canvasImage.image;
+}
+
+/*!
+  \brief Invalidate the pixmap of a cache layer
+
+  The items of the layer will be painted again by the
+  next replot.
+
+  \param layer Cache layer
+  \note Usually this is done by QwtPlotItem::itemChanged()
+        and there is no need to call invalidateCacheLayer() manually.
+
+  \sa invalidateCacheLayers(), QwtPlotItem::setCacheLayer()
+*/
+void QwtPlot::invalidateCacheLayer( int layer )
+{
+    d_data->layerCache.invalidate( layer );
+}
+
+/*!
+  \brief Invalidate the pixmaps of all cache layers
+  \sa invalidateCacheLayer(), QwtPlotItem::setCacheLayer()
+*/
+void QwtPlot::invalidateCacheLayers()
+{
+    d_data->layerCache.invalidate();
 }
 
 /*!
@@ -766,20 +1348,7 @@ void QwtPlot::drawItems( QPainter *painter, const QRectF &canvasRect,
     {
         QwtPlotItem *item = *it;
         if ( item && item->isVisible() )
-        {
-            painter->save();
-
-            painter->setRenderHint( QPainter::Antialiasing,
-                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
-            painter->setRenderHint( QPainter::HighQualityAntialiasing,
-                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
-
-            item->draw( painter,
-                maps[item->xAxis()], maps[item->yAxis()],
-                canvasRect );
-
-            painter->restore();
-        }
+            qwtDrawItem( painter, item, canvasRect, maps );
     }
 }
 
@@ -1105,6 +1674,11 @@ void QwtPlot::attachItem( QwtPlotItem *plotItem, bool on )
     else 
         removeItem( plotItem );
 
+    increaseItemRevision();
+
+    if ( plotItem->cacheLayer() >= 0 )
+        invalidateCacheLayer( plotItem->cacheLayer() );
+
     Q_EMIT itemAttached( plotItem, on );
 
     if ( plotItem->testItemAttribute( QwtPlotItem::Legend ) )
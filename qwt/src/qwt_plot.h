@@ -26,6 +26,7 @@ class QwtScaleEngine;
 class QwtScaleDiv;
 class QwtScaleDraw;
 class QwtTextLabel;
+class QImage;
 
 /*!
   \brief A 2-D plotting widget
@@ -241,6 +242,14 @@ public:
     virtual void updateLayout();
     virtual void drawCanvas( QPainter * );
 
+    void invalidateCacheLayer( int layer );
+    void invalidateCacheLayers();
+
+    void setRenderThreadCount( uint numThreads );
+    uint renderThreadCount() const;
+
+    uint itemRevision() const;
+
     void updateAxes();
     void updateCanvasMargins();
 
@@ -295,6 +304,15 @@ private Q_SLOTS:
 private:
     friend class QwtPlotItem;
     void attachItem( QwtPlotItem *, bool );
+    void increaseItemRevision();
+
+    friend class QwtPlotZoomer;
+    void retainCanvasImage( bool );
+    void setCanvasImage( const QImage &, const QwtScaleMap maps[axisCnt] );
+    QImage canvasImage( QwtScaleMap maps[axisCnt] ) const;
+
+    void drawCanvasItems( QPainter *, const QRectF &,
+        const QwtScaleMap maps[axisCnt] );
 
     void initAxesData();
     void deleteAxesData();
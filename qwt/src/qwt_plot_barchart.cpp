@@ -13,6 +13,18 @@
 #include "qwt_painter.h"
 #include <qpainter.h>
 
+static inline bool qwtIsVisible(
+    const QwtColumnRect &column, const QRectF &clipRect )
+{
+    const QwtInterval &h = column.hInterval;
+    const QwtInterval &v = column.vInterval;
+
+    return qMax( h.minValue(), h.maxValue() ) >= clipRect.left()
+        && qMin( h.minValue(), h.maxValue() ) <= clipRect.right()
+        && qMax( v.minValue(), v.maxValue() ) >= clipRect.top()
+        && qMin( v.minValue(), v.maxValue() ) <= clipRect.bottom();
+}
+
 class QwtPlotBarChart::PrivateData
 {
 public:
@@ -29,6 +41,7 @@ public:
 
     QwtColumnSymbol *symbol;
     QwtPlotBarChart::LegendMode legendMode;
+    QwtPlotBarChart::PaintAttributes paintAttributes;
 };
 
 /*!
@@ -69,6 +82,32 @@ int QwtPlotBarChart::rtti() const
     return QwtPlotItem::Rtti_PlotBarChart;
 }
 
+/*!
+  Specify an attribute how to draw the chart
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotBarChart::setPaintAttribute(
+    PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa setPaintAttribute()
+*/
+bool QwtPlotBarChart::testPaintAttribute(
+    PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Initialize data with an array of points
 
@@ -228,6 +267,11 @@ void QwtPlotBarChart::drawSeries( QPainter *painter,
     if ( from > to )
         return;
 
+    if ( d_data->paintAttributes & BatchedBars )
+    {
+        drawBatchedBars( painter, xMap, yMap, canvasRect, from, to );
+        return;
+    }
 
     const QRectF br = data()->boundingRect();
     const QwtInterval interval( br.left(), br.right() );
@@ -243,6 +287,66 @@ void QwtPlotBarChart::drawSeries( QPainter *painter,
     painter->restore();
 }
 
+/*!
+  Draw an interval of the bar chart in BatchedBars mode
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+  \param from Index of the first sample to be painted
+  \param to Index of the last sample to be painted
+
+  \sa drawSeries(), BatchedBars
+*/
+void QwtPlotBarChart::drawBatchedBars( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    const QwtSeriesData<QPointF> *series = data();
+
+    QwtPointSpan span;
+    const bool hasSpan = series->pointSpan( span );
+
+    const QRectF br = series->boundingRect();
+    const QwtInterval interval( br.left(), br.right() );
+
+    const QwtColumnSymbol *sym = d_data->symbol;
+
+    // we build a temporary default symbol
+    QwtColumnSymbol defaultSymbol( QwtColumnSymbol::Box );
+    defaultSymbol.setLineWidth( 1 );
+    defaultSymbol.setFrameStyle( QwtColumnSymbol::Plain );
+
+    if ( sym == NULL )
+        sym = &defaultSymbol;
+
+    const double margin = sym->lineWidth() + 1.0;
+    const QRectF clipRect =
+        canvasRect.adjusted( -margin, -margin, margin, margin );
+
+    QVector<QwtColumnRect> columns;
+    columns.reserve( to - from + 1 );
+
+    for ( int i = from; i <= to; i++ )
+    {
+        const QPointF sample = hasSpan ? span.sample( i ) : series->sample( i );
+
+        const QwtColumnRect column = columnRect( xMap, yMap,
+            canvasRect, interval, sample );
+
+        if ( qwtIsVisible( column, clipRect ) )
+            columns += column;
+    }
+
+    if ( !columns.isEmpty() )
+    {
+        painter->save();
+        sym->drawColumns( painter, columns.constData(), columns.size() );
+        painter->restore();
+    }
+}
+
 /*!
   Calculate the geometry of a bar in widget coordinates
 
@@ -67,6 +67,30 @@ public:
         LegendBarTitles
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        The default setting disables all attributes
+
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          Collect the bars of all samples and paint them with one
+          QwtColumnSymbol::drawColumns() call. Bars outside of the
+          canvas are skipped. When the series offers its points as
+          QwtPointSpan the samples are read directly from memory.
+
+          The geometry of the bars is calculated by columnRect()
+          like in the default mode, but drawSample(), drawBar() and
+          specialSymbol() are not called.
+         */
+        BatchedBars = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotBarChart( const QString &title = QString::null );
     explicit QwtPlotBarChart( const QwtText &title );
 
@@ -74,6 +98,9 @@ public:
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setSamples( const QVector<QPointF> & );
     void setSamples( const QVector<double> & );
     void setSamples( QwtSeriesData<QPointF> *series );
@@ -116,8 +143,14 @@ protected:
 private:
     void init();
 
+    void drawBatchedBars( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotBarChart::PaintAttributes )
+
 #endif
@@ -11,6 +11,7 @@
 #include "qwt_painter.h"
 #include "qwt_math.h"
 #include "qwt_plot.h"
+#include "qwt_scale_map.h"
 
 #ifndef QWT_NO_OPENGL
 
@@ -59,7 +60,8 @@ public:
 #ifndef QWT_NO_OPENGL
         surfaceGL( NULL ),
 #endif
-        backingStore( NULL )
+        backingStore( NULL ),
+        hasScrollMaps( false )
     {
     }
 
@@ -79,6 +81,10 @@ public:
 #endif
 
     QPixmap *backingStore;
+
+    // the scales of the content of the backing store
+    bool hasScrollMaps;
+    QwtScaleMap scrollMaps[QwtPlot::axisCnt];
 };
 
 /*! 
@@ -185,6 +191,8 @@ void QwtPlotCanvas::invalidateBackingStore()
 {
     if ( d_data->backingStore )
         *d_data->backingStore = QPixmap();
+
+    d_data->hasScrollMaps = false;
 }
 
 /*!
@@ -265,6 +273,15 @@ void QwtPlotCanvas::paintEvent( QPaintEvent *event )
                 if ( frameWidth() > 0 )
                     drawBorder( &p );
             }
+
+            const QwtPlot *plot = this->plot();
+            if ( plot && testPaintAttribute( ScrollingBackingStore ) )
+            {
+                for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+                    d_data->scrollMaps[axis] = plot->canvasMap( axis );
+
+                d_data->hasScrollMaps = true;
+            }
         }
 
         painter.drawPixmap( 0, 0, *d_data->backingStore );
@@ -359,11 +376,16 @@ void QwtPlotCanvas::resizeEvent( QResizeEvent *event )
 
 /*!
    Invalidate the paint cache and repaint the canvas
+
+   When ScrollingBackingStore is enabled and the x axes have
+   been translated only, the backing store is scrolled instead.
+
    \sa invalidatePaintCache()
 */
 void QwtPlotCanvas::replot()
 {
-    invalidateBackingStore();
+    if ( !scrollBackingStore() )
+        invalidateBackingStore();
 
     if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
         repaint( contentsRect() );
@@ -371,6 +393,126 @@ void QwtPlotCanvas::replot()
         update( contentsRect() );
 }
 
+bool QwtPlotCanvas::scrollBackingStore()
+{
+    if ( !testPaintAttribute( ScrollingBackingStore ) ||
+        d_data->backingStore == NULL || !d_data->hasScrollMaps )
+    {
+        return false;
+    }
+
+    const QwtPlot *plot = this->plot();
+
+    QPixmap &bs = *d_data->backingStore;
+
+#if QT_VERSION >= 0x050000
+    const qreal ratio = bs.devicePixelRatio();
+#else
+    const qreal ratio = 1.0;
+#endif
+
+    if ( plot == NULL || bs.isNull() || bs.size() / ratio != size() )
+        return false;
+
+#ifndef QWT_NO_OPENGL
+    if ( testPaintAttribute( OpenGLBuffer ) )
+        return false;
+#endif
+
+    if ( testAttribute( Qt::WA_StyledBackground ) || borderRadius() > 0.0 )
+        return false;
+
+    const QRect cr = contentsRect();
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+
+    int dx = 0;
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        const QwtScaleMap &scrollMap = d_data->scrollMaps[axis];
+
+        maps[axis] = plot->canvasMap( axis );
+
+        if ( maps[axis].p1() != scrollMap.p1() ||
+            maps[axis].p2() != scrollMap.p2() )
+        {
+            return false;
+        }
+
+        if ( maps[axis].s1() == scrollMap.s1() &&
+            maps[axis].s2() == scrollMap.s2() )
+        {
+            continue;
+        }
+
+        if ( axis != QwtPlot::xBottom && axis != QwtPlot::xTop )
+            return false;
+
+        // a translation has the same pixel offset for both boundaries
+
+        const double d1 = scrollMap.transform( maps[axis].s1() ) - scrollMap.p1();
+        const double d2 = scrollMap.transform( maps[axis].s2() ) - scrollMap.p2();
+
+        if ( qAbs( d1 - d2 ) > 1e-6 )
+            return false;
+
+        const int d = qRound( d1 );
+        if ( d == 0 || ( dx != 0 && d != dx ) )
+            return false;
+
+        dx = d;
+    }
+
+    if ( dx == 0 || qAbs( dx ) >= cr.width() )
+    {
+        // nothing or everything to scroll
+        return false;
+    }
+
+    // The content is rendered for scales being shifted by
+    // whole pixels to keep the backing store consistent
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        QwtScaleMap &scrollMap = d_data->scrollMaps[axis];
+        if ( maps[axis].s1() != scrollMap.s1() ||
+            maps[axis].s2() != scrollMap.s2() )
+        {
+            scrollMap.setScaleInterval(
+                scrollMap.invTransform( scrollMap.p1() + dx ),
+                scrollMap.invTransform( scrollMap.p2() + dx ) );
+        }
+
+        maps[axis] = scrollMap;
+    }
+
+    // QPixmap::scroll() works in device pixels
+
+    const QRect scrollRect( qRound( cr.x() * ratio ),
+        qRound( cr.y() * ratio ), qRound( cr.width() * ratio ),
+        qRound( cr.height() * ratio ) );
+
+    bs.scroll( qRound( -dx * ratio ), 0, scrollRect );
+
+    QRect stripRect( cr.right() + 1 - dx, cr.top(), dx, cr.height() );
+    if ( dx < 0 )
+        stripRect = QRect( cr.left(), cr.top(), -dx, cr.height() );
+
+    QPixmap strip = QwtPainter::backingStore( this, stripRect.size() );
+    QwtPainter::fillPixmap( this, strip, stripRect.topLeft() );
+
+    QPainter painter( &strip );
+    painter.translate( -stripRect.topLeft() );
+
+    plot->drawItems( &painter, cr, maps );
+    painter.end();
+
+    painter.begin( &bs );
+    painter.drawPixmap( stripRect.topLeft(), strip );
+
+    return true;
+}
+
 /*!
    Calculate the painter path for a styled or rounded border
 
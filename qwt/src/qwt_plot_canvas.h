@@ -119,7 +119,35 @@ public:
 
           \sa QwtPlotOpenGLCanvas, QwtPlotGLCanvas
          */
-        OpenGLBuffer = 16
+        OpenGLBuffer = 16,
+
+        /*!
+          \brief Scroll the backing store, when only the x axes
+                 have been translated
+
+          Real-time plots often advance a time axis with each replot,
+          while the new samples appear in a small strip only. When
+          ScrollingBackingStore is enabled replot() compares the
+          scales with those of the backing store. When the scales of
+          the x axes have been shifted only, the content of the backing
+          store is scrolled by the pixel delta and only the exposed
+          strip is rendered by QwtPlot::drawItems().
+
+          As the backing store is scrolled by whole pixels the content
+          is rendered for scales, that differ by less than half a
+          pixel from the current ones. Any other change - like a
+          changed y axis or a resized canvas - results in a complete
+          replot.
+
+          ScrollingBackingStore can be used for plots, where the
+          items are aligned to the scales only and where the samples
+          inside of the scrolled area do not change. It has no effect
+          without BackingStore or for canvases with styled backgrounds
+          or rounded borders.
+
+          \sa replot(), QwtPlot::drawItems()
+         */
+        ScrollingBackingStore = 32
     };
 
     //! Paint attributes
@@ -149,6 +177,7 @@ protected:
 
 private:
     QImage toImageFBO( const QSize &size );
+    bool scrollBackingStore();
 
     class PrivateData;
     PrivateData *d_data;
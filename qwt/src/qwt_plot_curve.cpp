@@ -21,6 +21,8 @@
 #include <qpixmap.h>
 #include <qalgorithms.h>
 #include <qmath.h>
+#include <qnumeric.h>
+#include <algorithm>
 
 static inline QRectF qwtIntersectedClipRect( const QRectF &rect, QPainter *painter )
 {
@@ -38,6 +40,78 @@ static inline QRectF qwtIntersectedClipRect( const QRectF &rect, QPainter *paint
     return clipRect;
 }
 
+static void qwtBaselinePoints( const QwtPlotCurve *curve, QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QPointF &first, const QPointF &last, QPointF points[2] )
+{
+    const bool doAlign = QwtPainter::roundingAlignment( painter );
+
+    double baseline = curve->baseline();
+
+    if ( curve->orientation() == Qt::Vertical )
+    {
+        if ( yMap.transformation() )
+            baseline = yMap.transformation()->bounded( baseline );
+
+        double refY = yMap.transform( baseline );
+        if ( doAlign )
+            refY = qRound( refY );
+
+        points[0] = QPointF( last.x(), refY );
+        points[1] = QPointF( first.x(), refY );
+    }
+    else
+    {
+        if ( xMap.transformation() )
+            baseline = xMap.transformation()->bounded( baseline );
+
+        double refX = xMap.transform( baseline );
+        if ( doAlign )
+            refX = qRound( refX );
+
+        points[0] = QPointF( refX, last.y() );
+        points[1] = QPointF( refX, first.y() );
+    }
+}
+
+static void qwtFillPolygon( QPainter *painter,
+    const QBrush &brush, const QPolygonF &polygon )
+{
+    painter->save();
+
+    painter->setPen( Qt::NoPen );
+    painter->setBrush( brush );
+
+    QwtPainter::drawPolygon( painter, polygon );
+
+    painter->restore();
+}
+
+static void qwtVisibleRange( const QwtSeriesData<QPointF> &series,
+    const QwtScaleMap &xMap, const QRectF &canvasRect, int &from, int &to )
+{
+    // binary search for the samples inside of the canvas,
+    // including one sample on each side
+
+    double x1 = xMap.invTransform( canvasRect.left() );
+    double x2 = xMap.invTransform( canvasRect.right() );
+    if ( x1 > x2 )
+        qSwap( x1, x2 );
+
+    const int numSamples = static_cast<int>( series.size() );
+
+    int index1 = qwtUpperSampleIndex<QPointF>( series, x1, QwtLessThanX() );
+    if ( index1 < 0 )
+        index1 = numSamples - 1;
+
+    int index2 = qwtUpperSampleIndex<QPointF>( series, x2, QwtLessThanX() );
+    if ( index2 < 0 )
+        index2 = numSamples - 1;
+
+    from = qMax( from, index1 - 1 );
+    to = qMin( to, index2 );
+}
+
 static void qwtUpdateLegendIconSize( QwtPlotCurve *curve )
 {
     if ( curve->symbol() && 
@@ -75,6 +149,324 @@ static int qwtVerifyRange( int size, int &i1, int &i2 )
     return ( i2 - i1 + 1 );
 }
 
+class QwtCurveIndex
+{
+public:
+    /*
+      A lazily built index for closestPoint(). Series with
+      increasing x coordinates are searched by bisection.
+      For all other series the samples are copied into an implicit
+      k-d tree, where each range is split at its median point.
+
+      The distances are measured in paint device coordinates.
+      As all scale transformations are monotonic, the bounding
+      rectangle of a range can be mapped by its corners, what
+      allows to skip ranges, that can't contain a closer point.
+     */
+
+    QwtCurveIndex():
+        d_series( NULL ),
+        d_size( 0 ),
+        d_isSorted( false ),
+        d_x1( 0.0 ),
+        d_x2( 0.0 ),
+        d_y1( 0.0 ),
+        d_y2( 0.0 )
+    {
+    }
+
+    void invalidate()
+    {
+        d_series = NULL;
+        d_size = 0;
+        d_isSorted = false;
+        d_points.clear();
+    }
+
+    bool isValid( const QwtSeriesData<QPointF> *series ) const
+    {
+        return ( d_series == series ) && ( d_size == series->size() );
+    }
+
+    void build( const QwtSeriesData<QPointF> *series )
+    {
+        invalidate();
+
+        d_series = series;
+        d_size = series->size();
+
+        const int numSamples = static_cast<int>( d_size );
+
+        d_isSorted = true;
+
+        double xPrev = 0.0;
+        for ( int i = 0; i < numSamples; i++ )
+        {
+            const double x = series->sample( i ).x();
+            if ( qIsNaN( x ) || ( i > 0 && x < xPrev ) )
+            {
+                d_isSorted = false;
+                break;
+            }
+
+            xPrev = x;
+        }
+
+        if ( d_isSorted )
+            return;
+
+        d_points.reserve( numSamples );
+
+        for ( int i = 0; i < numSamples; i++ )
+        {
+            const QPointF sample = series->sample( i );
+            if ( qIsNaN( sample.x() ) || qIsNaN( sample.y() ) )
+                continue;
+
+            if ( d_points.isEmpty() )
+            {
+                d_x1 = d_x2 = sample.x();
+                d_y1 = d_y2 = sample.y();
+            }
+            else
+            {
+                d_x1 = qMin( d_x1, sample.x() );
+                d_x2 = qMax( d_x2, sample.x() );
+                d_y1 = qMin( d_y1, sample.y() );
+                d_y2 = qMax( d_y2, sample.y() );
+            }
+
+            const Point point = { sample.x(), sample.y(), i };
+            d_points += point;
+        }
+
+        split( d_points.data(), d_points.data() + d_points.size(), 0 );
+    }
+
+    int closestPoint( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QPointF &pos, double &dmin ) const
+    {
+        Query query( xMap, yMap, pos, dmin );
+
+        if ( d_isSorted )
+        {
+            searchSorted( query );
+        }
+        else if ( !d_points.isEmpty() )
+        {
+            searchTree( query, 0, d_points.size(), 0,
+                d_x1, d_x2, d_y1, d_y2 );
+        }
+
+        dmin = query.dmin;
+        return query.index;
+    }
+
+private:
+    enum { LeafSize = 8 };
+
+    struct Point
+    {
+        double x;
+        double y;
+        int index;
+    };
+
+    class LessThan
+    {
+    public:
+        explicit LessThan( int axis ):
+            d_axis( axis )
+        {
+        }
+
+        inline bool operator()( const Point &p1, const Point &p2 ) const
+        {
+            return ( d_axis == 0 ) ? ( p1.x < p2.x ) : ( p1.y < p2.y );
+        }
+
+    private:
+        const int d_axis;
+    };
+
+    class Query
+    {
+    public:
+        Query( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                const QPointF &pos, double dmin ):
+            xMap( xMap ),
+            yMap( yMap ),
+            pos( pos ),
+            x( xMap.invTransform( pos.x() ) ),
+            y( yMap.invTransform( pos.y() ) ),
+            index( -1 ),
+            dmin( dmin )
+        {
+        }
+
+        inline void check( double sx, double sy, int sampleIndex )
+        {
+            const double dx = xMap.transform( sx ) - pos.x();
+            const double dy = yMap.transform( sy ) - pos.y();
+
+            const double f = qwtSqr( dx ) + qwtSqr( dy );
+            if ( f < dmin )
+            {
+                index = sampleIndex;
+                dmin = f;
+            }
+        }
+
+        inline double distance( double x1, double x2,
+            double y1, double y2 ) const
+        {
+            // lower bound for the points inside of a rectangle
+            const double dx = axisDistance( xMap.transform( x1 ),
+                xMap.transform( x2 ), pos.x() );
+            const double dy = axisDistance( yMap.transform( y1 ),
+                yMap.transform( y2 ), pos.y() );
+
+            return qwtSqr( dx ) + qwtSqr( dy );
+        }
+
+        const QwtScaleMap &xMap;
+        const QwtScaleMap &yMap;
+        const QPointF pos;
+
+        // pos in scale coordinates
+        const double x;
+        const double y;
+
+        int index;
+        double dmin;
+
+    private:
+        static inline double axisDistance( double v1, double v2, double v )
+        {
+            if ( v1 > v2 )
+                qSwap( v1, v2 );
+
+            // NaN values ( f.e. log of negative values ) result in 0.0
+            if ( v < v1 )
+                return v1 - v;
+
+            if ( v > v2 )
+                return v - v2;
+
+            return 0.0;
+        }
+    };
+
+    void split( Point *begin, Point *end, int depth )
+    {
+        if ( end - begin <= LeafSize )
+            return;
+
+        Point *mid = begin + ( end - begin ) / 2;
+        std::nth_element( begin, mid, end, LessThan( depth % 2 ) );
+
+        split( begin, mid, depth + 1 );
+        split( mid + 1, end, depth + 1 );
+    }
+
+    void searchSorted( Query &query ) const
+    {
+        const int numSamples = static_cast<int>( d_size );
+
+        int index = qwtUpperSampleIndex<QPointF>(
+            *d_series, query.x, QwtLessThanX() );
+        if ( index < 0 )
+            index = numSamples - 1;
+
+        // walking in both directions, until the horizontal
+        // distance alone exceeds the closest distance
+
+        for ( int i = index; i < numSamples; i++ )
+        {
+            const QPointF sample = d_series->sample( i );
+
+            const double dx = query.xMap.transform( sample.x() ) - query.pos.x();
+            if ( !( qwtSqr( dx ) < query.dmin ) )
+                break;
+
+            query.check( sample.x(), sample.y(), i );
+        }
+
+        for ( int i = index - 1; i >= 0; i-- )
+        {
+            const QPointF sample = d_series->sample( i );
+
+            const double dx = query.xMap.transform( sample.x() ) - query.pos.x();
+            if ( !( qwtSqr( dx ) < query.dmin ) )
+                break;
+
+            query.check( sample.x(), sample.y(), i );
+        }
+    }
+
+    void searchTree( Query &query, int begin, int end, int depth,
+        double x1, double x2, double y1, double y2 ) const
+    {
+        if ( !( query.distance( x1, x2, y1, y2 ) < query.dmin ) )
+            return;
+
+        const Point *points = d_points.constData();
+
+        if ( end - begin <= LeafSize )
+        {
+            for ( int i = begin; i < end; i++ )
+                query.check( points[i].x, points[i].y, points[i].index );
+
+            return;
+        }
+
+        const int mid = begin + ( end - begin ) / 2;
+        const Point &p = points[mid];
+
+        query.check( p.x, p.y, p.index );
+
+        if ( depth % 2 == 0 )
+        {
+            if ( query.x < p.x )
+            {
+                searchTree( query, begin, mid, depth + 1, x1, p.x, y1, y2 );
+                searchTree( query, mid + 1, end, depth + 1, p.x, x2, y1, y2 );
+            }
+            else
+            {
+                searchTree( query, mid + 1, end, depth + 1, p.x, x2, y1, y2 );
+                searchTree( query, begin, mid, depth + 1, x1, p.x, y1, y2 );
+            }
+        }
+        else
+        {
+            if ( query.y < p.y )
+            {
+                searchTree( query, begin, mid, depth + 1, x1, x2, y1, p.y );
+                searchTree( query, mid + 1, end, depth + 1, x1, x2, p.y, y2 );
+            }
+            else
+            {
+                searchTree( query, mid + 1, end, depth + 1, x1, x2, p.y, y2 );
+                searchTree( query, begin, mid, depth + 1, x1, x2, y1, p.y );
+            }
+        }
+    }
+
+    const QwtSeriesData<QPointF> *d_series;
+    size_t d_size;
+
+    bool d_isSorted;
+
+    // bounding rectangle of the k-d tree
+    double d_x1;
+    double d_x2;
+    double d_y1;
+    double d_y2;
+
+    QVector<Point> d_points;
+};
+
 class QwtPlotCurve::PrivateData
 {
 public:
@@ -86,7 +478,8 @@ public:
         attributes( 0 ),
         paintAttributes( 
             QwtPlotCurve::ClipPolygons | QwtPlotCurve::FilterPoints ),
-        legendAttributes( 0 )
+        legendAttributes( 0 ),
+        index( NULL )
     {
         curveFitter = new QwtSplineCurveFitter;
     }
@@ -95,6 +488,7 @@ public:
     {
         delete symbol;
         delete curveFitter;
+        delete index;
     }
 
     QwtPlotCurve::CurveStyle style;
@@ -110,6 +504,8 @@ public:
     QwtPlotCurve::PaintAttributes paintAttributes;
 
     QwtPlotCurve::LegendAttributes legendAttributes;
+
+    QwtCurveIndex *index;
 };
 
 /*!
@@ -359,7 +755,11 @@ const QBrush& QwtPlotCurve::brush() const
   \param to Index of the last point to be painted. If to < 0 the
          curve will be painted to its last point.
 
-  \sa drawCurve(), drawSymbols(),
+  When ClipSortedSamples is enabled the interval is reduced to
+  the samples inside of the canvas and one more sample on each side.
+  Fitted curves are always drawn from the complete interval.
+
+  \sa drawCurve(), drawSymbols(), ClipSortedSamples
 */
 void QwtPlotCurve::drawSeries( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -375,6 +775,16 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
 
     if ( qwtVerifyRange( numSamples, from, to ) > 0 )
     {
+        if ( testPaintAttribute( QwtPlotCurve::ClipSortedSamples )
+            && !testCurveAttribute( QwtPlotCurve::Fitted ) )
+        {
+            // fitted curves depend on all samples
+
+            qwtVisibleRange( *data(), xMap, canvasRect, from, to );
+            if ( from > to )
+                return;
+        }
+
         painter->save();
         painter->setPen( d_data->pen );
 
@@ -526,8 +936,29 @@ void QwtPlotCurve::drawLines( QPainter *painter,
     }
     else
     {
+        const bool doSplit = !doFill && !doFit
+            && testPaintAttribute( ClipPolygons )
+            && testPaintAttribute( SplitPolylines );
+
+        if ( !doFill && !doSplit && testPaintAttribute( ClipPolygons ) )
+        {
+            // mapping and clipping in one loop
+            mapper.setClipRect( clipRect );
+        }
+
         QPolygonF polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
 
+        if ( doSplit )
+        {
+            QVector<int> runSizes;
+            QwtClipper::splitPolylineF( clipRect, polyline, polyline, runSizes );
+
+            QwtPainter::drawPolylines( painter, polyline.constData(),
+                runSizes.constData(), runSizes.size() );
+
+            return;
+        }
+
         if ( doFill )
         {
             if ( doFit )
@@ -539,11 +970,48 @@ void QwtPlotCurve::drawLines( QPainter *painter,
                 polyline = d_data->curveFitter->fitCurve( polyline );
             }
 
-            if ( painter->pen().style() != Qt::NoPen )
+            if ( painter->pen().style() != Qt::NoPen
+                && testPaintAttribute( FillAndStrokeInOnePass ) )
             {
-                // here we are wasting memory for the filled copy,
-                // do polygon clipping twice etc .. TODO
+                /*
+                   The filled polygon and the outline share one buffer:
+                   the closed polygon starts with the points of the
+                   outline followed by the points on the baseline.
+                 */
+                int outlineSize = polyline.size();
+
+                if ( polyline.size() >= 2 )
+                {
+                    QPointF baselinePoints[2];
+                    qwtBaselinePoints( this, painter, xMap, yMap,
+                        polyline.first(), polyline.last(), baselinePoints );
+
+                    if ( d_data->paintAttributes & ClipPolygons )
+                    {
+                        outlineSize = QwtClipper::clipFilledPolygonF( clipRect,
+                            polyline, baselinePoints, 2, polyline );
+                    }
+                    else
+                    {
+                        polyline += baselinePoints[0];
+                        polyline += baselinePoints[1];
+                    }
+
+                    if ( polyline.size() > 2 )
+                    {
+                        QBrush brush = d_data->brush;
+                        if ( !brush.color().isValid() )
+                            brush.setColor( d_data->pen.color() );
+
+                        qwtFillPolygon( painter, brush, polyline );
+                    }
+                }
 
+                QwtPainter::drawPolyline( painter,
+                    polyline.constData(), outlineSize );
+            }
+            else if ( painter->pen().style() != Qt::NoPen )
+            {
                 QPolygonF filled = polyline;
                 fillCurve( painter, xMap, yMap, canvasRect, filled );
                 filled.clear();
@@ -560,12 +1028,6 @@ void QwtPlotCurve::drawLines( QPainter *painter,
         }
         else
         {
-            if ( testPaintAttribute( ClipPolygons ) )
-            {
-                polyline = QwtClipper::clipPolygonF( 
-                    clipRect, polyline, false );
-            }
-
             if ( doFit )
             {
                 if ( d_data->curveFitter->mode() == QwtCurveFitter::Path )
@@ -901,6 +1363,9 @@ QwtCurveFitter *QwtPlotCurve::curveFitter() const
   \param canvasRect Contents rectangle of the canvas
   \param polygon Polygon - will be modified !
 
+  \note When FillAndStrokeInOnePass is enabled, drawLines() fills
+        the area of a Lines curve with a pen without calling fillCurve().
+
   \sa setBrush(), setBaseline(), setStyle()
 */
 void QwtPlotCurve::fillCurve( QPainter *painter,
@@ -924,14 +1389,7 @@ void QwtPlotCurve::fillCurve( QPainter *painter,
         polygon = QwtClipper::clipPolygonF( clipRect, polygon, true );
     }
 
-    painter->save();
-
-    painter->setPen( Qt::NoPen );
-    painter->setBrush( brush );
-
-    QwtPainter::drawPolygon( painter, polygon );
-
-    painter->restore();
+    qwtFillPolygon( painter, brush, polygon );
 }
 
 /*!
@@ -950,34 +1408,12 @@ void QwtPlotCurve::closePolyline( QPainter *painter,
     if ( polygon.size() < 2 )
         return;
 
-    const bool doAlign = QwtPainter::roundingAlignment( painter );
-
-    double baseline = d_data->baseline;
-    
-    if ( orientation() == Qt::Vertical )
-    {
-        if ( yMap.transformation() )
-            baseline = yMap.transformation()->bounded( baseline );
+    QPointF points[2];
+    qwtBaselinePoints( this, painter, xMap, yMap,
+        polygon.first(), polygon.last(), points );
 
-        double refY = yMap.transform( baseline );
-        if ( doAlign )
-            refY = qRound( refY );
-
-        polygon += QPointF( polygon.last().x(), refY );
-        polygon += QPointF( polygon.first().x(), refY );
-    }
-    else
-    {
-        if ( xMap.transformation() )
-            baseline = xMap.transformation()->bounded( baseline );
-
-        double refX = xMap.transform( baseline );
-        if ( doAlign )
-            refX = qRound( refX );
-
-        polygon += QPointF( refX, polygon.last().y() );
-        polygon += QPointF( refX, polygon.first().y() );
-    }
+    polygon += points[0];
+    polygon += points[1];
 }
 
 /*!
@@ -1062,7 +1498,8 @@ double QwtPlotCurve::baseline() const
               the position and the closest curve point
   \return Index of the closest curve point, or -1 if none can be found
           ( f.e when the curve has no points )
-  \note closestPoint() implements a dumb algorithm, that iterates
+  \note Without an index ( see setClosestPointIndexEnabled() )
+        closestPoint() implements a dumb algorithm, that iterates
         over all points
 */
 int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
@@ -1080,6 +1517,19 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
     int index = -1;
     double dmin = 1.0e10;
 
+    if ( d_data->index )
+    {
+        if ( !d_data->index->isValid( series ) )
+            d_data->index->build( series );
+
+        index = d_data->index->closestPoint( xMap, yMap, pos, dmin );
+
+        if ( dist )
+            *dist = qSqrt( dmin );
+
+        return index;
+    }
+
     for ( uint i = 0; i < numSamples; i++ )
     {
         const QPointF sample = series->sample( i );
@@ -1100,6 +1550,67 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
     return index;
 }
 
+/*!
+  \brief Enable an index for closestPoint()
+
+  When enabled, closestPoint() builds an index for the samples,
+  when it is called for the first time after the data has been changed:
+
+  - For samples with increasing x coordinates the closest point is
+    found by bisection, without any extra memory.
+  - Otherwise the samples are copied into a k-d tree.
+
+  Then the closest point is found in logarithmic time ( for a reasonable
+  distribution of the samples ) instead of mapping all samples for
+  each call. This makes a difference for trackers on curves with
+  many points, that call closestPoint() for each mouse move.
+
+  \param on On/Off
+  \note The index is invalidated by dataChanged(), what happens when
+        setting new samples. When the samples are modified
+        in a way, that doesn't change the size of the series,
+        dataChanged() needs to be called explicitly.
+
+  \sa isClosestPointIndexEnabled(), closestPoint()
+*/
+void QwtPlotCurve::setClosestPointIndexEnabled( bool on )
+{
+    if ( on == ( d_data->index != NULL ) )
+        return;
+
+    if ( on )
+    {
+        d_data->index = new QwtCurveIndex();
+    }
+    else
+    {
+        delete d_data->index;
+        d_data->index = NULL;
+    }
+}
+
+/*!
+  \return True, when closestPoint() uses an index
+  \sa setClosestPointIndexEnabled()
+*/
+bool QwtPlotCurve::isClosestPointIndexEnabled() const
+{
+    return d_data->index != NULL;
+}
+
+/*!
+  \brief Invalidate the index for closestPoint() and update the plot
+
+  \sa setClosestPointIndexEnabled(), QwtPlotSeriesItem::dataChanged()
+*/
+void QwtPlotCurve::dataChanged()
+{
+    if ( d_data->index )
+        d_data->index->invalidate();
+
+    QwtPlotSeriesItem::dataChanged();
+}
+
 /*!
    \return Icon representing the curve on the legend
 
@@ -203,6 +203,9 @@ public:
           having a huge amount of points. 
           With a reasonable number of points QPainter::drawPoints()
           will be faster.
+
+          The image is rendered in parallel by renderThreadCount() threads.
+          \sa QwtPointMapper::toImage()
          */
         ImageBuffer = 0x08,
 
@@ -229,6 +232,48 @@ public:
                 worked around by enabling the QwtPainter::polylineSplitting() mode.
          */
         FilterPointsAggressive = 0x10,
+
+        /*!
+          The samples are sorted in increasing order of their x coordinates.
+
+          drawSeries() finds the samples inside of the canvas by binary search
+          ( qwtUpperSampleIndex() ) and maps only those and the one sample
+          on each side, that is needed for the lines leaving the canvas.
+          When zooming into a small part of a huge series the cost is
+          O( log( N ) ) + the number of visible samples instead of O( N ).
+
+          \note Curves, that are Fitted, are always drawn from all samples.
+          \warning The result is undefined for unsorted samples
+         */
+        ClipSortedSamples = 0x20,
+
+        /*!
+          Together with ClipPolygons: the lines of a curve, that is
+          not filled, are split into the runs inside of the clip rectangle
+          instead of connecting them by points on its border.
+          The runs are painted in one call by QwtPainter::drawPolylines().
+
+          When zooming deep into an oscillating signal, the curve leaves
+          and reenters the canvas over and over again. Then the
+          segments along the border, that are outside of the visible area,
+          don't need to be rasterized.
+
+          \note Implemented for QwtPlotCurve::Lines only. Curves, that
+                are Fitted, are clipped as before.
+          \sa QwtClipper::splitPolylineF()
+         */
+        SplitPolylines = 0x40,
+
+        /*!
+          A filled curve of the Lines style with a pen is clipped only once:
+          the closed polygon and the outline share one buffer, the area
+          is filled and the outline is drawn from the same points.
+
+          \note fillCurve() and closePolyline() are not called in this
+                mode. Derived classes, that reimplement them, should
+                leave this attribute disabled.
+         */
+        FillAndStrokeInOnePass = 0x80
     };
 
     //! Paint attributes
@@ -257,6 +302,9 @@ public:
 
     virtual int closestPoint( const QPoint &pos, double *dist = NULL ) const;
 
+    void setClosestPointIndexEnabled( bool on );
+    bool isClosestPointIndexEnabled() const;
+
     double minXValue() const;
     double maxXValue() const;
     double minYValue() const;
@@ -325,6 +373,8 @@ protected:
     void closePolyline( QPainter *,
         const QwtScaleMap &, const QwtScaleMap &, QPolygonF & ) const;
 
+    virtual void dataChanged();
+
 private:
     class PrivateData;
     PrivateData *d_data;
@@ -14,6 +14,7 @@
 #include "qwt_scale_map.h"
 #include <qstring.h>
 #include <qpainter.h>
+#include <qmath.h>
 
 static inline bool qwtIsCombinable( const QwtInterval &d1,
     const QwtInterval &d2 )
@@ -33,6 +34,90 @@ static inline bool qwtIsCombinable( const QwtInterval &d1,
     return false;
 }
 
+/*
+  A column in paint device coordinates, where p1/p2 are the
+  coordinates along the intervals and vMin/vMax the range of
+  the values. vMin and vMax differ only for merged columns.
+ */
+class QwtHistogramBin
+{
+public:
+    double p1;
+    double p2;
+    double vMin;
+    double vMax;
+    QwtInterval::BorderFlags borderFlags;
+    bool merged;
+};
+
+static void qwtCollectBins( const QwtSeriesData<QwtIntervalSample> *series,
+    int from, int to, const QwtScaleMap &posMap, const QwtScaleMap &valueMap,
+    const QwtInterval &clipInterval, QVector<QwtHistogramBin> &bins )
+{
+    QwtHistogramBin bin;
+    bool hasBin = false;
+
+    for ( int i = from; i <= to; i++ )
+    {
+        const QwtIntervalSample sample = series->sample( i );
+
+        const QwtInterval &iv = sample.interval;
+        if ( !iv.isValid() || iv.isNull() )
+            continue;
+
+        double p1 = posMap.transform( iv.minValue() );
+        double p2 = posMap.transform( iv.maxValue() );
+        if ( p1 > p2 )
+            qSwap( p1, p2 );
+
+        if ( p2 < clipInterval.minValue() || p1 > clipInterval.maxValue() )
+            continue;
+
+        const double v = valueMap.transform( sample.value );
+
+        if ( p2 - p1 < 1.0 )
+        {
+            // columns below a pixel are reduced to the range of their values
+
+            const double pixel = qFloor( 0.5 * ( p1 + p2 ) );
+
+            if ( hasBin && bin.merged && bin.p1 == pixel )
+            {
+                bin.vMin = qMin( bin.vMin, v );
+                bin.vMax = qMax( bin.vMax, v );
+                continue;
+            }
+
+            if ( hasBin && !bin.merged && bin.p2 - bin.p1 < 1.0
+                && qFloor( 0.5 * ( bin.p1 + bin.p2 ) ) == pixel )
+            {
+                bin.p1 = pixel;
+                bin.p2 = pixel + 1.0;
+                bin.vMin = qMin( bin.vMin, v );
+                bin.vMax = qMax( bin.vMax, v );
+                bin.borderFlags = QwtInterval::IncludeBorders;
+                bin.merged = true;
+
+                continue;
+            }
+        }
+
+        if ( hasBin )
+            bins += bin;
+
+        bin.p1 = p1;
+        bin.p2 = p2;
+        bin.vMin = bin.vMax = v;
+        bin.borderFlags = iv.borderFlags();
+        bin.merged = false;
+
+        hasBin = true;
+    }
+
+    if ( hasBin )
+        bins += bin;
+}
+
 class QwtPlotHistogram::PrivateData
 {
 public:
@@ -54,6 +139,8 @@ public:
     QBrush brush;
     QwtPlotHistogram::HistogramStyle style;
     const QwtColumnSymbol *symbol;
+
+    QwtPlotHistogram::PaintAttributes paintAttributes;
 };
 
 /*!
@@ -94,6 +181,32 @@ void QwtPlotHistogram::init()
     setZ( 20.0 );
 }
 
+/*!
+  Specify an attribute how to draw the histogram
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotHistogram::setPaintAttribute(
+    PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa setPaintAttribute()
+*/
+bool QwtPlotHistogram::testPaintAttribute(
+    PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Set the histogram's drawing style
 
@@ -332,7 +445,7 @@ void QwtPlotHistogram::setSamples(
 */
 void QwtPlotHistogram::drawSeries( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QRectF &, int from, int to ) const
+    const QRectF &canvasRect, int from, int to ) const
 {
     if ( !painter || dataSize() <= 0 )
         return;
@@ -340,6 +453,15 @@ void QwtPlotHistogram::drawSeries( QPainter *painter,
     if ( to < 0 )
         to = dataSize() - 1;
 
+    if ( d_data->paintAttributes & BatchedColumns )
+    {
+        if ( d_data->style == Columns || d_data->style == Lines )
+        {
+            drawBatchedColumns( painter, xMap, yMap, canvasRect, from, to );
+            return;
+        }
+    }
+
     switch ( d_data->style )
     {
         case Outline:
@@ -545,6 +667,185 @@ void QwtPlotHistogram::drawLines( QPainter *painter,
     }
 }
 
+/*!
+  Draw a histogram in Columns or Lines style(), when
+  BatchedColumns is enabled
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+  \param from Index of the first sample to be painted
+  \param to Index of the last sample to be painted
+
+  \sa BatchedColumns, drawColumns(), drawLines()
+*/
+void QwtPlotHistogram::drawBatchedColumns( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    const bool isVertical = ( orientation() == Qt::Vertical );
+
+    const QwtScaleMap &posMap = isVertical ? xMap : yMap;
+    const QwtScaleMap &valueMap = isVertical ? yMap : xMap;
+
+    const QwtColumnSymbol *symbol = d_data->symbol;
+    if ( symbol && symbol->style() == QwtColumnSymbol::NoStyle )
+        symbol = NULL;
+
+    if ( d_data->style == Lines )
+        symbol = NULL;
+
+    /*
+      Columns are cut at a distance to the canvas, where
+      the border lines are not visible anymore.
+     */
+    double margin = qMax( d_data->pen.widthF(), qreal( 1.0 ) ) + 1.0;
+    if ( symbol )
+        margin += symbol->lineWidth();
+
+    const QRectF clipRect =
+        canvasRect.adjusted( -margin, -margin, margin, margin );
+
+    QwtInterval posClip( clipRect.left(), clipRect.right() );
+    QwtInterval valueClip( clipRect.top(), clipRect.bottom() );
+    if ( !isVertical )
+        qSwap( posClip, valueClip );
+
+    QVector<QwtHistogramBin> bins;
+    qwtCollectBins( data(), from, to, posMap, valueMap, posClip, bins );
+
+    if ( bins.isEmpty() )
+        return;
+
+    const bool doAlign = QwtPainter::roundingAlignment( painter );
+
+    if ( d_data->style == Lines )
+    {
+        QVector<QLineF> lines;
+        lines.reserve( bins.size() );
+
+        for ( int i = 0; i < bins.size(); i++ )
+        {
+            const QwtHistogramBin &bin = bins[i];
+
+            double p1 = bin.p1;
+            double p2 = bin.p2;
+            double v1 = qMax( bin.vMin, valueClip.minValue() );
+            double v2 = qMin( bin.vMax, valueClip.maxValue() );
+
+            if ( v1 > v2 )
+                continue;
+
+            if ( bin.merged && v1 < v2 )
+            {
+                // a vertical stroke from the minimum to the maximum
+                p2 = p1;
+            }
+            else
+            {
+                // the same adjustments as in QwtColumnRect::toRect()
+                if ( bin.borderFlags & QwtInterval::ExcludeMinimum )
+                    p1 += 1.0;
+                if ( bin.borderFlags & QwtInterval::ExcludeMaximum )
+                    p2 -= 1.0;
+
+                p1 = qMax( p1, posClip.minValue() );
+                p2 = qMin( p2, posClip.maxValue() );
+            }
+
+            if ( doAlign )
+            {
+                p1 = qRound( p1 );
+                p2 = qRound( p2 );
+                v1 = qRound( v1 );
+                v2 = qRound( v2 );
+            }
+
+            if ( isVertical )
+                lines += QLineF( p1, v1, p2, v2 );
+            else
+                lines += QLineF( v1, p1, v2, p2 );
+        }
+
+        painter->setPen( d_data->pen );
+        painter->setBrush( Qt::NoBrush );
+
+        painter->drawLines( lines.constData(), lines.size() );
+
+        return;
+    }
+
+    const double v0 = valueMap.transform( baseline() );
+
+    QVector<QwtColumnRect> columns;
+    columns.reserve( bins.size() );
+
+    for ( int i = 0; i < bins.size(); i++ )
+    {
+        const QwtHistogramBin &bin = bins[i];
+
+        double v1 = qMin( v0, bin.vMin );
+        double v2 = qMax( v0, bin.vMax );
+
+        if ( v2 < valueClip.minValue() || v1 > valueClip.maxValue() )
+            continue;
+
+        v1 = qMax( v1, valueClip.minValue() );
+        v2 = qMin( v2, valueClip.maxValue() );
+
+        const QwtInterval posInterval(
+            qMax( bin.p1, posClip.minValue() ),
+            qMin( bin.p2, posClip.maxValue() ), bin.borderFlags );
+
+        QwtColumnRect column;
+        if ( isVertical )
+        {
+            column.hInterval = posInterval;
+            column.vInterval = QwtInterval( v1, v2 );
+            column.direction = ( bin.vMin < v0 ) ?
+                QwtColumnRect::BottomToTop : QwtColumnRect::TopToBottom;
+        }
+        else
+        {
+            column.hInterval = QwtInterval( v1, v2 );
+            column.vInterval = posInterval;
+            column.direction = ( bin.vMin < v0 ) ?
+                QwtColumnRect::RightToLeft : QwtColumnRect::LeftToRight;
+        }
+
+        columns += column;
+    }
+
+    if ( symbol )
+    {
+        symbol->drawColumns( painter, columns.constData(), columns.size() );
+        return;
+    }
+
+    QVector<QRectF> rects;
+    rects.reserve( columns.size() );
+
+    for ( int i = 0; i < columns.size(); i++ )
+    {
+        QRectF r = columns[i].toRect();
+        if ( doAlign )
+        {
+            r.setLeft( qRound( r.left() ) );
+            r.setRight( qRound( r.right() ) );
+            r.setTop( qRound( r.top() ) );
+            r.setBottom( qRound( r.bottom() ) );
+        }
+
+        rects += r;
+    }
+
+    painter->setPen( d_data->pen );
+    painter->setBrush( d_data->brush );
+
+    painter->drawRects( rects.constData(), rects.size() );
+}
+
 //! Internal, used by the Outline style.
 void QwtPlotHistogram::flushPolygon( QPainter *painter,
     double baseLine, QPolygonF &polygon ) const
@@ -76,12 +76,43 @@ public:
         UserStyle = 100
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        The default setting disables all attributes
+
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          In Columns and Lines style all samples are mapped in one pass
+          and painted with a single QPainter call for all columns.
+          Columns being narrower than a pixel, that are mapped to
+          the same pixel, are merged into one column covering the
+          range of their values. Columns outside of the canvas
+          are skipped.
+
+          The number of painted columns is limited by the size of the
+          canvas, what makes a difference for histograms with
+          many intervals.
+
+          In this mode columnRect() and drawColumn() are not called.
+         */
+        BatchedColumns = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotHistogram( const QString &title = QString::null );
     explicit QwtPlotHistogram( const QwtText &title );
     virtual ~QwtPlotHistogram();
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setPen( const QColor &, qreal width = 0.0, Qt::PenStyle = Qt::SolidLine );
     void setPen( const QPen & );
     const QPen &pen() const;
@@ -132,8 +163,14 @@ private:
     void init();
     void flushPolygon( QPainter *, double baseLine, QPolygonF & ) const;
 
+    void drawBatchedColumns( QPainter *,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotHistogram::PaintAttributes )
+
 #endif
@@ -25,6 +25,7 @@ public:
         interests( 0 ),
         renderHints( 0 ),
         renderThreadCount( 1 ),
+        cacheLayer( QwtPlotItem::NoCacheLayer ),
         z( 0.0 ),
         xAxis( QwtPlot::xBottom ),
         yAxis( QwtPlot::yLeft ),
@@ -41,6 +42,7 @@ public:
 
     QwtPlotItem::RenderHints renderHints;
     uint renderThreadCount;
+    int cacheLayer;
 
     double z;
 
@@ -331,6 +333,50 @@ uint QwtPlotItem::renderThreadCount() const
     return d_data->renderThreadCount;
 }
 
+/*!
+   \brief Assign the item to a cache layer
+
+   All visible items of a cache layer, that are consecutive in the
+   z order, are rendered into an offscreen pixmap, that is reused
+   for the following replots. The pixmap is invalidated by itemChanged()
+   of one of its items or when the geometry of the canvas or the scales
+   have changed.
+
+   Assigning items, that are not modified between replots - like grids,
+   markers or reference curves - to a cache layer avoids repainting
+   them, when only a few items are changing frequently.
+
+   \param layer Cache layer, or QwtPlotItem::NoCacheLayer, when the
+                item is painted for each replot
+   \note An item, that is modified without calling itemChanged()
+         - f.e. a curve, whose samples are modified in place -
+         needs an explicit QwtPlot::invalidateCacheLayer().
+
+   \sa cacheLayer(), CacheLayer, QwtPlot::drawCanvas()
+*/
+void QwtPlotItem::setCacheLayer( int layer )
+{
+    layer = qMax( layer, static_cast<int>( NoCacheLayer ) );
+
+    if ( layer != d_data->cacheLayer )
+    {
+        if ( d_data->plot && d_data->cacheLayer >= 0 )
+            d_data->plot->invalidateCacheLayer( d_data->cacheLayer );
+
+        d_data->cacheLayer = layer;
+        itemChanged();
+    }
+}
+
+/*!
+   \return Cache layer of the item
+   \sa setCacheLayer()
+*/
+int QwtPlotItem::cacheLayer() const
+{
+    return d_data->cacheLayer;
+}
+
 /*!
    Set the size of the legend icon
 
@@ -442,15 +488,21 @@ bool QwtPlotItem::isVisible() const
 }
 
 /*!
-   Update the legend and call QwtPlot::autoRefresh() for the
-   parent plot.
+   Invalidate the cache layer of the item, update the legend
+   and call QwtPlot::autoRefresh() for the parent plot.
 
    \sa QwtPlot::legendChanged(), QwtPlot::autoRefresh()
 */
 void QwtPlotItem::itemChanged()
 {
     if ( d_data->plot )
+    {
+        if ( d_data->cacheLayer >= 0 )
+            d_data->plot->invalidateCacheLayer( d_data->cacheLayer );
+
+        d_data->plot->increaseItemRevision();
         d_data->plot->autoRefresh();
+    }
 }
 
 /*!
@@ -156,7 +156,17 @@ public:
            its bounding rectangle. 
            \sa getCanvasMarginHint()
          */
-        Margins = 0x04
+        Margins = 0x04,
+
+        /*!
+           draw() can be called from a different thread than the GUI thread.
+           The item is only painting to the painter, without accessing
+           widgets or pixmaps ( f.e. a QwtSymbol with a pixmap cache ),
+           and its data is not modified, while the plot is replotted.
+
+           \sa QwtPlot::setRenderThreadCount()
+         */
+        ThreadSafe = 0x08
     };
 
     //! Plot Item Attributes
@@ -206,6 +216,30 @@ public:
     //! Render hints
     typedef QFlags<RenderHint> RenderHints;
 
+    /*!
+       \brief Predefined cache layers
+
+       Items, that have been assigned to a cache layer, are rendered
+       into an offscreen pixmap by QwtPlot::drawCanvas(). The pixmap is
+       reused until one of its items has changed or the geometry
+       of the canvas or the scales are different.
+
+       Any value >= 0 can be used as cache layer.
+
+       \sa setCacheLayer(), QwtPlot::invalidateCacheLayer()
+     */
+    enum CacheLayer
+    {
+        //! The item is painted for each replot
+        NoCacheLayer = -1,
+
+        //! For items, that rarely change: grids, markers, reference curves
+        StaticLayer = 0,
+
+        //! For items, that change less often than the plot is replotted
+        SlowLayer = 1
+    };
+
     explicit QwtPlotItem( const QwtText &title = QwtText() );
     virtual ~QwtPlotItem();
 
@@ -232,6 +266,9 @@ public:
     void setRenderThreadCount( uint numThreads );
     uint renderThreadCount() const;
 
+    void setCacheLayer( int layer );
+    int cacheLayer() const;
+
     void setLegendIconSize( const QSize & );
     QSize legendIconSize() const;
 
@@ -14,13 +14,14 @@
 #include <qpainter.h>
 #include <qpalette.h>
 #include <qmap.h>
+#include <qvarlengtharray.h>
 
 inline static bool qwtIsIncreasing(
-    const QwtScaleMap &map, const QVector<double> &values )
+    const QwtScaleMap &map, const double *values, int numValues )
 {
     bool isInverting = map.isInverting();
 
-    for ( int i = 0; i < values.size(); i++ )
+    for ( int i = 0; i < numValues; i++ )
     {
         const double y = values[ i ];
         if ( y != 0.0 )
@@ -30,6 +31,173 @@ inline static bool qwtIsIncreasing(
     return !isInverting;
 }
 
+static int qwtGroupedBars( Qt::Orientation orientation,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    double baseline, double value, double sampleWidth,
+    const double *set, int numBars,
+    QwtColumnRect *bars, int *valueIndexes )
+{
+    if ( orientation == Qt::Vertical )
+    {
+        const double barWidth = sampleWidth / numBars;
+
+        const double y1 = yMap.transform( baseline );
+        const double x0 = xMap.transform( value ) - 0.5 * sampleWidth;
+
+        for ( int i = 0; i < numBars; i++ )
+        {
+            const double x1 = x0 + i * barWidth;
+            const double x2 = x1 + barWidth;
+
+            const double y2 = yMap.transform( set[i] );
+
+            QwtColumnRect &barRect = bars[i];
+            barRect.direction = ( y1 < y2 ) ?
+                QwtColumnRect::TopToBottom : QwtColumnRect::BottomToTop;
+
+            barRect.hInterval = QwtInterval( x1, x2 ).normalized();
+            if ( i != 0 )
+                barRect.hInterval.setBorderFlags( QwtInterval::ExcludeMinimum );
+
+            barRect.vInterval = QwtInterval( y1, y2 ).normalized();
+
+            valueIndexes[i] = i;
+        }
+    }
+    else
+    {
+        const double barHeight = sampleWidth / numBars;
+
+        const double x1 = xMap.transform( baseline );
+        const double y0 = yMap.transform( value ) - 0.5 * sampleWidth;
+
+        for ( int i = 0; i < numBars; i++ )
+        {
+            double y1 = y0 + i * barHeight;
+            double y2 = y1 + barHeight;
+
+            double x2 = xMap.transform( set[i] );
+
+            QwtColumnRect &barRect = bars[i];
+            barRect.direction = x1 < x2 ?
+                QwtColumnRect::LeftToRight : QwtColumnRect::RightToLeft;
+
+            barRect.hInterval = QwtInterval( x1, x2 ).normalized();
+
+            barRect.vInterval = QwtInterval( y1, y2 );
+            if ( i != 0 )
+                barRect.vInterval.setBorderFlags( QwtInterval::ExcludeMinimum );
+
+            valueIndexes[i] = i;
+        }
+    }
+
+    return numBars;
+}
+
+static int qwtStackedBars( Qt::Orientation orientation,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    double baseline, double value, double sampleWidth,
+    const double *set, int numValues,
+    QwtColumnRect *bars, int *valueIndexes )
+{
+    int numBars = 0;
+
+    QwtInterval::BorderFlag borderFlags = QwtInterval::IncludeBorders;
+
+    if ( orientation == Qt::Vertical )
+    {
+        const double x1 = xMap.transform( value ) - 0.5 * sampleWidth;
+        const double x2 = x1 + sampleWidth;
+
+        const bool increasing = qwtIsIncreasing( yMap, set, numValues );
+
+        QwtColumnRect bar;
+        bar.direction = increasing ?
+            QwtColumnRect::TopToBottom : QwtColumnRect::BottomToTop;
+
+        bar.hInterval = QwtInterval( x1, x2 ).normalized();
+
+        double sum = baseline;
+
+        for ( int i = 0; i < numValues; i++ )
+        {
+            const double si = set[ i ];
+            if ( si == 0.0 )
+                continue;
+
+            const double y1 = yMap.transform( sum );
+            const double y2 = yMap.transform( sum + si );
+
+            if ( ( y2 > y1 ) != increasing )
+            {
+                // stacked bars need to be in the same direction
+                continue;
+            }
+
+            bar.vInterval = QwtInterval( y1, y2 ).normalized();
+            bar.vInterval.setBorderFlags( borderFlags );
+
+            bars[numBars] = bar;
+            valueIndexes[numBars] = i;
+            numBars++;
+
+            sum += si;
+
+            if ( increasing )
+                borderFlags = QwtInterval::ExcludeMinimum;
+            else
+                borderFlags = QwtInterval::ExcludeMaximum;
+        }
+    }
+    else
+    {
+        const double y1 = yMap.transform( value ) - 0.5 * sampleWidth;
+        const double y2 = y1 + sampleWidth;
+
+        const bool increasing = qwtIsIncreasing( xMap, set, numValues );
+
+        QwtColumnRect bar;
+        bar.direction = increasing ?
+            QwtColumnRect::LeftToRight : QwtColumnRect::RightToLeft;
+        bar.vInterval = QwtInterval( y1, y2 ).normalized();
+
+        double sum = baseline;
+
+        for ( int i = 0; i < numValues; i++ )
+        {
+            const double si = set[ i ];
+            if ( si == 0.0 )
+                continue;
+
+            const double x1 = xMap.transform( sum );
+            const double x2 = xMap.transform( sum + si );
+
+            if ( ( x2 > x1 ) != increasing )
+            {
+                // stacked bars need to be in the same direction
+                continue;
+            }
+
+            bar.hInterval = QwtInterval( x1, x2 ).normalized();
+            bar.hInterval.setBorderFlags( borderFlags );
+
+            bars[numBars] = bar;
+            valueIndexes[numBars] = i;
+            numBars++;
+
+            sum += si;
+
+            if ( increasing )
+                borderFlags = QwtInterval::ExcludeMinimum;
+            else
+                borderFlags = QwtInterval::ExcludeMaximum;
+        }
+    }
+
+    return numBars;
+}
+
 class QwtPlotMultiBarChart::PrivateData
 {
 public:
@@ -39,6 +207,7 @@ public:
     }
 
     QwtPlotMultiBarChart::ChartStyle style;
+    QwtPlotMultiBarChart::PaintAttributes paintAttributes;
     QList<QwtText> barTitles;
     QMap<int, QwtColumnSymbol *> symbolMap;
 };
@@ -82,6 +251,32 @@ int QwtPlotMultiBarChart::rtti() const
     return QwtPlotItem::Rtti_PlotMultiBarChart;
 }
 
+/*!
+  Specify an attribute how to draw the chart
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotMultiBarChart::setPaintAttribute(
+    PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa setPaintAttribute()
+*/
+bool QwtPlotMultiBarChart::testPaintAttribute(
+    PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Initialize data with an array of samples.
   \param samples Vector of points
@@ -106,6 +301,22 @@ void QwtPlotMultiBarChart::setSamples(
     setData( new QwtSetSeriesData( s ) );
 }
 
+/*!
+  Initialize data with sets, that have a fixed number of values
+
+  \param positions Positions of the sets
+  \param values Values of all sets, where the values of
+                consecutive sets follow each other
+  \param setSize Number of values of each set
+
+  \sa QwtSetArrayData, BatchedBars
+*/
+void QwtPlotMultiBarChart::setSamples( const QVector<double> &positions,
+    const QVector<double> &values, int setSize )
+{
+    setData( new QwtSetArrayData( positions, values, setSize ) );
+}
+
 /*!
   Assign a series of samples
     
@@ -332,20 +543,47 @@ QRectF QwtPlotMultiBarChart::boundingRect() const
 
         const QwtSeriesData<QwtSetSample> *series = data();
 
+        const QwtSetArrayData *arrayData =
+            dynamic_cast<const QwtSetArrayData *>( series );
+
+        const bool hasSpan = ( arrayData != NULL );
+
+        QwtSetSpan span;
+        if ( hasSpan )
+            span = arrayData->setSpan();
+
         for ( size_t i = 0; i < numSamples; i++ )
         {
-            const QwtSetSample sample = series->sample( i );
+            double value;
+            double added = 0.0;
+
+            if ( hasSpan )
+            {
+                value = span.position( i );
+
+                const double *values = span.values( i );
+                for ( int j = 0; j < span.setSize(); j++ )
+                    added += values[j];
+            }
+            else
+            {
+                const QwtSetSample sample = series->sample( i );
+
+                value = sample.value;
+                added = sample.added();
+            }
+
             if ( i == 0 )
             {
-                xMin = xMax = sample.value;
+                xMin = xMax = value;
             }
             else
             {
-                xMin = qMin( xMin, sample.value );
-                xMax = qMax( xMax, sample.value );
+                xMin = qMin( xMin, value );
+                xMax = qMax( xMax, value );
             }
 
-            const double y = baseLine + sample.added();
+            const double y = baseLine + added;
 
             yMin = qMin( yMin, y );
             yMax = qMax( yMax, y );
@@ -385,6 +623,11 @@ void QwtPlotMultiBarChart::drawSeries( QPainter *painter,
     if ( from > to )
         return;
 
+    if ( d_data->paintAttributes & BatchedBars )
+    {
+        drawBatchedBars( painter, xMap, yMap, canvasRect, from, to );
+        return;
+    }
 
     const QRectF br = data()->boundingRect();
     const QwtInterval interval( br.left(), br.right() );
@@ -400,6 +643,133 @@ void QwtPlotMultiBarChart::drawSeries( QPainter *painter,
     painter->restore();
 }
 
+/*!
+  Draw an interval of the bar chart in BatchedBars mode
+
+  The bars of all samples are collected per value index and
+  painted by one QwtColumnSymbol::drawColumns() call for each
+  symbol.
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+  \param from Index of the first sample to be painted
+  \param to Index of the last sample to be painted
+
+  \sa drawSeries(), BatchedBars
+*/
+void QwtPlotMultiBarChart::drawBatchedBars( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    const QwtSeriesData<QwtSetSample> *series = data();
+
+    const QwtSetArrayData *arrayData =
+        dynamic_cast<const QwtSetArrayData *>( series );
+
+    const bool hasSpan = ( arrayData != NULL );
+
+    QwtSetSpan span;
+    if ( hasSpan )
+        span = arrayData->setSpan();
+
+    const QRectF br = series->boundingRect();
+    const double boundingWidth = br.width();
+
+    const Qt::Orientation orient = orientation();
+    const double baseLine = baseline();
+
+    QVector< QVector<QwtColumnRect> > columns;
+
+    QVarLengthArray<QwtColumnRect, 32> bars;
+    QVarLengthArray<int, 32> valueIndexes;
+
+    QwtSetSample sample;
+
+    for ( int i = from; i <= to; i++ )
+    {
+        double value;
+        const double *set;
+        int numValues;
+
+        if ( hasSpan )
+        {
+            value = span.position( i );
+            set = span.values( i );
+            numValues = span.setSize();
+        }
+        else
+        {
+            sample = series->sample( i );
+
+            value = sample.value;
+            set = sample.set.constData();
+            numValues = sample.set.size();
+        }
+
+        if ( numValues <= 0 )
+            continue;
+
+        double sampleW;
+        if ( orient == Qt::Horizontal )
+        {
+            sampleW = sampleWidth( yMap, canvasRect.height(),
+                boundingWidth, value );
+        }
+        else
+        {
+            sampleW = sampleWidth( xMap, canvasRect.width(),
+                boundingWidth, value );
+        }
+
+        bars.resize( numValues );
+        valueIndexes.resize( numValues );
+
+        int numBars;
+        if ( d_data->style == Stacked )
+        {
+            numBars = qwtStackedBars( orient, xMap, yMap, baseLine, value,
+                sampleW, set, numValues, bars.data(), valueIndexes.data() );
+        }
+        else
+        {
+            numBars = qwtGroupedBars( orient, xMap, yMap, baseLine, value,
+                sampleW, set, numValues, bars.data(), valueIndexes.data() );
+        }
+
+        if ( columns.size() < numValues )
+            columns.resize( numValues );
+
+        for ( int j = 0; j < numBars; j++ )
+        {
+            QVector<QwtColumnRect> &rects = columns[ valueIndexes[j] ];
+            if ( rects.isEmpty() )
+                rects.reserve( to - i + 1 );
+
+            rects += bars[j];
+        }
+    }
+
+    // we build a temporary default symbol
+    QwtColumnSymbol defaultSymbol( QwtColumnSymbol::Box );
+    defaultSymbol.setLineWidth( 1 );
+    defaultSymbol.setFrameStyle( QwtColumnSymbol::Plain );
+
+    for ( int valueIndex = 0; valueIndex < columns.size(); valueIndex++ )
+    {
+        const QVector<QwtColumnRect> &rects = columns[ valueIndex ];
+        if ( rects.isEmpty() )
+            continue;
+
+        const QwtColumnSymbol *sym = symbol( valueIndex );
+        if ( sym == NULL )
+            sym = &defaultSymbol;
+
+        sym->drawColumns( painter, rects.constData(), rects.size() );
+    }
+}
+
 /*!
   Draw a sample
 
@@ -470,60 +840,15 @@ void QwtPlotMultiBarChart::drawGroupedBars( QPainter *painter,
     if ( numBars == 0 )
         return;
 
-    if ( orientation() == Qt::Vertical )
-    {
-        const double barWidth = sampleWidth / numBars;
-
-        const double y1 = yMap.transform( baseline() );
-        const double x0 = xMap.transform( sample.value ) - 0.5 * sampleWidth;
-
-        for ( int i = 0; i < numBars; i++ )
-        {
-            const double x1 = x0 + i * barWidth;
-            const double x2 = x1 + barWidth;
-
-            const double y2 = yMap.transform( sample.set[i] );
-
-            QwtColumnRect barRect;
-            barRect.direction = ( y1 < y2 ) ?
-                QwtColumnRect::TopToBottom : QwtColumnRect::BottomToTop;
-
-            barRect.hInterval = QwtInterval( x1, x2 ).normalized();
-            if ( i != 0 )
-                barRect.hInterval.setBorderFlags( QwtInterval::ExcludeMinimum );
-
-            barRect.vInterval = QwtInterval( y1, y2 ).normalized();
+    QVarLengthArray<QwtColumnRect, 32> bars( numBars );
+    QVarLengthArray<int, 32> valueIndexes( numBars );
 
-            drawBar( painter, index, i, barRect );
-        }
-    }
-    else
-    {
-        const double barHeight = sampleWidth / numBars;
-
-        const double x1 = xMap.transform( baseline() );
-        const double y0 = yMap.transform( sample.value ) - 0.5 * sampleWidth;
-
-        for ( int i = 0; i < numBars; i++ )
-        {
-            double y1 = y0 + i * barHeight;
-            double y2 = y1 + barHeight;
-
-            double x2 = xMap.transform( sample.set[i] );
-
-            QwtColumnRect barRect;
-            barRect.direction = x1 < x2 ?
-                QwtColumnRect::LeftToRight : QwtColumnRect::RightToLeft;
+    qwtGroupedBars( orientation(), xMap, yMap, baseline(),
+        sample.value, sampleWidth, sample.set.constData(), numBars,
+        bars.data(), valueIndexes.data() );
 
-            barRect.hInterval = QwtInterval( x1, x2 ).normalized();
-
-            barRect.vInterval = QwtInterval( y1, y2 );
-            if ( i != 0 )
-                barRect.vInterval.setBorderFlags( QwtInterval::ExcludeMinimum );
-
-            drawBar( painter, index, i, barRect );
-        }
-    }
+    for ( int i = 0; i < numBars; i++ )
+        drawBar( painter, index, valueIndexes[i], bars[i] );
 }
 
 /*!
@@ -546,98 +871,19 @@ void QwtPlotMultiBarChart::drawStackedBars( QPainter *painter,
 {
     Q_UNUSED( canvasRect ); // clipping the bars ?
 
-    const int numBars = sample.set.size();
-    if ( numBars == 0 )
+    const int numValues = sample.set.size();
+    if ( numValues == 0 )
         return;
 
-    QwtInterval::BorderFlag borderFlags = QwtInterval::IncludeBorders;
-
-    if ( orientation() == Qt::Vertical )
-    {
-        const double x1 = xMap.transform( sample.value ) - 0.5 * sampleWidth;
-        const double x2 = x1 + sampleWidth;
-
-        const bool increasing = qwtIsIncreasing( yMap, sample.set );
-
-        QwtColumnRect bar;
-        bar.direction = increasing ?
-            QwtColumnRect::TopToBottom : QwtColumnRect::BottomToTop;
-
-        bar.hInterval = QwtInterval( x1, x2 ).normalized();
-
-        double sum = baseline();
+    QVarLengthArray<QwtColumnRect, 32> bars( numValues );
+    QVarLengthArray<int, 32> valueIndexes( numValues );
 
-        const int numBars = sample.set.size();
-        for ( int i = 0; i < numBars; i++ )
-        {
-            const double si = sample.set[ i ];
-            if ( si == 0.0 )
-                continue;
+    const int numBars = qwtStackedBars( orientation(), xMap, yMap,
+        baseline(), sample.value, sampleWidth, sample.set.constData(),
+        numValues, bars.data(), valueIndexes.data() );
 
-            const double y1 = yMap.transform( sum );
-            const double y2 = yMap.transform( sum + si );
-
-            if ( ( y2 > y1 ) != increasing )
-            {
-                // stacked bars need to be in the same direction
-                continue;
-            }
-
-            bar.vInterval = QwtInterval( y1, y2 ).normalized();
-            bar.vInterval.setBorderFlags( borderFlags );
-
-            drawBar( painter, index, i, bar );
-
-            sum += si;
-
-            if ( increasing )
-                borderFlags = QwtInterval::ExcludeMinimum;
-            else
-                borderFlags = QwtInterval::ExcludeMaximum;
-        }
-    }
-    else
-    {
-        const double y1 = yMap.transform( sample.value ) - 0.5 * sampleWidth;
-        const double y2 = y1 + sampleWidth;
-
-        const bool increasing = qwtIsIncreasing( xMap, sample.set );
-
-        QwtColumnRect bar;
-        bar.direction = increasing ?
-            QwtColumnRect::LeftToRight : QwtColumnRect::RightToLeft;
-        bar.vInterval = QwtInterval( y1, y2 ).normalized();
-
-        double sum = baseline();
-
-        for ( int i = 0; i < sample.set.size(); i++ )
-        {
-            const double si = sample.set[ i ];
-            if ( si == 0.0 )
-                continue;
-
-            const double x1 = xMap.transform( sum );
-            const double x2 = xMap.transform( sum + si );
-
-            if ( ( x2 > x1 ) != increasing )
-            {
-                // stacked bars need to be in the same direction
-                continue;
-            }
-
-            bar.hInterval = QwtInterval( x1, x2 ).normalized();
-            bar.hInterval.setBorderFlags( borderFlags );
-
-            drawBar( painter, index, i, bar );
-
-            sum += si;
-
-            if ( increasing )
-                borderFlags = QwtInterval::ExcludeMinimum;
-            else
-                borderFlags = QwtInterval::ExcludeMaximum;
-        }
-    }
+    for ( int i = 0; i < numBars; i++ )
+        drawBar( painter, index, valueIndexes[i], bars[i] );
 }
 
 /*!
@@ -61,6 +61,31 @@ public:
         Stacked
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        The default setting disables all attributes
+
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          Collect the bars of all samples, that are displayed with
+          the same symbol, and paint them with
+          QwtColumnSymbol::drawColumns() at once. When the series is
+          a QwtSetArrayData its values are read from
+          QwtSetArrayData::setSpan() and no QwtSetSample is built
+          for painting.
+
+          In this mode drawSample(), drawBar() and specialSymbol()
+          are not called.
+         */
+        BatchedBars = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotMultiBarChart( const QString &title = QString::null );
     explicit QwtPlotMultiBarChart( const QwtText &title );
 
@@ -68,11 +93,16 @@ public:
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setBarTitles( const QList<QwtText> & );
     QList<QwtText> barTitles() const;
 
     void setSamples( const QVector<QwtSetSample> & );
     void setSamples( const QVector< QVector<double> > & );
+    void setSamples( const QVector<double> &positions,
+        const QVector<double> &values, int setSize );
     void setSamples( QwtSeriesData<QwtSetSample> * );
 
     void setStyle( ChartStyle style );
@@ -120,8 +150,14 @@ protected:
 private:
     void init();
 
+    void drawBatchedBars( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect, int from, int to ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotMultiBarChart::PaintAttributes )
+
 #endif
@@ -11,9 +11,12 @@
 #include "qwt_scale_div.h"
 #include "qwt_plot.h"
 #include "qwt_painter.h"
+#include "qwt_scale_map.h"
 #include <qbitmap.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
+#include <qpainter.h>
+#include <qevent.h>
 
 static QBitmap qwtBorderMask( const QWidget *canvas, const QSize &size )
 {
@@ -90,13 +93,32 @@ static QBitmap qwtBorderMask( const QWidget *canvas, const QSize &size )
 class QwtPlotPanner::PrivateData
 {
 public:
-    PrivateData()
+    PrivateData():
+        panMode( QwtPlotPanner::GrabMode ),
+        isScrolling( false )
     {
         for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+        {
             isAxisEnabled[axis] = true;
+            isAutoScale[axis] = false;
+        }
     }
 
     bool isAxisEnabled[QwtPlot::axisCnt];
+    QwtPlotPanner::PanMode panMode;
+
+    // LiveMode
+
+    bool isScrolling;
+    QPoint offset;
+
+    QPixmap pixmap;
+    QRegion contentsRegion;
+
+    // the scales, when dragging has started
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    QwtScaleDiv scaleDivs[QwtPlot::axisCnt];
+    bool isAutoScale[QwtPlot::axisCnt];
 };
 
 /*!
@@ -115,6 +137,9 @@ QwtPlotPanner::QwtPlotPanner( QWidget *canvas ):
 
     connect( this, SIGNAL( panned( int, int ) ),
         SLOT( moveCanvas( int, int ) ) );
+
+    connect( this, SIGNAL( moved( int, int ) ),
+        SLOT( scrollCanvas( int, int ) ) );
 }
 
 //! Destructor
@@ -123,6 +148,39 @@ QwtPlotPanner::~QwtPlotPanner()
     delete d_data;
 }
 
+/*!
+   \brief Set the mode how to display the canvas while dragging
+
+   In LiveMode the scales are adjusted with each mouse movement,
+   so that the axes and the content of the canvas are always
+   in sync. The pixels, that are still visible, are scrolled and only
+   the strips, that have been exposed, are rendered by
+   QwtPlot::drawItems(). When dragging is aborted the previous scales
+   are restored.
+
+   The default mode is GrabMode.
+
+   \param mode Pan mode
+   \sa panMode()
+
+   \note Items, that are aligned to the canvas instead of the scales
+         ( f.e. QwtPlotTextLabel ) are moved with the content
+         until the mouse is released - like in GrabMode.
+*/
+void QwtPlotPanner::setPanMode( PanMode mode )
+{
+    d_data->panMode = mode;
+}
+
+/*!
+   \return Mode how to display the canvas while dragging
+   \sa setPanMode()
+*/
+QwtPlotPanner::PanMode QwtPlotPanner::panMode() const
+{
+    return d_data->panMode;
+}
+
 /*!
    \brief En/Disable an axis
 
@@ -205,6 +263,19 @@ void QwtPlotPanner::moveCanvas( int dx, int dy )
     if ( plot == NULL )
         return;
 
+    if ( d_data->isScrolling )
+    {
+        // the scales have been adjusted while dragging already
+
+        d_data->isScrolling = false;
+        d_data->pixmap = QPixmap();
+
+        shiftScales( dx, dy );
+        plot->replot();
+
+        return;
+    }
+
     const bool doAutoReplot = plot->autoReplot();
     plot->setAutoReplot( false );
 
@@ -256,20 +327,307 @@ QBitmap QwtPlotPanner::contentsMask() const
  */
 QPixmap QwtPlotPanner::grab() const
 {   
+    QPixmap pm;
+
     const QWidget *cv = canvas();
     if ( cv && cv->inherits( "QGLWidget" ) )
     {
         // we can't grab from a QGLWidget
 
-        QPixmap pm( cv->size() );
+        pm = QPixmap( cv->size() );
         QwtPainter::fillPixmap( cv, pm );
 
         QPainter painter( &pm );
         const_cast<QwtPlot *>( plot() )->drawCanvas( &painter );
+    }
+    else
+    {
+        pm = QwtPanner::grab();
+    }
+
+    if ( d_data->panMode == LiveMode )
+    {
+        // the start of scrolling in LiveMode
+        d_data->pixmap = pm;
+    }
+
+    return pm;
+}
+
+/*!
+   Adjust the enabled axes according to the offset and
+   update the canvas by scrolling its content in LiveMode
+
+   \param dx Pixel offset in x direction
+   \param dy Pixel offset in y direction
+
+   \sa QwtPanner::moved(), setPanMode()
+*/
+void QwtPlotPanner::scrollCanvas( int dx, int dy )
+{
+    QwtPlot *plot = this->plot();
+    QWidget *cv = canvas();
+
+    if ( !d_data->isScrolling || plot == NULL || cv == NULL )
+        return;
+
+    const int ddx = dx - d_data->offset.x();
+    const int ddy = dy - d_data->offset.y();
+
+    if ( ddx == 0 && ddy == 0 )
+        return;
+
+    d_data->offset = QPoint( dx, dy );
+
+    shiftScales( dx, dy );
+    plot->updateAxes();
+
+    const QRect cr = cv->contentsRect();
+
+#if QT_VERSION >= 0x050000
+    const qreal ratio = d_data->pixmap.devicePixelRatio();
+#else
+    const qreal ratio = 1.0;
+#endif
+
+    const QSize size = d_data->pixmap.size() / ratio;
+
+    if ( size != cv->size() )
+    {
+        // the layout of the plot has been changed: starting
+        // from scratch with a canvas without frame
+
+        setGeometry( cv->rect() );
+
+        d_data->pixmap = QwtPainter::backingStore( cv, cv->size() );
+        QwtPainter::fillPixmap( cv, d_data->pixmap );
+
+        d_data->contentsRegion = QRegion( contentsMask() );
+
+        renderContents( cr );
+    }
+    else if ( qAbs( ddx ) >= cr.width() || qAbs( ddy ) >= cr.height() )
+    {
+        renderContents( cr );
+    }
+    else
+    {
+        const QRect scrollRect( qRound( cr.x() * ratio ),
+            qRound( cr.y() * ratio ), qRound( cr.width() * ratio ),
+            qRound( cr.height() * ratio ) );
+
+        d_data->pixmap.scroll( qRound( ddx * ratio ),
+            qRound( ddy * ratio ), scrollRect );
 
-        return pm;
+        // the exposed strips
+
+        if ( ddx > 0 )
+            renderContents( QRect( cr.left(), cr.top(), ddx, cr.height() ) );
+        else if ( ddx < 0 )
+            renderContents( QRect( cr.right() + 1 + ddx, cr.top(), -ddx, cr.height() ) );
+
+        if ( ddy > 0 )
+            renderContents( QRect( cr.left(), cr.top(), cr.width(), ddy ) );
+        else if ( ddy < 0 )
+            renderContents( QRect( cr.left(), cr.bottom() + 1 + ddy, cr.width(), -ddy ) );
+    }
+
+    update();
+}
+
+/*!
+   Paint the canvas in LiveMode, or the moved pixmap
+   of QwtPanner otherwise
+
+   \param event Paint event
+*/
+void QwtPlotPanner::paintEvent( QPaintEvent *event )
+{
+    if ( !d_data->isScrolling )
+    {
+        QwtPanner::paintEvent( event );
+        return;
     }
 
-    return QwtPanner::grab();
+    // in LiveMode the content is always in its position.
+    // Outside of the contents region the frame of the canvas
+    // remains visible
+
+    QRegion clipRegion = event->region();
+    if ( !d_data->contentsRegion.isEmpty() )
+        clipRegion &= d_data->contentsRegion;
+
+    QPainter painter( this );
+    painter.setClipRegion( clipRegion );
+    painter.drawPixmap( 0, 0, d_data->pixmap );
+}
+
+/*!
+  Handle a mouse press event for the observed widget.
+
+  \param mouseEvent Mouse event
+  \sa QwtPanner::widgetMousePressEvent()
+*/
+void QwtPlotPanner::widgetMousePressEvent( QMouseEvent *mouseEvent )
+{
+    if ( d_data->isScrolling && isVisible() )
+    {
+        // a press while dragging must not restart from
+        // the scales, that have been shifted already
+        return;
+    }
+
+    const bool wasVisible = isVisible();
+
+    QwtPanner::widgetMousePressEvent( mouseEvent );
+
+    QwtPlot *plot = this->plot();
+
+    if ( wasVisible || !isVisible() || plot == NULL )
+    {
+        // the press didn't start panning
+        return;
+    }
+
+    if ( d_data->panMode != LiveMode )
+    {
+        d_data->pixmap = QPixmap();
+        return;
+    }
+
+    d_data->isScrolling = true;
+    d_data->offset = QPoint( 0, 0 );
+
+    const QBitmap mask = contentsMask();
+    if ( mask.isNull() )
+        d_data->contentsRegion = QRegion();
+    else
+        d_data->contentsRegion = QRegion( mask );
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        d_data->maps[axis] = plot->canvasMap( axis );
+        d_data->scaleDivs[axis] = plot->axisScaleDiv( axis );
+        d_data->isAutoScale[axis] = plot->axisAutoScale( axis );
+    }
+}
+
+/*!
+  Handle a mouse release event for the observed widget.
+
+  \param mouseEvent Mouse event
+  \sa QwtPanner::widgetMouseReleaseEvent()
+*/
+void QwtPlotPanner::widgetMouseReleaseEvent( QMouseEvent *mouseEvent )
+{
+    QwtPanner::widgetMouseReleaseEvent( mouseEvent );
+
+    if ( d_data->isScrolling && !isVisible() )
+    {
+        // released on the initial position: moveCanvas()
+        // has not been called
+
+        restoreScales();
+    }
+}
+
+/*!
+  Handle a key press event for the observed widget.
+
+  \param keyEvent Key event
+  \sa QwtPanner::widgetKeyPressEvent()
+*/
+void QwtPlotPanner::widgetKeyPressEvent( QKeyEvent *keyEvent )
+{
+    QwtPanner::widgetKeyPressEvent( keyEvent );
+
+    if ( d_data->isScrolling && !isVisible() )
+    {
+        // aborted
+        restoreScales();
+    }
+}
+
+void QwtPlotPanner::shiftScales( int dx, int dy )
+{
+    QwtPlot *plot = this->plot();
+
+    const bool doAutoReplot = plot->autoReplot();
+    plot->setAutoReplot( false );
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        if ( !d_data->isAxisEnabled[axis] )
+            continue;
+
+        // calculating from the initial scales to avoid
+        // accumulating rounding errors
+
+        const QwtScaleMap &map = d_data->maps[axis];
+        const QwtScaleDiv &scaleDiv = d_data->scaleDivs[axis];
+
+        const double p1 = map.transform( scaleDiv.lowerBound() );
+        const double p2 = map.transform( scaleDiv.upperBound() );
+
+        const int d = ( axis == QwtPlot::xBottom || axis == QwtPlot::xTop )
+            ? dx : dy;
+
+        plot->setAxisScale( axis,
+            map.invTransform( p1 - d ), map.invTransform( p2 - d ) );
+    }
+
+    plot->setAutoReplot( doAutoReplot );
+}
+
+void QwtPlotPanner::restoreScales()
+{
+    d_data->isScrolling = false;
+    d_data->pixmap = QPixmap();
+
+    QwtPlot *plot = this->plot();
+    if ( plot == NULL )
+        return;
+
+    const bool doAutoReplot = plot->autoReplot();
+    plot->setAutoReplot( false );
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        if ( !d_data->isAxisEnabled[axis] )
+            continue;
+
+        if ( d_data->isAutoScale[axis] )
+            plot->setAxisAutoScale( axis, true );
+        else
+            plot->setAxisScaleDiv( axis, d_data->scaleDivs[axis] );
+    }
+
+    plot->setAutoReplot( doAutoReplot );
+    plot->replot();
+}
+
+void QwtPlotPanner::renderContents( const QRect &rect )
+{
+    QWidget *cv = canvas();
+
+    const QRect r = rect & cv->contentsRect();
+    if ( r.isEmpty() )
+        return;
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+        maps[axis] = plot()->canvasMap( axis );
+
+    QPixmap strip = QwtPainter::backingStore( cv, r.size() );
+    QwtPainter::fillPixmap( cv, strip, r.topLeft() );
+
+    QPainter painter( &strip );
+    painter.translate( -r.topLeft() );
+
+    plot()->drawItems( &painter, cv->contentsRect(), maps );
+    painter.end();
+
+    painter.begin( &d_data->pixmap );
+    painter.drawPixmap( r.topLeft(), strip );
 }   
 
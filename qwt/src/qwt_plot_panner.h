@@ -25,17 +25,41 @@ class QwtPlot;
   Together with QwtPlotZoomer and QwtPlotMagnifier powerful ways
   of navigating on a QwtPlot widget can be implemented easily.
 
-  \note The axes are not updated, while dragging the canvas
-  \sa QwtPlotZoomer, QwtPlotMagnifier
+  \note In the default mode the axes are not updated, while dragging
+        the canvas.
+  \sa QwtPlotZoomer, QwtPlotMagnifier, setPanMode()
 */
 class QWT_EXPORT QwtPlotPanner: public QwtPanner
 {
     Q_OBJECT
 
 public:
+    /*!
+      \brief Mode how to display the canvas while dragging
+      \sa setPanMode()
+     */
+    enum PanMode
+    {
+        /*!
+          The canvas is grabbed into a pixmap, that is moved
+          around. The scales are adjusted, when the mouse is released.
+         */
+        GrabMode,
+
+        /*!
+          The scales are adjusted for each mouse movement. The content,
+          that is still visible, is scrolled and only the exposed strips
+          are rendered from the plot items.
+         */
+        LiveMode
+    };
+
     explicit QwtPlotPanner( QWidget * );
     virtual ~QwtPlotPanner();
 
+    void setPanMode( PanMode );
+    PanMode panMode() const;
+
     QWidget *canvas();
     const QWidget *canvas() const;
 
@@ -47,12 +71,23 @@ public:
 
 protected Q_SLOTS:
     virtual void moveCanvas( int dx, int dy );
+    virtual void scrollCanvas( int dx, int dy );
 
 protected:
     virtual QBitmap contentsMask() const;
     virtual QPixmap grab() const;
 
+    virtual void paintEvent( QPaintEvent * );
+
+    virtual void widgetMousePressEvent( QMouseEvent * );
+    virtual void widgetMouseReleaseEvent( QMouseEvent * );
+    virtual void widgetKeyPressEvent( QKeyEvent * );
+
 private:
+    void shiftScales( int dx, int dy );
+    void restoreScales();
+    void renderContents( const QRect & );
+
     class PrivateData;
     PrivateData *d_data;
 };
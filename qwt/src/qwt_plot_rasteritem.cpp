@@ -19,13 +19,15 @@
 #include <qfuture.h>
 #include <qtconcurrentrun.h>
 #include <float.h>
+#include <string.h>
 
 class QwtPlotRasterItem::PrivateData
 {
 public:
     PrivateData():
         alpha( -1 ),
-        paintAttributes( QwtPlotRasterItem::PaintInDeviceResolution )
+        paintAttributes( QwtPlotRasterItem::PaintInDeviceResolution ),
+        isScrolling( false )
     {
         cache.policy = QwtPlotRasterItem::NoCache;
     }
@@ -34,12 +36,19 @@ public:
 
     QwtPlotRasterItem::PaintAttributes paintAttributes;
 
+    // renderImage() is called for the uncovered parts of a scrolled image
+    bool isScrolling;
+
     struct ImageCache
     {
         QwtPlotRasterItem::CachePolicy policy;
         QRectF area;
         QSizeF size;
         QImage image;
+
+        // maps of the image, needed for ScrollCache
+        QwtScaleMap xMap;
+        QwtScaleMap yMap;
     } cache;
 };
 
@@ -361,7 +370,7 @@ static bool qwtUseCache( QwtPlotRasterItem::CachePolicy policy,
 {
     bool doCache = false;
 
-    if ( policy == QwtPlotRasterItem::PaintCache )
+    if ( policy != QwtPlotRasterItem::NoCache )
     {
         // Caching doesn't make sense, when the item is
         // not painted to screen
@@ -424,6 +433,87 @@ static void qwtToRgba( const QImage* from, QImage* to,
     }
 }
 
+static bool qwtPixelOffset( const QwtScaleMap &from,
+    const QwtScaleMap &to, int size, int &offset )
+{
+    // positions of the first and the last pixel of the old image
+    const double p1 = to.transform( from.invTransform( 0.0 ) );
+    const double p2 = to.transform( from.invTransform( size - 1 ) );
+
+    if ( !( qAbs( p1 ) < 1e6 ) )
+        return false;
+
+    offset = qRound( p1 );
+
+    const double eps = 1e-3;
+    return ( qAbs( p1 - offset ) < eps )
+        && ( qAbs( p2 - ( offset + size - 1 ) ) < eps );
+}
+
+static QwtInterval qwtPixelInterval( const QwtScaleMap &map,
+    int from, int to, bool aligned )
+{
+    double p1 = from;
+    double p2 = to;
+
+    if ( aligned )
+    {
+        // the map translates the centers of the pixels
+        p1 -= 0.5;
+        p2 += 0.5;
+    }
+
+    return QwtInterval( map.invTransform( p1 ),
+        map.invTransform( p2 ) ).normalized();
+}
+
+static void qwtScrollImage( QImage *image, int dx, int dy )
+{
+    const int bytesPerPixel = image->depth() / 8;
+    const int bytesPerLine = image->bytesPerLine();
+
+    const int numRows = image->height() - qAbs( dy );
+    const size_t numBytes = ( image->width() - qAbs( dx ) ) * bytesPerPixel;
+
+    uchar *bits = image->bits();
+
+    const uchar *src = bits + qMax( -dx, 0 ) * bytesPerPixel
+        + qMax( -dy, 0 ) * bytesPerLine;
+    uchar *dst = bits + qMax( dx, 0 ) * bytesPerPixel
+        + qMax( dy, 0 ) * bytesPerLine;
+
+    if ( dx == 0 )
+    {
+        memmove( dst, src, numRows * bytesPerLine );
+    }
+    else if ( dy > 0 )
+    {
+        for ( int i = numRows - 1; i >= 0; i-- )
+            memmove( dst + i * bytesPerLine, src + i * bytesPerLine, numBytes );
+    }
+    else
+    {
+        for ( int i = 0; i < numRows; i++ )
+            memmove( dst + i * bytesPerLine, src + i * bytesPerLine, numBytes );
+    }
+}
+
+static void qwtCopyImageRect( const QImage &from, const QRect &rect,
+    QImage *to, const QPoint &pos )
+{
+    const int bytesPerPixel = to->depth() / 8;
+    const size_t numBytes = rect.width() * bytesPerPixel;
+
+    for ( int i = 0; i < rect.height(); i++ )
+    {
+        const uchar *src = from.scanLine( rect.top() + i )
+            + rect.left() * bytesPerPixel;
+        uchar *dst = to->scanLine( pos.y() + i ) + pos.x() * bytesPerPixel;
+
+        memcpy( dst, src, numBytes );
+    }
+}
+
 //! Constructor
 QwtPlotRasterItem::QwtPlotRasterItem( const QString& title ):
     QwtPlotItem( QwtText( title ) )
@@ -849,13 +939,22 @@ QImage QwtPlotRasterItem::compose(
         const QwtScaleMap yyMap = 
             imageMap(Qt::Vertical, yMap, imageArea, imageSize, dy);
 
-        image = renderImage( xxMap, yyMap, imageArea, imageSize );
+        if ( doCache && d_data->cache.policy == ScrollCache )
+        {
+            image = scrollCachedImage( xxMap, yyMap,
+                imageSize, dx > 0.0, dy > 0.0 );
+        }
+
+        if ( image.isNull() )
+            image = renderImage( xxMap, yyMap, imageArea, imageSize );
 
         if ( doCache )
         {
             d_data->cache.area = imageArea;
             d_data->cache.size = paintRect.size();
             d_data->cache.image = image;
+            d_data->cache.xMap = xxMap;
+            d_data->cache.yMap = yyMap;
         }
     }
 
@@ -901,6 +1000,131 @@ QImage QwtPlotRasterItem::compose(
     return image;
 }
 
+/*!
+   \brief Reuse the cached image for the ScrollCache policy
+
+   When the pixels of the cached image can be found at integer
+   positions of the requested image the cached image is moved
+   to its new position and renderImage() is called for the parts
+   of the image, that are not covered.
+
+   \param xMap X-Scale Map of the requested image
+   \param yMap Y-Scale Map of the requested image
+   \param imageSize Size of the requested image
+   \param alignedX The x coordinates of the image are aligned to data pixels
+   \param alignedY The y coordinates of the image are aligned to data pixels
+
+   \return Updated image, or a null image, when the cached image
+           can't be reused
+*/
+QImage QwtPlotRasterItem::scrollCachedImage(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QSize &imageSize, bool alignedX, bool alignedY ) const
+{
+    PrivateData::ImageCache &cache = d_data->cache;
+
+    if ( cache.image.isNull() )
+        return QImage();
+
+    const int depth = cache.image.depth();
+    if ( depth != 8 && depth != 32 )
+        return QImage();
+
+    int dx, dy;
+    if ( !qwtPixelOffset( cache.xMap, xMap, cache.image.width(), dx )
+        || !qwtPixelOffset( cache.yMap, yMap, cache.image.height(), dy ) )
+    {
+        return QImage();
+    }
+
+    const QRect imageRect( 0, 0, imageSize.width(), imageSize.height() );
+
+    const QRect overlap = imageRect & cache.image.rect().translated( dx, dy );
+    if ( overlap.isEmpty() )
+        return QImage();
+
+    QImage image;
+
+    if ( cache.image.size() == imageSize )
+    {
+        // releasing the cache to avoid detaching
+        image = cache.image;
+        cache.image = QImage();
+
+        if ( dx != 0 || dy != 0 )
+            qwtScrollImage( &image, dx, dy );
+    }
+    else
+    {
+        image = QImage( imageSize, cache.image.format() );
+        if ( depth == 8 )
+            image.setColorTable( cache.image.colorTable() );
+
+        qwtCopyImageRect( cache.image,
+            overlap.translated( -dx, -dy ), &image, overlap.topLeft() );
+    }
+
+    const int w = imageRect.width();
+    const int h = imageRect.height();
+
+    const QRect tiles[] =
+    {
+        QRect( 0, 0, w, overlap.top() ),
+        QRect( 0, overlap.bottom() + 1, w, h - overlap.bottom() - 1 ),
+        QRect( 0, overlap.top(), overlap.left(), overlap.height() ),
+        QRect( overlap.right() + 1, overlap.top(),
+            w - overlap.right() - 1, overlap.height() )
+    };
+
+    for ( uint i = 0; i < sizeof( tiles ) / sizeof( tiles[0] ); i++ )
+    {
+        const QRect &tile = tiles[i];
+        if ( tile.isEmpty() )
+            continue;
+
+        QwtScaleMap tileXMap = xMap;
+        tileXMap.setPaintInterval(
+            xMap.p1() - tile.left(), xMap.p2() - tile.left() );
+
+        QwtScaleMap tileYMap = yMap;
+        tileYMap.setPaintInterval(
+            yMap.p1() - tile.top(), yMap.p2() - tile.top() );
+
+        const QwtInterval xInterval = qwtPixelInterval(
+            xMap, tile.left(), tile.right(), alignedX );
+        const QwtInterval yInterval = qwtPixelInterval(
+            yMap, tile.top(), tile.bottom(), alignedY );
+
+        const QRectF tileArea( xInterval.minValue(), yInterval.minValue(),
+            xInterval.width(), yInterval.width() );
+
+        d_data->isScrolling = true;
+        const QImage tileImage = renderImage(
+            tileXMap, tileYMap, tileArea, tile.size() );
+        d_data->isScrolling = false;
+
+        if ( tileImage.size() != tile.size()
+            || tileImage.format() != image.format() )
+        {
+            return QImage();
+        }
+
+        qwtCopyImageRect( tileImage, tileImage.rect(), &image, tile.topLeft() );
+    }
+
+    return image;
+}
+
+/*!
+   \return True, while renderImage() is called for the parts of an image,
+           that are not covered by the scrolled cached image
+   \sa ScrollCache, renderImage()
+*/
+bool QwtPlotRasterItem::isScrollingCache() const
+{
+    return d_data->isScrolling;
+}
+
 /*!
    \brief Calculate a scale map for painting to an image
 
@@ -56,7 +56,22 @@ public:
           of hide/show operations or manipulations of the alpha value. 
           All other situations are handled by the canvas backing store.
          */
-        PaintCache
+        PaintCache,
+
+        /*!
+          Like PaintCache, but when the image area has been moved or
+          resized by full pixels without changing the resolution
+          - f.e. when scrolling the time axis of a waterfall plot -
+          the cached image is scrolled and renderImage() is called
+          for the uncovered parts only.
+
+          This policy requires, that the values of the area, that is
+          covered by the cached image, have not been changed. Any other
+          modification of the data needs to be followed by invalidateCache().
+
+          \sa QwtRingBufferRasterData
+         */
+        ScrollCache
     };
 
     /*!
@@ -96,7 +111,7 @@ public:
     void setCachePolicy( CachePolicy );
     CachePolicy cachePolicy() const;
 
-    void invalidateCache();
+    virtual void invalidateCache();
 
     virtual void draw( QPainter *p,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -132,6 +147,8 @@ protected:
         const QwtScaleMap &map, const QRectF &area,
         const QSize &imageSize, double pixelSize) const;
 
+    bool isScrollingCache() const;
+
 private:
     explicit QwtPlotRasterItem( const QwtPlotRasterItem & );
     QwtPlotRasterItem &operator=( const QwtPlotRasterItem & );
@@ -142,6 +159,9 @@ private:
         const QRectF &imageArea, const QRectF &paintRect,
         const QSize &imageSize, bool doCache) const;
 
+    QImage scrollCachedImage( const QwtScaleMap &, const QwtScaleMap &,
+        const QSize &imageSize, bool alignedX, bool alignedY ) const;
+
 
     class PrivateData;
     PrivateData *d_data;
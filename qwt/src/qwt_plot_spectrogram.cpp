@@ -12,14 +12,20 @@
 #include "qwt_interval.h"
 #include "qwt_scale_map.h"
 #include "qwt_color_map.h"
+#include "qwt_plot.h"
+#include "qwt_plot_canvas.h"
 #include <qimage.h>
 #include <qpen.h>
 #include <qpainter.h>
 #include <qmath.h>
 #include <qalgorithms.h>
 #include <qthread.h>
+#include <qcache.h>
 #include <qfuture.h>
+#include <qfuturewatcher.h>
 #include <qtconcurrentrun.h>
+#include <qtconcurrentmap.h>
+#include <string.h>
 
 #define DEBUG_RENDER 0
 
@@ -27,6 +33,22 @@
 #include <QElapsedTimer>
 #endif
 
+static bool qwtIsCanvasDevice( const QwtPlot *plot,
+    const QPaintDevice *device )
+{
+    const QWidget *canvas = plot->canvas();
+    if ( canvas == NULL )
+        return false;
+
+    if ( device == canvas )
+        return true;
+
+    const QwtPlotCanvas *plotCanvas =
+        qobject_cast<const QwtPlotCanvas *>( canvas );
+
+    return plotCanvas && ( device == plotCanvas->backingStore() );
+}
+
 static inline bool qwtIsNaN( double d )
 {   
     // qt_is_nan is private header and qIsNaN is not inlined
@@ -43,12 +65,144 @@ static inline bool qwtIsNaN( double d )
     }
 }
 
+static inline uint qwtHashDouble( double value )
+{
+    quint64 bits;
+    ::memcpy( &bits, &value, sizeof( bits ) );
+
+    return qHash( bits );
+}
+
+class QwtTileKey
+{
+public:
+    QwtTileKey( const QRectF &area, const QSize &imageSize, const QRect &tile ):
+        area( area ),
+        imageSize( imageSize ),
+        tile( tile )
+    {
+    }
+
+    inline bool operator==( const QwtTileKey &other ) const
+    {
+        return ( area == other.area ) && ( imageSize == other.imageSize )
+            && ( tile == other.tile );
+    }
+
+    QRectF area;
+    QSize imageSize;
+    QRect tile;
+};
+
+static inline uint qHash( const QwtTileKey &key )
+{
+    uint hash = qwtHashDouble( key.area.x() );
+    hash = 31 * hash + qwtHashDouble( key.area.y() );
+    hash = 31 * hash + qwtHashDouble( key.area.width() );
+    hash = 31 * hash + qwtHashDouble( key.area.height() );
+    hash = 31 * hash + key.imageSize.width();
+    hash = 31 * hash + key.imageSize.height();
+    hash = 31 * hash + key.tile.x();
+    hash = 31 * hash + key.tile.y();
+
+    return hash;
+}
+
+static void qwtCopyTile( const QImage &tile, const QPoint &pos, QImage *image )
+{
+    const int bytesPerPixel = image->depth() / 8;
+    const int numBytes = tile.width() * bytesPerPixel;
+
+    for ( int y = 0; y < tile.height(); y++ )
+    {
+        uchar *line = image->scanLine( pos.y() + y ) + pos.x() * bytesPerPixel;
+        ::memcpy( line, tile.scanLine( y ), numBytes );
+    }
+}
+
+static void qwtScaleUp( const QImage &coarse, int factor, QImage *image )
+{
+    const int numBytes = image->bytesPerLine();
+
+    for ( int y = 0; y < image->height(); y++ )
+    {
+        uchar *line = image->scanLine( y );
+
+        if ( y % factor )
+        {
+            ::memcpy( line, image->scanLine( y - 1 ), numBytes );
+            continue;
+        }
+
+        if ( image->depth() == 32 )
+        {
+            const QRgb *from = reinterpret_cast<const QRgb *>(
+                coarse.scanLine( y / factor ) );
+
+            QRgb *to = reinterpret_cast<QRgb *>( line );
+            for ( int x = 0; x < image->width(); x++ )
+                to[x] = from[ x / factor ];
+        }
+        else
+        {
+            const uchar *from = coarse.scanLine( y / factor );
+            for ( int x = 0; x < image->width(); x++ )
+                line[x] = from[ x / factor ];
+        }
+    }
+}
+
 class QwtPlotSpectrogram::PrivateData
 {
 public:
+    class TileRenderer
+    {
+    public:
+        typedef QImage result_type;
+
+        TileRenderer( const QwtPlotSpectrogram *spectrogram,
+                const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+                QImage::Format format ):
+            d_spectrogram( spectrogram ),
+            d_xMap( xMap ),
+            d_yMap( yMap ),
+            d_format( format )
+        {
+        }
+
+        QImage operator()( const QRect &tile ) const
+        {
+            // maps, that translate the tile to the origin
+
+            QwtScaleMap xMap = d_xMap;
+            xMap.setPaintInterval( d_xMap.p1() - tile.left(),
+                d_xMap.p2() - tile.left() );
+
+            QwtScaleMap yMap = d_yMap;
+            yMap.setPaintInterval( d_yMap.p1() - tile.top(),
+                d_yMap.p2() - tile.top() );
+
+            QImage image( tile.size(), d_format );
+            d_spectrogram->renderTile( xMap, yMap, image.rect(), &image );
+
+            return image;
+        }
+
+    private:
+        const QwtPlotSpectrogram *d_spectrogram;
+        QwtScaleMap d_xMap;
+        QwtScaleMap d_yMap;
+        QImage::Format d_format;
+    };
+
     PrivateData():
         data( NULL ),
-        maxRGBColorTableSize( 0 )
+        maxRGBColorTableSize( 0 ),
+        renderMode( QwtPlotSpectrogram::SynchronousRendering ),
+        contourAlgorithm( QwtPlotSpectrogram::ConrecAlgorithm ),
+        tileCache( 256 ),
+        progressivePaint( false ),
+        incompleteImage( false )
     {
         colorMap = new QwtLinearColorMap();
         displayMode = ImageMode;
@@ -60,22 +214,110 @@ public:
     }
     ~PrivateData()
     {
+        cancelJob();
+
         delete data;
         delete colorMap;
     }
 
+    bool isRendering() const
+    {
+#if !defined(QT_NO_QFUTURE)
+        return job.watcher != NULL;
+#else
+        return false;
+#endif
+    }
+
+    void cancelJob()
+    {
+#if !defined(QT_NO_QFUTURE)
+        if ( job.watcher )
+        {
+            // running tiles can't be interrupted, but
+            // all tiles, that have not been started are skipped
+
+            job.future.cancel();
+            job.future.waitForFinished();
+
+            mergeTiles();
+            finishJob();
+        }
+#endif
+    }
+
+#if !defined(QT_NO_QFUTURE)
+    void mergeTiles()
+    {
+        for ( int i = 0; i < job.tiles.size(); i++ )
+        {
+            if ( !job.merged[i] && job.future.isResultReadyAt( i ) )
+            {
+                const QRect &tile = job.tiles[i];
+                const QImage image = job.future.resultAt( i );
+
+                if ( !image.isNull() )
+                {
+                    qwtCopyTile( image, tile.topLeft(), &job.image );
+
+                    tileCache.insert(
+                        QwtTileKey( job.area, job.imageSize, tile ),
+                        new QImage( image ) );
+                }
+
+                job.merged[i] = true;
+                job.numMerged++;
+            }
+        }
+    }
+
+    void finishJob()
+    {
+        delete job.watcher;
+        job.watcher = NULL;
+
+        job.future = QFuture<QImage>();
+        job.image = QImage();
+        job.tiles.clear();
+        job.merged.clear();
+        job.numMerged = 0;
+
+        if ( data )
+            data->discardRaster();
+    }
+#endif
+
     void updateColorTable()
     {
+        /*
+            The table is built for [0.0, 1.0] and adjusted
+            to the range of the data in renderTile()
+         */
+        const QwtInterval interval( 0.0, 1.0 );
+
+        rgbTable.clear();
+
         if ( colorMap->format() == QwtColorMap::Indexed )
         {
-            colorTable = colorMap->colorTable256();
+            colorTable = colorMap->lookupTable( interval, 256 );
         }
         else
         {
             if ( maxRGBColorTableSize == 0 )
-                colorTable.clear();
+            {
+                colorTable = QwtColorLookupTable();
+            }
             else
-                colorTable = colorMap->colorTable( maxRGBColorTableSize );
+            {
+                colorTable = colorMap->lookupTable(
+                    interval, maxRGBColorTableSize );
+
+                if ( colorTable.isNull() )
+                {
+                    // mapping by QwtColorMap::colorIndex()
+                    rgbTable = colorMap->colorTable( maxRGBColorTableSize );
+                }
+            }
         }
     }
 
@@ -88,7 +330,37 @@ public:
     QwtRasterData::ConrecFlags conrecFlags;
 
     int maxRGBColorTableSize;
-    QVector<QRgb> colorTable;
+    QwtColorLookupTable colorTable;
+    QVector<QRgb> rgbTable;
+
+    QwtPlotSpectrogram::RenderMode renderMode;
+    QwtPlotSpectrogram::ContourAlgorithm contourAlgorithm;
+    QCache<QwtTileKey, QImage> tileCache;
+
+    bool progressivePaint;
+    bool incompleteImage;
+
+#if !defined(QT_NO_QFUTURE)
+    struct RenderJob
+    {
+        RenderJob():
+            numMerged( 0 ),
+            watcher( NULL )
+        {
+        }
+
+        QRectF area;
+        QSize imageSize;
+        QImage image;
+
+        QVector<QRect> tiles;
+        QVector<bool> merged;
+        int numMerged;
+
+        QFuture<QImage> future;
+        QFutureWatcher<QImage> *watcher;
+    } job;
+#endif
 };
 
 /*!
@@ -178,6 +450,8 @@ void QwtPlotSpectrogram::setColorMap( QwtColorMap *colorMap )
 
     if ( colorMap != d_data->colorMap )
     {
+        d_data->cancelJob();
+
         delete d_data->colorMap;
         d_data->colorMap = colorMap;
     }
@@ -204,6 +478,8 @@ void QwtPlotSpectrogram::setMaxRGBTableSize( int numColors )
     numColors = qMax( numColors, 0 );
     if ( numColors != d_data->maxRGBColorTableSize )
     {
+        d_data->cancelJob();
+
         d_data->maxRGBColorTableSize = numColors;
         d_data->updateColorTable();
         invalidateCache();
@@ -215,6 +491,82 @@ int QwtPlotSpectrogram::maxRGBTableSize() const
     return d_data->maxRGBColorTableSize;
 }
 
+/*!
+  \brief Set the render mode
+
+  In ProgressiveRendering mode the image is composed from tiles, that
+  are rendered in the background, while a coarse preview is displayed.
+  This mode is only used, when painting to the plot canvas.
+  Exporting the plot ( QwtPlotRenderer ) is always done synchronously.
+  For the ScrollCache policy only images, that can't be scrolled,
+  are rendered progressively. The uncovered parts of a scrolled image
+  are rendered synchronously.
+
+  \param mode Render mode
+  \sa RenderMode, renderMode(), setTileCacheSize()
+ */
+void QwtPlotSpectrogram::setRenderMode( RenderMode mode )
+{
+    if ( mode != d_data->renderMode )
+    {
+        d_data->cancelJob();
+        d_data->renderMode = mode;
+
+        invalidateCache();
+        itemChanged();
+    }
+}
+
+/*!
+  \return Render mode
+  \sa setRenderMode()
+ */
+QwtPlotSpectrogram::RenderMode QwtPlotSpectrogram::renderMode() const
+{
+    return d_data->renderMode;
+}
+
+/*!
+  \brief Set the maximum number of tiles in the tile cache
+
+  The cache is used in ProgressiveRendering mode only.
+  The default size is 256 tiles of 128x128 pixels.
+
+  \param numTiles Maximum number of tiles, 0 disables the cache
+  \sa tileCacheSize(), invalidateCache(), setRenderMode()
+ */
+void QwtPlotSpectrogram::setTileCacheSize( int numTiles )
+{
+    d_data->tileCache.setMaxCost( qMax( numTiles, 0 ) );
+}
+
+/*!
+  \return Maximum number of tiles in the tile cache
+  \sa setTileCacheSize()
+ */
+int QwtPlotSpectrogram::tileCacheSize() const
+{
+    return d_data->tileCache.maxCost();
+}
+
+/*!
+   \brief Invalidate the paint and the tile cache
+
+   Tiles that are rendered in the background are cancelled.
+   In ProgressiveRendering mode invalidateCache() needs to be called,
+   whenever the values of the raster data have been modified.
+
+   \sa QwtPlotRasterItem::invalidateCache(), setTileCacheSize()
+*/
+void QwtPlotSpectrogram::invalidateCache()
+{
+    d_data->cancelJob();
+    d_data->tileCache.clear();
+    d_data->incompleteImage = false;
+
+    QwtPlotRasterItem::invalidateCache();
+}
+
 /*! 
   Build and assign the default pen for the contour lines
     
@@ -359,6 +711,34 @@ QList<double> QwtPlotSpectrogram::contourLevels() const
     return d_data->contourLevels;
 }
 
+/*!
+   \brief Set the algorithm for calculating the contour lines
+
+   MarchingSquaresAlgorithm is significantly faster for large rasters
+   and many levels, as it is running in renderThreadCount() threads
+   and the lines are painted as polylines.
+
+   \param algorithm Contour algorithm
+   \sa ContourAlgorithm, contourAlgorithm(), setContourLevels()
+*/
+void QwtPlotSpectrogram::setContourAlgorithm( ContourAlgorithm algorithm )
+{
+    if ( algorithm != d_data->contourAlgorithm )
+    {
+        d_data->contourAlgorithm = algorithm;
+        itemChanged();
+    }
+}
+
+/*!
+   \return Algorithm for calculating the contour lines
+   \sa setContourAlgorithm()
+*/
+QwtPlotSpectrogram::ContourAlgorithm QwtPlotSpectrogram::contourAlgorithm() const
+{
+    return d_data->contourAlgorithm;
+}
+
 /*!
   Set the data to be displayed
 
@@ -369,6 +749,8 @@ void QwtPlotSpectrogram::setData( QwtRasterData *data )
 {
     if ( data != d_data->data )
     {
+        d_data->cancelJob();
+
         delete d_data->data;
         d_data->data = data;
 
@@ -449,8 +831,11 @@ QRectF QwtPlotSpectrogram::pixelHint( const QRectF &area ) const
    \return A QImage::Format_Indexed8 or QImage::Format_ARGB32 depending
            on the color map.
 
+   \note In ProgressiveRendering mode the returned image might be
+         a preview, that is refined in the following replots.
+
    \sa QwtRasterData::value(), QwtColorMap::rgb(),
-       QwtColorMap::colorIndex()
+       QwtColorMap::lookupTable(), setRenderMode()
 */
 QImage QwtPlotSpectrogram::renderImage(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -466,6 +851,19 @@ QImage QwtPlotSpectrogram::renderImage(
     if ( !intensityRange.isValid() )
         return QImage();
 
+#if !defined(QT_NO_QFUTURE)
+    /*
+      The uncovered parts of a scrolled image ( ScrollCache ) are
+      rendered synchronously: a preview of a strip would be an
+      incomplete image, that invalidates the scrolled cache.
+     */
+    if ( d_data->progressivePaint && !isScrollingCache() )
+        return renderImageProgressive( xMap, yMap, area, imageSize );
+
+    // tiles rendered in the background would interfere with initRaster()
+    d_data->cancelJob();
+#endif
+
     const QImage::Format format = ( d_data->colorMap->format() == QwtColorMap::RGB )
         ? QImage::Format_ARGB32 : QImage::Format_Indexed8;
 
@@ -526,6 +924,147 @@ QImage QwtPlotSpectrogram::renderImage(
     return image;
 }
 
+/*!
+   Render an image in ProgressiveRendering mode
+
+   On the first call for an area and image size a coarse preview
+   is rendered and the tiles, that are not in the tile cache, are
+   scheduled for being rendered in the background.
+   On following calls the completed tiles are merged into the image.
+
+   \param xMap X-Scale Map
+   \param yMap Y-Scale Map
+   \param area Requested area for the image in scale coordinates
+   \param imageSize Size of the requested image
+
+   \return Image, where the missing tiles are filled with a preview
+*/
+QImage QwtPlotSpectrogram::renderImageProgressive(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &area, const QSize &imageSize ) const
+{
+#if !defined(QT_NO_QFUTURE)
+    PrivateData::RenderJob &job = d_data->job;
+
+    if ( d_data->isRendering() )
+    {
+        if ( job.area == area && job.imageSize == imageSize )
+        {
+            d_data->mergeTiles();
+
+            const QImage image = job.image;
+            if ( job.numMerged == job.tiles.size() )
+            {
+                d_data->finishJob();
+                d_data->incompleteImage = false;
+            }
+
+            return image;
+        }
+
+        // the scales have changed, the outstanding tiles are obsolete
+        d_data->cancelJob();
+    }
+
+    const QImage::Format format = ( d_data->colorMap->format() == QwtColorMap::RGB )
+        ? QImage::Format_ARGB32 : QImage::Format_Indexed8;
+
+    QImage image( imageSize, format );
+
+    if ( d_data->colorMap->format() == QwtColorMap::Indexed )
+        image.setColorTable( d_data->colorMap->colorTable256() );
+
+    const int tileSize = 128;
+
+    QVector<QRect> tiles;
+    QVector<QRect> cachedTiles;
+
+    for ( int y = 0; y < imageSize.height(); y += tileSize )
+    {
+        for ( int x = 0; x < imageSize.width(); x += tileSize )
+        {
+            const QRect tile = QRect( x, y, tileSize, tileSize ) & image.rect();
+
+            if ( d_data->tileCache.contains( QwtTileKey( area, imageSize, tile ) ) )
+                cachedTiles += tile;
+            else
+                tiles += tile;
+        }
+    }
+
+    if ( !tiles.isEmpty() )
+    {
+        d_data->data->initRaster( area, imageSize );
+
+        // a preview in 1/8 of the resolution
+
+        const int factor = 8;
+
+        QImage coarseImage( ( imageSize.width() + factor - 1 ) / factor,
+            ( imageSize.height() + factor - 1 ) / factor, format );
+
+        QwtScaleMap xxMap = xMap;
+        xxMap.setPaintInterval( ( xMap.p1() - 0.5 * factor ) / factor,
+            ( xMap.p2() - 0.5 * factor ) / factor );
+
+        QwtScaleMap yyMap = yMap;
+        yyMap.setPaintInterval( ( yMap.p1() - 0.5 * factor ) / factor,
+            ( yMap.p2() - 0.5 * factor ) / factor );
+
+        renderTile( xxMap, yyMap, coarseImage.rect(), &coarseImage );
+        qwtScaleUp( coarseImage, factor, &image );
+    }
+
+    for ( int i = 0; i < cachedTiles.size(); i++ )
+    {
+        const QRect &tile = cachedTiles[i];
+
+        const QImage *tileImage =
+            d_data->tileCache.object( QwtTileKey( area, imageSize, tile ) );
+
+        qwtCopyTile( *tileImage, tile.topLeft(), &image );
+    }
+
+    d_data->incompleteImage = !tiles.isEmpty();
+
+    if ( tiles.isEmpty() )
+        return image;
+
+    job.area = area;
+    job.imageSize = imageSize;
+    job.image = image;
+    job.tiles = tiles;
+    job.merged.fill( false, tiles.size() );
+    job.numMerged = 0;
+
+    job.watcher = new QFutureWatcher<QImage>();
+
+    if ( plot() )
+    {
+        // the progress is reported with a limited frequency,
+        // what avoids a replot for each tile
+
+        QObject::connect( job.watcher, SIGNAL( progressValueChanged( int ) ),
+            plot(), SLOT( replot() ) );
+        QObject::connect( job.watcher, SIGNAL( finished() ),
+            plot(), SLOT( replot() ) );
+    }
+
+    job.future = QtConcurrent::mapped( tiles,
+        PrivateData::TileRenderer( this, xMap, yMap, format ) );
+    job.watcher->setFuture( job.future );
+
+    return image;
+#else
+    Q_UNUSED( xMap );
+    Q_UNUSED( yMap );
+    Q_UNUSED( area );
+    Q_UNUSED( imageSize );
+
+    return QImage();
+#endif
+}
+
 /*!
     \brief Render a tile of an image.
 
@@ -547,64 +1086,101 @@ void QwtPlotSpectrogram::renderTile(
 
     const bool hasGaps = !d_data->data->testAttribute( QwtRasterData::WithoutGaps );
 
-    if ( d_data->colorMap->format() == QwtColorMap::RGB )
+    // the x coordinates are the same for all lines of the tile
+    QVector<double> xValues( tile.width() );
+    for ( int i = 0; i < xValues.size(); i++ )
+        xValues[i] = tile.left() + i;
+
+    xMap.invTransform( xValues.constData(), xValues.data(), xValues.size() );
+
+    /*
+      The values are fetched in blocks of rows, so that the raster data
+      can do the calculations, that depend on x only, once per block.
+     */
+    const int blockSize = qMin( tile.height(), 64 );
+
+    QVector<double> yValues( blockSize );
+    QVector<double> values( blockSize * tile.width() );
+
+    QwtColorLookupTable colorTable = d_data->colorTable;
+    colorTable.setInterval( range );
+
+    const QwtColorMap *colorMap = d_data->colorMap;
+
+    const int numColors = d_data->rgbTable.size();
+    const QRgb *rgbTable = d_data->rgbTable.constData();
+
+    for ( int y0 = tile.top(); y0 <= tile.bottom(); y0 += blockSize )
     {
-        const int numColors = d_data->colorTable.size();
-        const QRgb *rgbTable = d_data->colorTable.constData();
-        const QwtColorMap *colorMap = d_data->colorMap;
+        const int numRows = qMin( blockSize, tile.bottom() - y0 + 1 );
 
-        for ( int y = tile.top(); y <= tile.bottom(); y++ )
-        {
-            const double ty = yMap.invTransform( y );
+        for ( int i = 0; i < numRows; i++ )
+            yValues[i] = yMap.invTransform( y0 + i );
 
-            QRgb *line = reinterpret_cast<QRgb *>( image->scanLine( y ) );
-            line += tile.left();
+        d_data->data->tileValues( yValues.constData(), numRows,
+            xValues.constData(), xValues.size(), values.data() );
 
-            for ( int x = tile.left(); x <= tile.right(); x++ )
-            {
-                const double tx = xMap.invTransform( x );
+        for ( int i = 0; i < numRows; i++ )
+        {
+            const int y = y0 + i;
+            const double *rowValues = values.constData() + i * tile.width();
 
-                const double value = d_data->data->value( tx, ty );
+            if ( colorMap->format() == QwtColorMap::RGB )
+            {
+                QRgb *line = reinterpret_cast<QRgb *>( image->scanLine( y ) );
+                line += tile.left();
 
-                if ( hasGaps && qwtIsNaN( value ) )
+                if ( !colorTable.isNull() )
                 {
-                    *line++ = 0u;
+                    // NaN values are mapped to 0u by the table
+                    colorTable.rgb( rowValues, line, tile.width() );
+                    continue;
                 }
-                else if ( numColors == 0 )
-                {
-                    *line++ = colorMap->rgb( range, value );
-                }
-                else
+
+                for ( int x = 0; x < tile.width(); x++ )
                 {
-                    const uint index = colorMap->colorIndex( numColors, range, value );
-                    *line++ = rgbTable[index];
+                    const double value = rowValues[x];
+
+                    if ( hasGaps && qwtIsNaN( value ) )
+                    {
+                        *line++ = 0u;
+                    }
+                    else if ( numColors == 0 )
+                    {
+                        *line++ = colorMap->rgb( range, value );
+                    }
+                    else
+                    {
+                        const uint index = colorMap->colorIndex( numColors, range, value );
+                        *line++ = rgbTable[index];
+                    }
                 }
             }
-        }
-    }
-    else if ( d_data->colorMap->format() == QwtColorMap::Indexed )
-    {
-        for ( int y = tile.top(); y <= tile.bottom(); y++ )
-        {
-            const double ty = yMap.invTransform( y );
-
-            unsigned char *line = image->scanLine( y );
-            line += tile.left();
-
-            for ( int x = tile.left(); x <= tile.right(); x++ )
+            else if ( colorMap->format() == QwtColorMap::Indexed )
             {
-                const double tx = xMap.invTransform( x );
-
-                const double value = d_data->data->value( tx, ty );
+                unsigned char *line = image->scanLine( y );
+                line += tile.left();
 
-                if ( hasGaps && qwtIsNaN( value ) )
+                if ( !colorTable.isNull() )
                 {
-                    *line++ = 0;
+                    // NaN values are mapped to 0 by the table
+                    colorTable.colorIndex( rowValues, line, tile.width() );
+                    continue;
                 }
-                else
+
+                for ( int x = 0; x < tile.width(); x++ )
                 {
-                    const uint index = d_data->colorMap->colorIndex( 256, range, value );
-                    *line++ = static_cast<unsigned char>( index );
+                    const double value = rowValues[x];
+
+                    if ( hasGaps && qwtIsNaN( value ) )
+                    {
+                        *line++ = 0;
+                    }
+                    else
+                    {
+                        const uint index = colorMap->colorIndex( 256, range, value );
+                        *line++ = static_cast<unsigned char>( index );
+                    }
                 }
             }
         }
@@ -708,6 +1284,74 @@ void QwtPlotSpectrogram::drawContourLines( QPainter *painter,
     }
 }
 
+/*!
+   Calculate contour polylines
+
+   \param rect Rectangle, where to calculate the contour lines
+   \param raster Raster, used by the marching squares algorithm
+   \return Calculated contour polylines
+
+   \sa contourLevels(), setContourAlgorithm(),
+       QwtRasterData::contourPolylines()
+*/
+QwtRasterData::ContourPolylines QwtPlotSpectrogram::renderContourPolylines(
+    const QRectF &rect, const QSize &raster ) const
+{
+    if ( d_data->data == NULL )
+        return QwtRasterData::ContourPolylines();
+
+    return d_data->data->contourPolylines( rect, raster,
+        d_data->contourLevels, d_data->conrecFlags, renderThreadCount() );
+}
+
+/*!
+   Paint the contour polylines
+
+   \param painter Painter
+   \param xMap Maps x-values into pixel coordinates.
+   \param yMap Maps y-values into pixel coordinates.
+   \param contourPolylines Contour polylines
+
+   \sa renderContourPolylines(), defaultContourPen(), contourPen()
+*/
+void QwtPlotSpectrogram::drawContourPolylines( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtRasterData::ContourPolylines &contourPolylines ) const
+{
+    if ( d_data->data == NULL )
+        return;
+
+    const int numLevels = d_data->contourLevels.size();
+    for ( int l = 0; l < numLevels; l++ )
+    {
+        const double level = d_data->contourLevels[l];
+
+        QPen pen = defaultContourPen();
+        if ( pen.style() == Qt::NoPen )
+            pen = contourPen( level );
+
+        if ( pen.style() == Qt::NoPen )
+            continue;
+
+        painter->setPen( pen );
+
+        const QVector<QPolygonF> polylines = contourPolylines[level];
+        for ( int i = 0; i < polylines.size(); i++ )
+        {
+            QPolygonF polyline = polylines[i];
+
+            QPointF *points = polyline.data();
+            for ( int j = 0; j < polyline.size(); j++ )
+            {
+                points[j].setX( xMap.transform( points[j].x() ) );
+                points[j].setY( yMap.transform( points[j].y() ) );
+            }
+
+            QwtPainter::drawPolyline( painter, polyline );
+        }
+    }
+}
+
 /*!
   \brief Draw the spectrogram
 
@@ -724,10 +1368,41 @@ void QwtPlotSpectrogram::draw( QPainter *painter,
     const QRectF &canvasRect ) const
 {
     if ( d_data->displayMode & ImageMode )
+    {
+        /*
+          Progressive rendering makes sense for the canvas only.
+          Exports ( QwtPlotRenderer, grabbing ) need the final image.
+          Contour lines are calculated from the raster data in the
+          GUI thread, what can't be done while tiles are rendered
+          in the background.
+
+          The pixmap of a cache layer is reused until the layer
+          gets invalidated, while completed tiles trigger a replot
+          only. So a preview must never end up in a cache layer.
+         */
+        d_data->progressivePaint =
+            ( d_data->renderMode == ProgressiveRendering ) && plot() &&
+            !( d_data->displayMode & ContourMode ) &&
+            ( cacheLayer() == QwtPlotItem::NoCacheLayer ) &&
+            qwtIsCanvasDevice( plot(), painter->device() );
+
+        if ( d_data->incompleteImage )
+        {
+            // the image of the paint cache is an incomplete preview
+            QwtPlotSpectrogram *that = const_cast<QwtPlotSpectrogram *>( this );
+            that->QwtPlotRasterItem::invalidateCache();
+        }
+
         QwtPlotRasterItem::draw( painter, xMap, yMap, canvasRect );
 
+        d_data->progressivePaint = false;
+    }
+
     if ( d_data->displayMode & ContourMode )
     {
+        // tiles rendered in the background would interfere with initRaster()
+        d_data->cancelJob();
+
         // Add some pixels at the borders
         const int margin = 2;
         QRectF rasterRect( canvasRect.x() - margin, canvasRect.y() - margin,
@@ -749,10 +1424,20 @@ void QwtPlotSpectrogram::draw( QPainter *painter,
         raster = raster.boundedTo( rasterRect.toRect().size() );
         if ( raster.isValid() )
         {
-            const QwtRasterData::ContourLines lines =
-                renderContourLines( area, raster );
+            if ( d_data->contourAlgorithm == MarchingSquaresAlgorithm )
+            {
+                const QwtRasterData::ContourPolylines polylines =
+                    renderContourPolylines( area, raster );
 
-            drawContourLines( painter, xMap, yMap, lines );
+                drawContourPolylines( painter, xMap, yMap, polylines );
+            }
+            else
+            {
+                const QwtRasterData::ContourLines lines =
+                    renderContourLines( area, raster );
+
+                drawContourLines( painter, xMap, yMap, lines );
+            }
         }
     }
 }
@@ -30,6 +30,11 @@ class QwtColorMap;
 
   In ContourMode contour lines are painted for the contour levels.
 
+  For huge data sets rendering the image might take too long for
+  a smooth interaction. In ProgressiveRendering mode a coarse preview
+  is displayed immediately, while the image is refined in the background
+  - see setRenderMode().
+
   \image html spectrogram3.png
 
   \sa QwtRasterData, QwtColorMap, QwtPlotItem::setRenderThreadCount()
@@ -55,6 +60,64 @@ public:
     //! Display modes
     typedef QFlags<DisplayMode> DisplayModes;
 
+    /*!
+      \brief Render mode
+      The default mode is SynchronousRendering
+      \sa setRenderMode(), renderMode()
+     */
+    enum RenderMode
+    {
+        /*!
+          renderImage() blocks until all tiles of the image
+          have been rendered.
+         */
+        SynchronousRendering,
+
+        /*!
+          When painting to the plot canvas ( or its backing store )
+          renderImage() returns a coarse preview immediately, while the tiles of the image
+          are rendered in the background. Whenever tiles have been
+          completed the plot is replotted and the tiles replace the
+          preview. When the scales change before all tiles are done
+          the outstanding tiles are cancelled.
+
+          Completed tiles are kept in a cache, so that they can
+          be reused, when the same area is displayed again in the
+          same resolution.
+
+          Exports, like QwtPlotRenderer, always get the final image.
+          In combination with ContourMode or when the spectrogram
+          is assigned to a cache layer ( QwtPlotItem::setCacheLayer() )
+          the image is rendered synchronously.
+
+          \note The tile cache needs to be invalidated, when the values
+                of the raster data have been modified
+          \sa invalidateCache(), setTileCacheSize()
+         */
+        ProgressiveRendering
+    };
+
+    /*!
+      \brief Algorithm for calculating the contour lines
+      The default algorithm is ConrecAlgorithm
+      \sa setContourAlgorithm(), contourAlgorithm()
+     */
+    enum ContourAlgorithm
+    {
+        /*!
+          CONREC, that returns unjoined lines
+          \sa QwtRasterData::contourLines()
+         */
+        ConrecAlgorithm,
+
+        /*!
+          Marching squares calculating the cells in parallel threads.
+          The lines are joined to polylines
+          \sa QwtRasterData::contourPolylines(), renderThreadCount()
+         */
+        MarchingSquaresAlgorithm
+    };
+
     explicit QwtPlotSpectrogram( const QString &title = QString::null );
     virtual ~QwtPlotSpectrogram();
 
@@ -70,6 +133,14 @@ public:
 
     void setMaxRGBTableSize( int numColors );
     int maxRGBTableSize() const;
+
+    void setRenderMode( RenderMode );
+    RenderMode renderMode() const;
+
+    void setTileCacheSize( int numTiles );
+    int tileCacheSize() const;
+
+    virtual void invalidateCache();
     
     virtual QwtInterval interval(Qt::Axis) const;
     virtual QRectF pixelHint( const QRectF & ) const;
@@ -87,6 +158,9 @@ public:
     void setContourLevels( const QList<double> & );
     QList<double> contourLevels() const;
 
+    void setContourAlgorithm( ContourAlgorithm );
+    ContourAlgorithm contourAlgorithm() const;
+
     virtual int rtti() const;
 
     virtual void draw( QPainter *p,
@@ -108,10 +182,21 @@ protected:
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtRasterData::ContourLines& lines ) const;
 
+    virtual QwtRasterData::ContourPolylines renderContourPolylines(
+        const QRectF &rect, const QSize &raster ) const;
+
+    virtual void drawContourPolylines( QPainter *p,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtRasterData::ContourPolylines& polylines ) const;
+
     void renderTile( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRect &imageRect, QImage *image ) const;
 
 private:
+    QImage renderImageProgressive(
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &area, const QSize &imageSize ) const;
+
     class PrivateData;
     PrivateData *d_data;
 };
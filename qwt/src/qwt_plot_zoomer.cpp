@@ -12,6 +12,12 @@
 #include "qwt_scale_div.h"
 #include "qwt_picker_machine.h"
 #include <qalgorithms.h>
+#include <qevent.h>
+#include <qimage.h>
+#include <qpainter.h>
+
+// idle time in ms, before the previous zoom rectangle gets prerendered
+static const int qwtPrerenderDelay = 500;
 
 static QwtInterval qwtExpandedZoomInterval( double v1, double v2, 
     double minRange, const QwtTransform* transform )
@@ -75,13 +81,103 @@ static QRectF qwtExpandedZoomRect( const QRectF &zoomRect, const QSizeF &minSize
     return r;
 }
 
+class QwtPlotZoomerImage
+{
+public:
+    QwtPlotZoomerImage():
+        revision( 0 )
+    {
+    }
+
+    QRectF zoomRect;
+    QRectF canvasRect;
+    uint revision;
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    QImage image;
+};
+
+static void qwtRenderZoomerImage( const QwtPlot *plot,
+    QwtPlotZoomerImage *zoomerImage, qreal pixelRatio )
+{
+    const QRectF &canvasRect = zoomerImage->canvasRect;
+    const QSize size = canvasRect.size().toSize();
+
+    QImage image( size * pixelRatio, QImage::Format_ARGB32_Premultiplied );
+#if QT_VERSION >= 0x050100
+    image.setDevicePixelRatio( pixelRatio );
+#else
+    Q_UNUSED( pixelRatio )
+#endif
+    image.fill( Qt::transparent );
+
+    QPainter painter( &image );
+    painter.translate( -canvasRect.topLeft() );
+
+    plot->drawItems( &painter, canvasRect, zoomerImage->maps );
+    painter.end();
+
+    zoomerImage->image = image;
+}
+
 class QwtPlotZoomer::PrivateData
 {
 public:
+    PrivateData():
+        imageCacheSize( 0 ),
+        prerenderTimerId( 0 )
+    {
+    }
+
+    int indexOf( const QRectF &zoomRect,
+        const QRectF &canvasRect, uint revision ) const
+    {
+        for ( int i = 0; i < images.size(); i++ )
+        {
+            const QwtPlotZoomerImage &image = images[i];
+            if ( image.zoomRect == zoomRect &&
+                image.canvasRect == canvasRect && image.revision == revision )
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    void insertImage( const QwtPlotZoomerImage &image )
+    {
+        const int index = indexOf( image.zoomRect,
+            image.canvasRect, image.revision );
+
+        if ( index >= 0 )
+            images.removeAt( index );
+
+        // the most recently used image is at the front
+        images.prepend( image );
+
+        while ( images.size() > imageCacheSize )
+            images.removeLast();
+    }
+
+    void removeOutdatedImages( uint revision )
+    {
+        for ( int i = images.size() - 1; i >= 0; i-- )
+        {
+            if ( images[i].revision != revision )
+                images.removeAt( i );
+        }
+    }
+
     uint zoomRectIndex;
     QStack<QRectF> zoomStack;
 
     int maxStackDepth;
+
+    int imageCacheSize;
+    QList<QwtPlotZoomerImage> images;
+
+    int prerenderTimerId;
 };
 
 /*!
@@ -294,6 +390,61 @@ uint QwtPlotZoomer::zoomRectIndex() const
     return d_data->zoomRectIndex;
 }
 
+/*!
+  \brief Set the number of images in the image cache
+
+  The image cache stores the rendered plot items for the most
+  recently displayed zoom rectangles. Navigating back to one of
+  them displays the image instead of rendering the items again.
+  In addition the image for the previous rectangle of the zoom stack
+  is prerendered, when the GUI has been idle for a moment after zooming in.
+  Mouse, wheel or key events on the canvas postpone prerendering. As the
+  items are rendered in the GUI thread, the application doesn't respond
+  to user input, until the image is complete.
+
+  Only the replot, that is initiated by rescale(), is affected: its
+  items are rendered into an image, that is stored in the cache when
+  zooming to another rectangle. Any other replot discards this image,
+  so that plots, that are updated permanently, don't fill the cache.
+
+  The images are valid as long as the size of the canvas and the
+  plot items do not change ( QwtPlot::itemRevision() ). Changes of the
+  samples without calling QwtPlotItem::itemChanged() can't be
+  detected.
+
+  \param numImages Maximum number of images. 0 disables the cache.
+                   The default setting is 0.
+
+  \sa imageCacheSize(), QwtPlot::itemRevision()
+  \note Each image has the size of the canvas
+*/
+void QwtPlotZoomer::setImageCacheSize( int numImages )
+{
+    numImages = qMax( numImages, 0 );
+
+    d_data->imageCacheSize = numImages;
+    while ( d_data->images.size() > numImages )
+        d_data->images.removeLast();
+
+    if ( numImages == 0 )
+    {
+        cancelPrerendering();
+
+        QwtPlot *plt = plot();
+        if ( plt )
+            plt->retainCanvasImage( false );
+    }
+}
+
+/*!
+  \return Maximum number of images in the image cache
+  \sa setImageCacheSize()
+*/
+int QwtPlotZoomer::imageCacheSize() const
+{
+    return d_data->imageCacheSize;
+}
+
 /*!
   \brief Zoom in
 
@@ -415,6 +566,27 @@ void QwtPlotZoomer::rescale()
     const QRectF &rect = d_data->zoomStack[d_data->zoomRectIndex];
     if ( rect != scaleRect() )
     {
+        if ( d_data->imageCacheSize > 0 )
+        {
+            storeCanvasImage();
+
+            const int index = d_data->indexOf( rect,
+                canvas()->contentsRect(), plt->itemRevision() );
+
+            if ( index >= 0 )
+            {
+                d_data->images.move( index, 0 );
+
+                const QwtPlotZoomerImage &image = d_data->images[0];
+                plt->setCanvasImage( image.image, image.maps );
+            }
+
+            // the following replot paints the cached image
+            // or renders the items into a new one
+
+            plt->retainCanvasImage( true );
+        }
+
         const bool doReplot = plt->autoReplot();
         plt->setAutoReplot( false );
 
@@ -435,9 +607,173 @@ void QwtPlotZoomer::rescale()
         plt->setAutoReplot( doReplot );
 
         plt->replot();
+
+        cancelPrerendering();
+
+        if ( d_data->imageCacheSize > 0 && d_data->zoomRectIndex > 0 )
+        {
+            // prerendering, when the GUI is idle
+            d_data->prerenderTimerId = startTimer( qwtPrerenderDelay );
+        }
     }
 }
 
+/*!
+  Move the image of the plot items, that has been rendered
+  for the current scales, into the image cache.
+*/
+void QwtPlotZoomer::storeCanvasImage()
+{
+    const QwtPlot *plt = plot();
+    if ( plt == NULL )
+        return;
+
+    d_data->removeOutdatedImages( plt->itemRevision() );
+
+    QwtPlotZoomerImage image;
+    image.image = plt->canvasImage( image.maps );
+
+    if ( image.image.isNull() )
+        return;
+
+    const QwtScaleMap &xMap = image.maps[xAxis()];
+    const QwtScaleMap &yMap = image.maps[yAxis()];
+
+    image.zoomRect = QRectF( QPointF( xMap.s1(), yMap.s1() ),
+        QPointF( xMap.s2(), yMap.s2() ) ).normalized();
+    image.canvasRect = canvas()->contentsRect();
+    image.revision = plt->itemRevision();
+
+    d_data->insertImage( image );
+}
+
+//! Stop a pending prerendering
+void QwtPlotZoomer::cancelPrerendering()
+{
+    if ( d_data->prerenderTimerId != 0 )
+    {
+        killTimer( d_data->prerenderTimerId );
+        d_data->prerenderTimerId = 0;
+    }
+}
+
+/*!
+  \brief Event filter
+
+  User input on the canvas postpones a pending prerendering
+  of the previous zoom rectangle.
+
+  \param object Object to be filtered
+  \param event Event
+
+  \return See QwtPicker::eventFilter()
+  \sa setImageCacheSize()
+*/
+bool QwtPlotZoomer::eventFilter( QObject *object, QEvent *event )
+{
+    if ( d_data->prerenderTimerId != 0 && object == parentWidget() )
+    {
+        switch ( event->type() )
+        {
+            case QEvent::MouseButtonPress:
+            case QEvent::MouseButtonRelease:
+            case QEvent::MouseButtonDblClick:
+            case QEvent::MouseMove:
+            case QEvent::Wheel:
+            case QEvent::KeyPress:
+            case QEvent::KeyRelease:
+            {
+                killTimer( d_data->prerenderTimerId );
+                d_data->prerenderTimerId = startTimer( qwtPrerenderDelay );
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    return QwtPlotPicker::eventFilter( object, event );
+}
+
+/*!
+  \brief Qt timer event
+
+  Prerendering of the previous zoom rectangle is started,
+  when the GUI has been idle for a moment.
+
+  \param event Timer event
+  \sa setImageCacheSize()
+*/
+void QwtPlotZoomer::timerEvent( QTimerEvent *event )
+{
+    if ( event->timerId() != d_data->prerenderTimerId )
+    {
+        QwtPlotPicker::timerEvent( event );
+        return;
+    }
+
+    cancelPrerendering();
+    prerender();
+}
+
+/*!
+  Render the image for the previous rectangle on the zoom stack,
+  when it is not in the image cache.
+
+  The image is rendered in the GUI thread, as the plot items might
+  be modified or deleted at any time.
+
+  \sa setImageCacheSize()
+*/
+void QwtPlotZoomer::prerender()
+{
+    const QwtPlot *plt = plot();
+    if ( plt == NULL || d_data->imageCacheSize <= 0 ||
+        d_data->zoomRectIndex == 0 )
+    {
+        return;
+    }
+
+    const QRectF &rect = d_data->zoomStack[d_data->zoomRectIndex - 1];
+    const QRectF canvasRect = canvas()->contentsRect();
+
+    if ( d_data->indexOf( rect, canvasRect, plt->itemRevision() ) >= 0 )
+        return;
+
+    QwtPlotZoomerImage image;
+
+    image.zoomRect = rect;
+    image.canvasRect = canvasRect;
+    image.revision = plt->itemRevision();
+
+    // the maps as they would be set by rescale()
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        image.maps[axisId] = plt->canvasMap( axisId );
+
+    double x1 = rect.left();
+    double x2 = rect.right();
+    if ( !plt->axisScaleDiv( xAxis() ).isIncreasing() )
+        qSwap( x1, x2 );
+
+    image.maps[xAxis()].setScaleInterval( x1, x2 );
+
+    double y1 = rect.top();
+    double y2 = rect.bottom();
+    if ( !plt->axisScaleDiv( yAxis() ).isIncreasing() )
+        qSwap( y1, y2 );
+
+    image.maps[yAxis()].setScaleInterval( y1, y2 );
+
+    qreal pixelRatio = 1.0;
+#if QT_VERSION >= 0x050100
+    pixelRatio = canvas()->devicePixelRatio();
+#endif
+
+    qwtRenderZoomerImage( plt, &image, pixelRatio );
+    d_data->insertImage( image );
+}
+
 /*!
   Reinitialize the axes, and set the zoom base to their scales.
 
@@ -68,6 +68,14 @@
   allowed to attach a second QwtPlotZoomer ( without rubber band and tracker )
   for the other axes.
 
+  When an image cache has been enabled by setImageCacheSize(), the
+  rendered plot items are kept for the most recently displayed zoom
+  rectangles. Navigating back to one of them - f.e. by zoom( -1 ) -
+  displays the image instead of rendering the items again. While
+  a zoomed rectangle is displayed, the image for the previous rectangle
+  on the zoom stack is prerendered in advance, when there was no user
+  input on the canvas for a moment.
+
   \note The realtime example includes an derived zoomer class that adds
         scrollbars to the plot canvas.
 
@@ -101,6 +109,11 @@ public:
 
     uint zoomRectIndex() const;
 
+    void setImageCacheSize( int numImages );
+    int imageCacheSize() const;
+
+    virtual bool eventFilter( QObject *, QEvent * );
+
 public Q_SLOTS:
     void moveBy( double x, double y );
     virtual void moveTo( const QPointF & );
@@ -130,8 +143,14 @@ protected:
     virtual bool end( bool ok = true );
     virtual bool accept( QPolygon & ) const;
 
+    virtual void timerEvent( QTimerEvent * );
+
 private:
     void init( bool doReplot );
+    void storeCanvasImage();
+
+    void prerender();
+    void cancelPrerendering();
 
     class PrivateData;
     PrivateData *d_data;
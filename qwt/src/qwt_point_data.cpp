@@ -9,6 +9,7 @@
 
 #include "qwt_point_data.h"
 #include "qwt_math.h"
+#include <qatomic.h>
 #include <string.h>
 
 /*!
@@ -77,6 +78,18 @@ QPointF QwtPointArrayData::sample( size_t index ) const
     return QPointF( d_x[int( index )], d_y[int( index )] );
 }
 
+/*!
+  \brief Expose the x and y arrays as span
+
+  \param span Span, that is assigned
+  \return true
+*/
+bool QwtPointArrayData::pointSpan( QwtPointSpan &span ) const
+{
+    span = QwtPointSpan( d_x.constData(), d_y.constData(), size() );
+    return true;
+}
+
 //! \return Array of the x-values
 const QVector<double> &QwtPointArrayData::xData() const
 {
@@ -143,6 +156,18 @@ QPointF QwtCPointerData::sample( size_t index ) const
     return QPointF( d_x[int( index )], d_y[int( index )] );
 }
 
+/*!
+  \brief Expose the memory blocks as span
+
+  \param span Span, that is assigned
+  \return true
+*/
+bool QwtCPointerData::pointSpan( QwtPointSpan &span ) const
+{
+    span = QwtPointSpan( d_x, d_y, d_size );
+    return true;
+}
+
 //! \return Array of the x-values
 const double *QwtCPointerData::xData() const
 {
@@ -305,3 +330,855 @@ double QwtSyntheticPointData::x( uint index ) const
     const double dx = interval.width() / ( d_size - 1 );
     return interval.minValue() + index * dx;
 }
+
+static inline int qwtBucketSize( int level )
+{
+    return 8 << level;
+}
+
+class QwtLevelOfDetailData::PrivateData
+{
+public:
+    class Bucket
+    {
+    public:
+        int minIndex;
+        int maxIndex;
+
+        double minValue;
+        double maxValue;
+    };
+
+    PrivateData():
+        series( NULL ),
+        resolution( 4096 ),
+        numSamples( 0 ),
+        level( -1 ),
+        from( 0 ),
+        to( -1 )
+    {
+    }
+
+    QwtSeriesData<QPointF> *series;
+    int resolution;
+
+    // the pyramid
+    int numSamples;
+    QVector< QVector<Bucket> > levels;
+
+    QRectF rectOfInterest;
+
+    // the selected samples
+    int level;
+    int from;
+    int to;
+    QVector<int> indices;
+};
+
+/*!
+  Constructor
+
+  \param series Series with increasing x coordinates
+  \warning The decorator takes ownership of the series
+*/
+QwtLevelOfDetailData::QwtLevelOfDetailData( QwtSeriesData<QPointF> *series )
+{
+    d_data = new PrivateData();
+    d_data->series = series;
+
+    rebuildLevels();
+}
+
+//! Destructor
+QwtLevelOfDetailData::~QwtLevelOfDetailData()
+{
+    delete d_data->series;
+    delete d_data;
+}
+
+//! \return Decorated series
+QwtSeriesData<QPointF> *QwtLevelOfDetailData::series()
+{
+    return d_data->series;
+}
+
+//! \return Decorated series
+const QwtSeriesData<QPointF> *QwtLevelOfDetailData::series() const
+{
+    return d_data->series;
+}
+
+/*!
+  \brief Set the resolution
+
+  The resolution is the number of units ( usually pixels ), that the
+  rectangle of interest is divided into. For each unit the first, 
+  the minimum, the maximum and the last sample is selected.
+
+  The resolution should not be smaller than the width of the canvas.
+  The default setting is 4096.
+
+  \param resolution Resolution
+  \sa resolution(), setRectOfInterest()
+*/
+void QwtLevelOfDetailData::setResolution( int resolution )
+{
+    resolution = qMax( resolution, 1 );
+    if ( resolution != d_data->resolution )
+    {
+        d_data->resolution = resolution;
+        updateSelection();
+    }
+}
+
+/*!
+  \return Resolution
+  \sa setResolution()
+*/
+int QwtLevelOfDetailData::resolution() const
+{
+    return d_data->resolution;
+}
+
+/*!
+  \brief Integrate appended samples into the pyramid
+
+  Only the buckets from the last incomplete bucket on need to be
+  calculated, so the costs are proportional to the number
+  of appended samples. When the series has been shrinked
+  the pyramid is rebuilt.
+
+  \sa rebuildLevels()
+*/
+void QwtLevelOfDetailData::updateLevels()
+{
+    typedef PrivateData::Bucket Bucket;
+
+    const int numSamples = static_cast<int>( d_data->series->size() );
+
+    if ( numSamples < d_data->numSamples )
+    {
+        d_data->levels.clear();
+        d_data->numSamples = 0;
+    }
+
+    if ( numSamples > d_data->numSamples )
+    {
+        const QwtSeriesData<QPointF> *series = d_data->series;
+
+        QwtPointSpan span;
+        const bool hasSpan = series->pointSpan( span ) && !span.isNull()
+            && span.size() >= static_cast<size_t>( numSamples );
+
+        // the buckets including the first appended sample
+        // might have been incomplete
+
+        const int index0 = d_data->numSamples;
+
+        for ( int level = 0; ; level++ )
+        {
+            const int bucketSize = qwtBucketSize( level );
+            const int numBuckets = ( numSamples + bucketSize - 1 ) / bucketSize;
+
+            if ( level >= d_data->levels.size() )
+                d_data->levels += QVector<Bucket>();
+
+            QVector<Bucket> &buckets = d_data->levels[level];
+            buckets.resize( numBuckets );
+
+            for ( int j = index0 / bucketSize; j < numBuckets; j++ )
+            {
+                Bucket &bucket = buckets[j];
+
+                if ( level == 0 )
+                {
+                    const int i0 = j * bucketSize;
+                    const int i1 = qMin( i0 + bucketSize, numSamples );
+
+                    for ( int i = i0; i < i1; i++ )
+                    {
+                        const double y = hasSpan ? span.y( i ) : series->sample( i ).y();
+
+                        if ( i == i0 || y < bucket.minValue )
+                        {
+                            bucket.minIndex = i;
+                            bucket.minValue = y;
+                        }
+
+                        if ( i == i0 || y > bucket.maxValue )
+                        {
+                            bucket.maxIndex = i;
+                            bucket.maxValue = y;
+                        }
+                    }
+                }
+                else
+                {
+                    const QVector<Bucket> &children = d_data->levels[level - 1];
+
+                    bucket = children[2 * j];
+
+                    if ( 2 * j + 1 < children.size() )
+                    {
+                        const Bucket &child = children[2 * j + 1];
+
+                        if ( child.minValue < bucket.minValue )
+                        {
+                            bucket.minIndex = child.minIndex;
+                            bucket.minValue = child.minValue;
+                        }
+
+                        if ( child.maxValue > bucket.maxValue )
+                        {
+                            bucket.maxIndex = child.maxIndex;
+                            bucket.maxValue = child.maxValue;
+                        }
+                    }
+                }
+            }
+
+            if ( numBuckets <= 1 )
+                break;
+        }
+
+        d_data->numSamples = numSamples;
+    }
+
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    updateSelection();
+}
+
+/*!
+  \brief Rebuild the pyramid from scratch
+
+  Needs to be called, when samples of the series have been modified.
+  \sa updateLevels()
+*/
+void QwtLevelOfDetailData::rebuildLevels()
+{
+    d_data->levels.clear();
+    d_data->numSamples = 0;
+
+    updateLevels();
+}
+
+/*!
+  \return Number of levels of the pyramid
+  \sa level()
+*/
+int QwtLevelOfDetailData::levelCount() const
+{
+    return d_data->levels.size();
+}
+
+/*!
+  \return Level, that has been selected for the rectangle of interest,
+          or -1, when the samples are not aggregated
+  \sa levelCount(), setRectOfInterest(), resolution()
+*/
+int QwtLevelOfDetailData::level() const
+{
+    return d_data->level;
+}
+
+//! \return Number of selected samples
+size_t QwtLevelOfDetailData::size() const
+{
+    if ( d_data->level < 0 )
+        return qMax( d_data->to - d_data->from + 1, 0 );
+
+    return d_data->indices.size();
+}
+
+/*!
+  Return a selected sample
+
+  \param index Index
+  \return Sample at position index of the selection
+*/
+QPointF QwtLevelOfDetailData::sample( size_t index ) const
+{
+    const int i = static_cast<int>( index );
+
+    if ( d_data->level < 0 )
+        return d_data->series->sample( d_data->from + i );
+
+    return d_data->series->sample( d_data->indices[i] );
+}
+
+/*!
+  \brief Calculate the bounding rectangle
+
+  The bounding rectangle is calculated from the first and last
+  sample and the top level of the pyramid.
+
+  \return Bounding rectangle of the complete series
+*/
+QRectF QwtLevelOfDetailData::boundingRect() const
+{
+    if ( d_boundingRect.width() < 0.0 )
+    {
+        if ( d_data->levels.isEmpty() )
+            return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+        const QVector<PrivateData::Bucket> &buckets = d_data->levels.last();
+
+        double yMin = buckets[0].minValue;
+        double yMax = buckets[0].maxValue;
+
+        for ( int i = 1; i < buckets.size(); i++ )
+        {
+            yMin = qMin( yMin, buckets[i].minValue );
+            yMax = qMax( yMax, buckets[i].maxValue );
+        }
+
+        const double x1 = d_data->series->sample( 0 ).x();
+        const double x2 = d_data->series->sample( d_data->numSamples - 1 ).x();
+
+        d_boundingRect = QRectF( x1, yMin, x2 - x1, yMax - yMin );
+    }
+
+    return d_boundingRect;
+}
+
+/*!
+  \brief Set the "rectangle of interest"
+
+  The samples inside the x interval of the rectangle are selected
+  according to the resolution. An invalid rectangle selects
+  the complete series.
+
+  \param rect Rectangle of interest
+  \sa rectOfInterest(), setResolution()
+*/
+void QwtLevelOfDetailData::setRectOfInterest( const QRectF &rect )
+{
+    d_data->rectOfInterest = rect.normalized();
+    d_data->series->setRectOfInterest( rect );
+
+    updateSelection();
+}
+
+/*!
+  \return "rectangle of interest"
+  \sa setRectOfInterest()
+*/
+QRectF QwtLevelOfDetailData::rectOfInterest() const
+{
+    return d_data->rectOfInterest;
+}
+
+void QwtLevelOfDetailData::updateSelection()
+{
+    typedef PrivateData::Bucket Bucket;
+
+    const int numSamples = d_data->numSamples;
+
+    d_data->indices.clear();
+    d_data->level = -1;
+    d_data->from = 0;
+    d_data->to = numSamples - 1;
+
+    if ( numSamples <= 0 )
+        return;
+
+    const QRectF &rect = d_data->rectOfInterest;
+    if ( rect.width() > 0.0 )
+    {
+        // the visible range including one sample on each side
+
+        int from = qwtUpperSampleIndex<QPointF>( 
+            *d_data->series, rect.left(), QwtLessThanX() );
+
+        if ( from < 0 || from >= numSamples )
+            from = numSamples - 1;
+
+        int to = qwtUpperSampleIndex<QPointF>( 
+            *d_data->series, rect.right(), QwtLessThanX() );
+
+        if ( to < 0 || to >= numSamples )
+            to = numSamples - 1;
+
+        d_data->from = qMax( from - 1, 0 );
+        d_data->to = to;
+    }
+
+    const int count = d_data->to - d_data->from + 1;
+
+    int level = d_data->levels.size() - 1;
+    while ( level >= 0 && 
+        static_cast<qint64>( qwtBucketSize( level ) ) * d_data->resolution > count )
+    {
+        level--;
+    }
+
+    if ( level < 0 )
+        return;
+
+    // first, minimum, maximum and last sample of each bucket
+
+    const int bucketSize = qwtBucketSize( level );
+    const QVector<Bucket> &buckets = d_data->levels[level];
+
+    const int j1 = d_data->from / bucketSize;
+    const int j2 = d_data->to / bucketSize;
+
+    d_data->indices.reserve( 4 * ( j2 - j1 + 1 ) );
+
+    for ( int j = j1; j <= j2; j++ )
+    {
+        const int first = j * bucketSize;
+        const int last = qMin( first + bucketSize, numSamples ) - 1;
+
+        const Bucket &bucket = buckets[j];
+        const int i1 = qMin( bucket.minIndex, bucket.maxIndex );
+        const int i2 = qMax( bucket.minIndex, bucket.maxIndex );
+
+        d_data->indices += first;
+
+        if ( i1 != first )
+            d_data->indices += i1;
+
+        if ( i2 != i1 )
+            d_data->indices += i2;
+
+        if ( last != i2 )
+            d_data->indices += last;
+    }
+
+    d_data->level = level;
+}
+
+static inline uint qwtLoadAcquire( const QAtomicInt &value )
+{
+#if QT_VERSION >= 0x050000
+    return static_cast<uint>( value.loadAcquire() );
+#else
+    return static_cast<uint>(
+        const_cast<QAtomicInt &>( value ).fetchAndAddAcquire( 0 ) );
+#endif
+}
+
+static inline void qwtStoreRelease( QAtomicInt &value, uint v )
+{
+#if QT_VERSION >= 0x050000
+    value.storeRelease( static_cast<int>( v ) );
+#else
+    value.fetchAndStoreRelease( static_cast<int>( v ) );
+#endif
+}
+
+class QwtRingBufferPointData::PrivateData
+{
+public:
+    class Bounds
+    {
+    public:
+        Bounds():
+            minX( 0.0 ),
+            maxX( -1.0 ),
+            minY( 0.0 ),
+            maxY( -1.0 ),
+            isNull( true )
+        {
+        }
+
+        inline void extend( const double *xData, const double *yData,
+            quint64 from, quint64 to, uint mask )
+        {
+            for ( quint64 i = from; i < to; i++ )
+            {
+                const uint index = static_cast<uint>( i ) & mask;
+
+                const double x = xData[ index ];
+                const double y = yData[ index ];
+
+                if ( isNull )
+                {
+                    minX = maxX = x;
+                    minY = maxY = y;
+                    isNull = false;
+                }
+                else
+                {
+                    if ( x < minX )
+                        minX = x;
+                    if ( x > maxX )
+                        maxX = x;
+                    if ( y < minY )
+                        minY = y;
+                    if ( y > maxY )
+                        maxY = y;
+                }
+            }
+        }
+
+        inline void extend( const Bounds &other )
+        {
+            if ( other.isNull )
+                return;
+
+            if ( isNull )
+            {
+                *this = other;
+                return;
+            }
+
+            minX = qMin( minX, other.minX );
+            maxX = qMax( maxX, other.maxX );
+            minY = qMin( minY, other.minY );
+            maxY = qMax( maxY, other.maxY );
+        }
+
+        double minX;
+        double maxX;
+        double minY;
+        double maxY;
+
+        bool isNull;
+    };
+
+    PrivateData():
+        capacity( 0 ),
+        mask( 0 ),
+        blockSize( 1 ),
+        producerHead( 0 ),
+        from( 0 ),
+        to( 0 ),
+        numBlocks( 0 )
+    {
+    }
+
+    void reset( int cap )
+    {
+        // a buffer of 2^30 points is the largest size, that
+        // can be indexed by int ( QVector )
+
+        capacity = qBound( 1, cap, 1 << 29 );
+
+        // the producer may write up to one capacity ahead of
+        // the snapshot: the size is a power of 2 >= 2 * capacity,
+        // so that the indices can wrap around at 2^32
+
+        uint bufferSize = 2;
+        while ( bufferSize < 2 * static_cast<uint>( capacity ) )
+            bufferSize *= 2;
+
+        mask = bufferSize - 1;
+
+        blockSize = qMin( bufferSize, 1024u );
+        blocks.fill( Bounds(), static_cast<int>( bufferSize / blockSize ) );
+
+        xData.fill( 0.0, static_cast<int>( bufferSize ) );
+        yData.fill( 0.0, static_cast<int>( bufferSize ) );
+
+        producerHead = 0;
+        qwtStoreRelease( head, 0 );
+        qwtStoreRelease( first, 0 );
+
+        from = to = 0;
+        numBlocks = 0;
+    }
+
+    // fixed settings
+    int capacity;
+    uint mask;
+    uint blockSize;
+
+    QVector<double> xData;
+    QVector<double> yData;
+
+    // producer
+    uint producerHead;
+
+    // shared: head is written by the producer, first by the consumer
+    QAtomicInt head;
+    QAtomicInt first;
+
+    // painting thread: the snapshot is [ from, to [
+    quint64 from;
+    quint64 to;
+
+    // bounds of the complete blocks < numBlocks
+    QVector<Bounds> blocks;
+    quint64 numBlocks;
+};
+
+/*!
+  Constructor
+
+  \param capacity Maximum number of points in a snapshot
+  \sa setCapacity()
+ */
+QwtRingBufferPointData::QwtRingBufferPointData( int capacity )
+{
+    d_data = new PrivateData();
+    d_data->reset( capacity );
+}
+
+//! Destructor
+QwtRingBufferPointData::~QwtRingBufferPointData()
+{
+    delete d_data;
+}
+
+/*!
+  \brief Set the capacity
+
+  The capacity is the maximum number of points in a snapshot.
+  All points are removed from the buffer.
+
+  \param capacity Capacity, that is bounded to [1, 2^29]
+  \sa capacity()
+
+  \warning setCapacity() must not be called, while a producer
+           is appending points
+ */
+void QwtRingBufferPointData::setCapacity( int capacity )
+{
+    d_data->reset( capacity );
+    d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+}
+
+/*!
+  \return Maximum number of points in a snapshot
+  \sa setCapacity()
+ */
+int QwtRingBufferPointData::capacity() const
+{
+    return d_data->capacity;
+}
+
+/*!
+  \brief Append a point
+
+  This method is called from the producer thread. It never waits
+  for the painting thread.
+
+  \param x X coordinate
+  \param y Y coordinate
+
+  \return false, when the producer is too far ahead of the last
+          snapshot, and the point has been dropped
+ */
+bool QwtRingBufferPointData::append( double x, double y )
+{
+    const QPointF point( x, y );
+    return append( &point, 1 ) == 1;
+}
+
+/*!
+  \brief Append a point
+
+  This method is called from the producer thread. It never waits
+  for the painting thread.
+
+  \param point Point
+  \return false, when the producer is too far ahead of the last
+          snapshot, and the point has been dropped
+ */
+bool QwtRingBufferPointData::append( const QPointF &point )
+{
+    return append( &point, 1 ) == 1;
+}
+
+/*!
+  \brief Append an array of points
+
+  This method is called from the producer thread. It never waits
+  for the painting thread. The points are published with one
+  atomic operation.
+
+  \param points Array of points
+  \param numPoints Number of points
+
+  \return Number of points, that have been appended. It is less
+          than numPoints, when the producer is too far ahead of the last
+          snapshot, and the remaining points have been dropped
+ */
+int QwtRingBufferPointData::append( const QPointF *points, int numPoints )
+{
+    PrivateData *d = d_data;
+
+    const uint head = d->producerHead;
+    const uint first = qwtLoadAcquire( d->first );
+
+    const uint bufferSize = d->mask + 1;
+
+    // slots in front of the snapshot of the painting thread
+    const uint numFree = bufferSize - ( head - first );
+
+    const int n = static_cast<int>(
+        qMin( static_cast<uint>( qMax( numPoints, 0 ) ), numFree ) );
+
+    double *xData = d->xData.data();
+    double *yData = d->yData.data();
+
+    for ( int i = 0; i < n; i++ )
+    {
+        const uint index = ( head + i ) & d->mask;
+
+        xData[ index ] = points[i].x();
+        yData[ index ] = points[i].y();
+    }
+
+    if ( n > 0 )
+    {
+        d->producerHead = head + n;
+        qwtStoreRelease( d->head, d->producerHead );
+    }
+
+    return n;
+}
+
+/*!
+  \brief Take a snapshot of the most recent points
+
+  The snapshot contains the most recent capacity() points and
+  remains unchanged until the next call of updateSnapshot().
+  It has to be called from the painting thread before replotting.
+
+  \sa clear(), size(), sample(), boundingRect()
+ */
+void QwtRingBufferPointData::updateSnapshot()
+{
+    PrivateData *d = d_data;
+
+    const uint head = qwtLoadAcquire( d->head );
+
+    // 64 bit counters for the painting thread
+    d->to += static_cast<uint>( head - static_cast<uint>( d->to ) );
+
+    if ( d->to - d->from > static_cast<quint64>( d->capacity ) )
+        d->from = d->to - d->capacity;
+
+    // releasing the slots in front of the snapshot for the producer
+    qwtStoreRelease( d->first, static_cast<uint>( d->from ) );
+
+    const double *xData = d->xData.constData();
+    const double *yData = d->yData.constData();
+
+    const quint64 blockSize = d->blockSize;
+    const quint64 numBlocks = d->blocks.size();
+
+    // the complete blocks inside of the snapshot
+
+    const quint64 block1 = ( d->from + blockSize - 1 ) / blockSize;
+    const quint64 block2 = d->to / blockSize;
+
+    // bounding rectangles of blocks, that have been completed
+    // since the last snapshot
+
+    for ( quint64 b = qMax( block1, d->numBlocks ); b < block2; b++ )
+    {
+        PrivateData::Bounds bounds;
+        bounds.extend( xData, yData, b * blockSize,
+            ( b + 1 ) * blockSize, d->mask );
+
+        d->blocks[ b % numBlocks ] = bounds;
+    }
+
+    d->numBlocks = qMax( d->numBlocks, block2 );
+
+    PrivateData::Bounds bounds;
+
+    if ( block1 >= block2 )
+    {
+        bounds.extend( xData, yData, d->from, d->to, d->mask );
+    }
+    else
+    {
+        for ( quint64 b = block1; b < block2; b++ )
+            bounds.extend( d->blocks[ b % numBlocks ] );
+
+        bounds.extend( xData, yData, d->from,
+            block1 * blockSize, d->mask );
+
+        bounds.extend( xData, yData, block2 * blockSize,
+            d->to, d->mask );
+    }
+
+    if ( bounds.isNull )
+    {
+        d_boundingRect = QRectF( 1.0, 1.0, -2.0, -2.0 );
+    }
+    else
+    {
+        d_boundingRect.setCoords( bounds.minX, bounds.minY,
+            bounds.maxX, bounds.maxY );
+    }
+}
+
+/*!
+  \brief Remove all points from the snapshot
+
+  All points, that have been appended so far, are discarded. clear()
+  is called from the painting thread and can be used, while
+  the producer is running.
+
+  \sa updateSnapshot()
+ */
+void QwtRingBufferPointData::clear()
+{
+    PrivateData *d = d_data;
+
+    const uint head = qwtLoadAcquire( d->head );
+    d->to += static_cast<uint>( head - static_cast<uint>( d->to ) );
+    d->from = d->to;
+
+    qwtStoreRelease( d->first, static_cast<uint>( d->from ) );
+
+    d_boundingRect = QRectF( 1.0, 1.0, -2.0, -2.0 );
+}
+
+/*!
+  \return Number of points in the snapshot
+  \sa updateSnapshot()
+ */
+size_t QwtRingBufferPointData::size() const
+{
+    return static_cast<size_t>( d_data->to - d_data->from );
+}
+
+/*!
+  \param index Index
+  \return Point of the snapshot at index
+  \sa updateSnapshot()
+ */
+QPointF QwtRingBufferPointData::sample( size_t index ) const
+{
+    const uint i = static_cast<uint>( d_data->from + index ) & d_data->mask;
+    return QPointF( d_data->xData[i], d_data->yData[i] );
+}
+
+/*!
+  \return Bounding rectangle of the snapshot
+  \sa updateSnapshot()
+ */
+QRectF QwtRingBufferPointData::boundingRect() const
+{
+    return d_boundingRect;
+}
+
+/*!
+  \brief Direct access to the points of the snapshot
+
+  The points are available as span, as long as the snapshot
+  does not wrap around the end of the buffer.
+
+  \param span Span, that is assigned on success
+  \return True, when the snapshot is contiguous in memory
+ */
+bool QwtRingBufferPointData::pointSpan( QwtPointSpan &span ) const
+{
+    const uint index = static_cast<uint>( d_data->from ) & d_data->mask;
+    const size_t numPoints = size();
+
+    if ( index + numPoints > d_data->mask + 1 )
+        return false;
+
+    span = QwtPointSpan( d_data->xData.constData() + index,
+        d_data->yData.constData() + index, numPoints );
+
+    return true;
+}
@@ -26,6 +26,7 @@ public:
 
     virtual size_t size() const;
     virtual QPointF sample( size_t i ) const;
+    virtual bool pointSpan( QwtPointSpan & ) const;
 
     const QVector<double> &xData() const;
     const QVector<double> &yData() const;
@@ -46,6 +47,7 @@ public:
     virtual QRectF boundingRect() const;
     virtual size_t size() const;
     virtual QPointF sample( size_t i ) const;
+    virtual bool pointSpan( QwtPointSpan & ) const;
 
     const double *xData() const;
     const double *yData() const;
@@ -143,4 +145,160 @@ private:
     QwtInterval d_intervalOfInterest;
 };
 
+/*!
+  \brief Level of detail decorator for huge series of points
+
+  QwtLevelOfDetailData builds a pyramid of min/max aggregates over
+  a series with increasing x coordinates. For each level the samples
+  are grouped in buckets - 8 samples on the lowest level, twice as
+  many on each level above - storing the indices of the samples
+  with the minimum and maximum y coordinate.
+
+  When the "rectangle of interest" is set ( QwtPlotSeriesItem does this
+  according to the scales ) the visible range is found by binary search
+  and the level is selected so that each unit of resolution()
+  covers at least one bucket. Each bucket is then represented by
+  its first, minimum, maximum and last sample ( M4 aggregation ).
+  So the number of samples, that are handed to QwtPlotCurve
+  depends on the resolution and not on the size of the series.
+
+  Samples, that have been appended to the decorated series, are
+  integrated into the pyramid by updateLevels().
+
+  \par Example
+  \code
+#include <qwt_point_data.h>
+#include <qwt_plot_curve.h>
+
+QwtPlotCurve *curve = new QwtPlotCurve();
+curve->setData( new QwtLevelOfDetailData( new QwtPointArrayData( x, y ) ) );
+  \endcode
+
+  \note The x coordinates of the series need to be increasing
+ */
+class QWT_EXPORT QwtLevelOfDetailData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtLevelOfDetailData( QwtSeriesData<QPointF> *series );
+    virtual ~QwtLevelOfDetailData();
+
+    QwtSeriesData<QPointF> *series();
+    const QwtSeriesData<QPointF> *series() const;
+
+    void setResolution( int );
+    int resolution() const;
+
+    void updateLevels();
+    void rebuildLevels();
+
+    int levelCount() const;
+    int level() const;
+
+    virtual size_t size() const;
+    virtual QPointF sample( size_t i ) const;
+
+    virtual QRectF boundingRect() const;
+    virtual void setRectOfInterest( const QRectF & );
+
+    QRectF rectOfInterest() const;
+
+private:
+    void updateSelection();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+/*!
+  \brief Fixed capacity buffer of points for real-time acquisition
+
+  QwtRingBufferPointData keeps the most recent capacity() points, that
+  have been appended by one producer thread - f.e. a QwtSamplingThread -
+  and displays them without any lock between the producer
+  and the painting thread.
+
+  The producer appends points with append(), what is wait-free:
+  the points are written to slots, that are not visible to the painting
+  thread, and published by one atomic store afterwards. Internally the
+  buffer has room for at least twice the capacity, so that the producer
+  can continue writing, while the painting thread is working on its
+  snapshot. When the producer runs more than that ahead of the
+  painting thread, the points are not appended and append() returns false.
+
+  The painting thread ( usually the GUI thread ) calls updateSnapshot()
+  before replotting. It takes the most recent points as a consistent
+  snapshot, that is returned by size() and sample() until the next
+  call of updateSnapshot(). The bounding rectangle of the snapshot is
+  updated incrementally from the bounding rectangles of blocks
+  of points, that have been calculated before.
+
+  \par Example
+  \code
+#include <qwt_point_data.h>
+#include <qwt_sampling_thread.h>
+
+class SamplingThread: public QwtSamplingThread
+{
+public:
+    SamplingThread( QwtRingBufferPointData *data ):
+        d_data( data )
+    {
+    }
+
+protected:
+    virtual void sample( double elapsed )
+    {
+        d_data->append( elapsed, readValue() );
+    }
+
+private:
+    QwtRingBufferPointData *d_data;
+};
+
+QwtRingBufferPointData *data = new QwtRingBufferPointData( 100000 );
+curve->setData( data );
+
+SamplingThread thread( data );
+thread.start();
+
+// in the GUI thread, f.e. from a timer
+
+data->updateSnapshot();
+plot->replot();
+  \endcode
+
+  \note Only one thread must append points, and only one thread must
+        call updateSnapshot() and read the samples. setCapacity() must not
+        be called, while the producer is running.
+ */
+class QWT_EXPORT QwtRingBufferPointData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtRingBufferPointData( int capacity = 1000 );
+    virtual ~QwtRingBufferPointData();
+
+    void setCapacity( int );
+    int capacity() const;
+
+    // producer
+
+    bool append( double x, double y );
+    bool append( const QPointF & );
+    int append( const QPointF *points, int numPoints );
+
+    // painting thread
+
+    void updateSnapshot();
+    void clear();
+
+    virtual size_t size() const;
+    virtual QPointF sample( size_t i ) const;
+    virtual QRectF boundingRect() const;
+    virtual bool pointSpan( QwtPointSpan & ) const;
+
+private:
+    class PrivateData;
+    PrivateData *d_data;
+};
+
 #endif
@@ -10,7 +10,9 @@
 #include "qwt_point_mapper.h"
 #include "qwt_scale_map.h"
 #include "qwt_pixel_matrix.h"
+#include "qwt_clipper.h"
 #include <qpolygon.h>
+#include <qvector.h>
 #include <qimage.h>
 #include <qpen.h>
 #include <qpainter.h>
@@ -20,7 +22,7 @@
 #include <qtconcurrentrun.h>
 
 #if !defined(QT_NO_QFUTURE)
-#define QWT_USE_THREADS 0
+#define QWT_USE_THREADS 1
 #endif
 
 static QRectF qwtInvalidRect( 0.0, 0.0, -1.0, -1.0 );
@@ -40,8 +42,110 @@ static inline double qwtRoundValueF( double value )
 #endif
 }
 
+// Accessors for the samples, returning them mapped into paint
+// device coordinates. When the series exposes its coordinates as
+// span the compiler is able to inline the loops instead of calling
+// the virtual QwtSeriesData::sample() and the points are mapped
+// in chunks by the vectorized QwtScaleMap::transform()
+
+class QwtSeriesSampler
+{
+public:
+    inline QwtSeriesSampler( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+            const QwtSeriesData<QPointF> *series ):
+        d_xMap( xMap ),
+        d_yMap( yMap ),
+        d_series( series )
+    {
+    }
+
+    inline QPointF operator()( int index ) const
+    {
+        const QPointF sample = d_series->sample( index );
+
+        return QPointF( d_xMap.transform( sample.x() ),
+            d_yMap.transform( sample.y() ) );
+    }
+
+private:
+    const QwtScaleMap &d_xMap;
+    const QwtScaleMap &d_yMap;
+    const QwtSeriesData<QPointF> *d_series;
+};
+
+class QwtSpanSampler
+{
+public:
+    enum { ChunkSize = 512 };
+
+    inline QwtSpanSampler( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+            const QwtPointSpan &span ):
+        d_xMap( xMap ),
+        d_yMap( yMap ),
+        d_span( span ),
+        d_from( 0 ),
+        d_count( 0 )
+    {
+    }
+
+    inline QPointF operator()( int index ) const
+    {
+        int pos = index - d_from;
+        if ( pos < 0 || pos >= d_count )
+        {
+            load( index );
+            pos = 0;
+        }
+
+        return QPointF( d_x[pos], d_y[pos] );
+    }
+
+private:
+    void load( int index ) const
+    {
+        d_from = index;
+        d_count = qMin( static_cast<size_t>( ChunkSize ), 
+            d_span.size() - static_cast<size_t>( index ) );
+
+        if ( d_span.stride() == 1 )
+        {
+            d_xMap.transform( d_span.xData() + index, d_x, d_count );
+            d_yMap.transform( d_span.yData() + index, d_y, d_count );
+        }
+        else
+        {
+            for ( int i = 0; i < d_count; i++ )
+            {
+                d_x[i] = d_span.x( index + i );
+                d_y[i] = d_span.y( index + i );
+            }
+
+            d_xMap.transform( d_x, d_x, d_count );
+            d_yMap.transform( d_y, d_y, d_count );
+        }
+    }
+
+    const QwtScaleMap &d_xMap;
+    const QwtScaleMap &d_yMap;
+    const QwtPointSpan d_span;
+
+    mutable int d_from;
+    mutable int d_count;
+
+    mutable double d_x[ChunkSize];
+    mutable double d_y[ChunkSize];
+};
+
+static inline bool qwtPointSpan( const QwtSeriesData<QPointF> *series,
+    int to, QwtPointSpan &span )
+{
+    return series->pointSpan( span ) && !span.isNull()
+        && span.size() > static_cast<size_t>( to );
+}
+
+template <class Sampler>
 static Qt::Orientation qwtProbeOrientation(
-    const QwtSeriesData<QPointF> *series, int from, int to )
+    const Sampler &sample, int from, int to )
 {
     if ( to - from < 20 )
     {
@@ -49,8 +153,8 @@ static Qt::Orientation qwtProbeOrientation(
         return Qt::Horizontal;
     }
 
-    const double x0 = series->sample( from ).x();
-    const double xn = series->sample( to ).x();
+    const double x0 = sample( from ).x();
+    const double xn = sample( to ).x();
 
     if ( x0 == xn )
         return Qt::Vertical;
@@ -61,7 +165,7 @@ static Qt::Orientation qwtProbeOrientation(
     double x1 = x0;
     for ( int i = from + step; i < to; i += step )
     {
-        const double x2 = series->sample( i ).x();
+        const double x2 = sample( i ).x();
         if ( x2 != x1 )
         {
             if ( ( x2 > x1 ) != isIncreasing )
@@ -177,23 +281,23 @@ private:
     int y0, x1, xMin, xMax, x2;
 };
 
-template <class Polygon, class Point, class PolygonQuadrupel>
-static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, int from, int to )
+template <class Polygon, class Point, class PolygonQuadrupel, class Sampler>
+static Polygon qwtMapPointsQuad(
+    const Sampler &sampler, int from, int to )
 {
-    const QPointF sample0 = series->sample( from );
+    const QPointF sample0 = sampler( from );
 
     PolygonQuadrupel q;
-    q.start( qwtRoundValue( xMap.transform( sample0.x() ) ),
-        qwtRoundValue( yMap.transform( sample0.y() ) ) );
+    q.start( qwtRoundValue( sample0.x() ),
+        qwtRoundValue( sample0.y() ) );
 
     Polygon polyline;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = sampler( i );
 
-        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
-        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+        const int x = qwtRoundValue( sample.x() );
+        const int y = qwtRoundValue( sample.y() );
 
         if ( !q.append( x, y ) )
         {
@@ -238,9 +342,9 @@ static Polygon qwtMapPointsQuad( const Polygon &polyline )
 }
 
 
-template <class Polygon, class Point>
-static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, int from, int to ) 
+template <class Polygon, class Point, class Sampler>
+static Polygon qwtMapPointsQuad(
+    const Sampler &sampler, int from, int to ) 
 {
     Polygon polyline;
     if ( from > to )
@@ -250,12 +354,12 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMa
         probing some values, to decide if it is better 
         to start with x or y coordinates
      */
-    const Qt::Orientation orientation = qwtProbeOrientation( series, from, to );
+    const Qt::Orientation orientation = qwtProbeOrientation( sampler, from, to );
 
     if ( orientation == Qt::Horizontal )
     {
         polyline = qwtMapPointsQuad< Polygon, Point,
-            QwtPolygonQuadrupelY<Polygon, Point> >( xMap, yMap, series, from, to );
+            QwtPolygonQuadrupelY<Polygon, Point> >( sampler, from, to );
 
         polyline = qwtMapPointsQuad< Polygon, Point,
             QwtPolygonQuadrupelX<Polygon, Point> >( polyline );
@@ -263,7 +367,7 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMa
     else
     {
         polyline = qwtMapPointsQuad< Polygon, Point, 
-            QwtPolygonQuadrupelX<Polygon, Point> >( xMap, yMap, series, from, to );
+            QwtPolygonQuadrupelX<Polygon, Point> >( sampler, from, to );
 
         polyline = qwtMapPointsQuad< Polygon, Point, 
             QwtPolygonQuadrupelY<Polygon, Point> >( polyline );
@@ -272,7 +376,7 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMa
     return polyline;
 }
 
-// Helper class to work around the 5 parameters
+// Helper classes to work around the 5 parameters
 // limitation of QtConcurrent::run()
 class QwtDotsCommand
 {
@@ -283,9 +387,21 @@ public:
     QRgb rgb;
 };
 
-static void qwtRenderDots(
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtDotsCommand command, const QPoint &pos, QImage *image ) 
+class QwtPointsCommand
+{
+public:
+    const QwtPointMapper *mapper;
+    const QwtSeriesData<QPointF> *series;
+    int from;
+    int to;
+    QPen pen;
+    bool antialiased;
+};
+
+template <class Sampler>
+static void qwtRenderDotsT(
+    const QwtDotsCommand &command, const Sampler &sampler,
+    const QPoint &pos, QImage *image ) 
 {
     const QRgb rgb = command.rgb;
     QRgb *bits = reinterpret_cast<QRgb *>( image->bits() );
@@ -298,16 +414,68 @@ static void qwtRenderDots(
 
     for ( int i = command.from; i <= command.to; i++ )
     {
-        const QPointF sample = command.series->sample( i );
+        const QPointF sample = sampler( i );
 
-        const int x = static_cast<int>( xMap.transform( sample.x() ) + 0.5 ) - x0;
-        const int y = static_cast<int>( yMap.transform( sample.y() ) + 0.5 ) - y0;
+        const int x = static_cast<int>( sample.x() + 0.5 ) - x0;
+        const int y = static_cast<int>( sample.y() + 0.5 ) - y0;
 
         if ( x >= 0 && x < w && y >= 0 && y < h )
             bits[ y * w + x ] = rgb;
     }
 }
 
+static void qwtRenderDots(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtDotsCommand command, const QPoint &pos, QImage *image ) 
+{
+    QwtPointSpan span;
+    if ( qwtPointSpan( command.series, command.to, span ) )
+    {
+        qwtRenderDotsT( command, 
+            QwtSpanSampler( xMap, yMap, span ), pos, image );
+    }
+    else
+    {
+        qwtRenderDotsT( command, 
+            QwtSeriesSampler( xMap, yMap, command.series ), pos, image );
+    }
+}
+
+static void qwtRenderPoints(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtPointsCommand command, const QPoint &pos, QImage *image ) 
+{
+    QPainter painter( image );
+    painter.translate( -pos );
+    painter.setPen( command.pen );
+    painter.setRenderHint( QPainter::Antialiasing, command.antialiased );
+
+    const int chunkSize = 1000;
+    for ( int i = command.from; i <= command.to; i += chunkSize )
+    {
+        const int indexTo = qMin( i + chunkSize - 1, command.to );
+        const QPolygon points = command.mapper->toPoints(
+            xMap, yMap, command.series, i, indexTo );
+
+        painter.drawPoints( points );
+    }
+}
+
+static void qwtMergeDots( const QImage &partialImage, QImage *image )
+{
+    // all dots have the same opaque color
+
+    const QRgb *from = reinterpret_cast<const QRgb *>( partialImage.bits() );
+    QRgb *to = reinterpret_cast<QRgb *>( image->bits() );
+
+    const int numPixels = image->width() * image->height();
+    for ( int i = 0; i < numPixels; i++ )
+    {
+        if ( from[i] != 0u )
+            to[i] = from[i];
+    }
+}
+
 // some functors, so that the compile can inline
 struct QwtRoundI
 {
@@ -336,12 +504,10 @@ struct QwtNoRoundF
 // mapping points without any filtering - beside checking
 // the bounding rectangle
 
-template<class Polygon, class Point, class Round>
+template<class Polygon, class Point, class Round, class Sampler>
 static inline Polygon qwtToPoints( 
     const QRectF &boundingRect,
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, 
-    int from, int to, Round round )
+    const Sampler &sampler, int from, int to, Round round )
 {
     Polygon polyline( to - from + 1 );
     Point *points = polyline.data();
@@ -356,10 +522,10 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
+            const QPointF sample = sampler( i );
 
-            const double x = xMap.transform( sample.x() );
-            const double y = yMap.transform( sample.y() );
+            const double x = sample.x();
+            const double y = sample.y();
 
             if ( boundingRect.contains( x, y ) )
             {
@@ -379,10 +545,10 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
+            const QPointF sample = sampler( i );
 
-            const double x = xMap.transform( sample.x() );
-            const double y = yMap.transform( sample.y() );
+            const double x = sample.x();
+            const double y = sample.y();
 
             points[ numPoints ].rx() = round( x );
             points[ numPoints ].ry() = round( y );
@@ -394,35 +560,30 @@ static inline Polygon qwtToPoints(
     return polyline;
 }
 
+template<class Sampler>
 static inline QPolygon qwtToPointsI(
     const QRectF &boundingRect,
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series,
-    int from, int to )
+    const Sampler &sampler, int from, int to )
 {
     return qwtToPoints<QPolygon, QPoint>( 
-        boundingRect, xMap, yMap, series, from, to, QwtRoundI() );
+        boundingRect, sampler, from, to, QwtRoundI() );
 }
 
-template<class Round>
+template<class Round, class Sampler>
 static inline QPolygonF qwtToPointsF(
     const QRectF &boundingRect,
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series,
-    int from, int to, Round round )
+    const Sampler &sampler, int from, int to, Round round )
 {
     return qwtToPoints<QPolygonF, QPointF>( 
-        boundingRect, xMap, yMap, series, from, to, round );
+        boundingRect, sampler, from, to, round );
 }
 
 // Mapping points with filtering out consecutive
 // points mapped to the same position
 
-template<class Polygon, class Point, class Round>
+template<class Polygon, class Point, class Round, class Sampler>
 static inline Polygon qwtToPolylineFiltered( 
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, 
-    int from, int to, Round round )
+    const Sampler &sampler, int from, int to, Round round )
 {
     // in curves with many points consecutive points
     // are often mapped to the same position. As this might
@@ -432,18 +593,18 @@ static inline Polygon qwtToPolylineFiltered(
     Polygon polyline( to - from + 1 );
     Point *points = polyline.data();
 
-    const QPointF sample0 = series->sample( from );
+    const QPointF sample0 = sampler( from );
 
-    points[0].rx() = round( xMap.transform( sample0.x() ) );
-    points[0].ry() = round( yMap.transform( sample0.y() ) );
+    points[0].rx() = round( sample0.x() );
+    points[0].ry() = round( sample0.y() );
 
     int pos = 0;
     for ( int i = from + 1; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = sampler( i );
 
-        const Point p( round( xMap.transform( sample.x() ) ),
-            round( yMap.transform( sample.y() ) ) );
+        const Point p( round( sample.x() ),
+            round( sample.y() ) );
 
         if ( points[pos] != p )
             points[++pos] = p;
@@ -453,30 +614,26 @@ static inline Polygon qwtToPolylineFiltered(
     return polyline;
 }
 
+template<class Sampler>
 static inline QPolygon qwtToPolylineFilteredI(
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series,
-    int from, int to )
+    const Sampler &sampler, int from, int to )
 {
     return qwtToPolylineFiltered<QPolygon, QPoint>(
-        xMap, yMap, series, from, to, QwtRoundI() );
+        sampler, from, to, QwtRoundI() );
 }
 
-template<class Round>
+template<class Round, class Sampler>
 static inline QPolygonF qwtToPolylineFilteredF(
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series,
-    int from, int to, Round round )
+    const Sampler &sampler, int from, int to, Round round )
 {
     return qwtToPolylineFiltered<QPolygonF, QPointF>(
-        xMap, yMap, series, from, to, round );
+        sampler, from, to, round );
 } 
 
-template<class Polygon, class Point>
+template<class Polygon, class Point, class Sampler>
 static inline Polygon qwtToPointsFiltered(
     const QRectF &boundingRect,
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, int from, int to )
+    const Sampler &sampler, int from, int to )
 {
     // F.e. in scatter plots ( no connecting lines ) we
     // can sort out all duplicates ( not only consecutive points )
@@ -489,10 +646,10 @@ static inline Polygon qwtToPointsFiltered(
     int numPoints = 0;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = sampler( i );
 
-        const int x = qwtRoundValue( xMap.transform( sample.x() ) );
-        const int y = qwtRoundValue( yMap.transform( sample.y() ) );
+        const int x = qwtRoundValue( sample.x() );
+        const int y = qwtRoundValue( sample.y() );
 
         if ( pixelMatrix.testAndSetPixel( x, y, true ) == false )
         {
@@ -507,33 +664,256 @@ static inline Polygon qwtToPointsFiltered(
     return polygon;
 }
 
+template<class Sampler>
 static inline QPolygon qwtToPointsFilteredI(
     const QRectF &boundingRect,
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, int from, int to )
+    const Sampler &sampler, int from, int to )
 {
     return qwtToPointsFiltered<QPolygon, QPoint>(
-        boundingRect, xMap, yMap, series, from, to );
+        boundingRect, sampler, from, to );
 } 
 
+template<class Sampler>
 static inline QPolygonF qwtToPointsFilteredF(
     const QRectF &boundingRect,
-    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
-    const QwtSeriesData<QPointF> *series, int from, int to )
+    const Sampler &sampler, int from, int to )
 {
     return qwtToPointsFiltered<QPolygonF, QPointF>(
-        boundingRect, xMap, yMap, series, from, to );
+        boundingRect, sampler, from, to );
+}
+
+// Mapping and clipping points in one loop. The mapped points
+// are passed in chunks to the clipper, so that the unclipped
+// polyline never exists in memory
+
+template<class Round, class Sampler>
+static inline QPolygonF qwtToClippedPolylineF( const QRectF &clipRect,
+    bool weedOut, const Sampler &sampler, int from, int to, Round round )
+{
+    enum { ChunkSize = 512 };
+
+    QPolygonF polyline;
+    QwtPolygonClipperF clipper( clipRect, polyline );
+
+    QPointF points[ChunkSize];
+    int numPoints = 0;
+
+    QPointF lastPoint;
+
+    for ( int i = from; i <= to; i++ )
+    {
+        const QPointF sample = sampler( i );
+        const QPointF p( round( sample.x() ), round( sample.y() ) );
+
+        if ( weedOut && i > from && p == lastPoint )
+            continue;
+
+        points[ numPoints++ ] = p;
+        lastPoint = p;
+
+        if ( numPoints == ChunkSize )
+        {
+            clipper.addPoints( points, numPoints );
+            numPoints = 0;
+        }
+    }
+
+    clipper.addPoints( points, numPoints );
+    clipper.finish();
+
+    return polyline;
+}
+
+template<class Sampler>
+static QPolygonF qwtMapToPolygonF( QwtPointMapper::TransformationFlags flags,
+    const QRectF &clipRect, const Sampler &sampler, int from, int to )
+{
+    QPolygonF polyline;
+
+    const bool weedOut = flags & QwtPointMapper::WeedOutPoints;
+
+    if ( clipRect.isValid() )
+    {
+        if ( !( ( flags & QwtPointMapper::RoundPoints ) &&
+            ( flags & QwtPointMapper::WeedOutIntermediatePoints ) ) )
+        {
+            if ( flags & QwtPointMapper::RoundPoints )
+            {
+                polyline = qwtToClippedPolylineF( clipRect, weedOut,
+                    sampler, from, to, QwtRoundF() );
+            }
+            else
+            {
+                polyline = qwtToClippedPolylineF( clipRect, weedOut,
+                    sampler, from, to, QwtNoRoundF() );
+            }
+
+            return polyline;
+        }
+    }
+
+    if ( flags & QwtPointMapper::RoundPoints )
+    {
+        if ( flags & QwtPointMapper::WeedOutIntermediatePoints )
+        {
+            polyline = qwtMapPointsQuad<QPolygonF, QPointF>( 
+                sampler, from, to );
+        }
+        else if ( flags & QwtPointMapper::WeedOutPoints )
+        {
+            polyline = qwtToPolylineFilteredF( 
+                sampler, from, to, QwtRoundF() );
+        }
+        else
+        {
+            polyline = qwtToPointsF( qwtInvalidRect, 
+                sampler, from, to, QwtRoundF() );
+        }
+    }
+    else
+    {
+        if ( flags & QwtPointMapper::WeedOutPoints )
+        {
+            polyline = qwtToPolylineFilteredF( 
+                sampler, from, to, QwtNoRoundF() );
+        }
+        else
+        {
+            polyline = qwtToPointsF( qwtInvalidRect, 
+                sampler, from, to, QwtNoRoundF() );
+        }
+    }
+
+    if ( clipRect.isValid() )
+        QwtClipper::clipPolygonF( clipRect, polyline, polyline );
+
+    return polyline;
+}
+
+template<class Sampler>
+static QPolygon qwtMapToPolygon( QwtPointMapper::TransformationFlags flags,
+    const QRectF &clipRect, const Sampler &sampler, int from, int to )
+{
+    QPolygon polyline;
+
+    if ( flags & QwtPointMapper::WeedOutIntermediatePoints )
+    {
+        // TODO WeedOutIntermediatePointsY ...
+        polyline = qwtMapPointsQuad<QPolygon, QPoint>( 
+            sampler, from, to );
+    }
+    else if ( flags & QwtPointMapper::WeedOutPoints )
+    {
+        polyline = qwtToPolylineFilteredI( 
+            sampler, from, to );
+    }
+    else
+    {
+        polyline = qwtToPointsI( 
+            qwtInvalidRect, sampler, from, to );
+    }
+
+    if ( clipRect.isValid() )
+        polyline = QwtClipper::clipPolygon( clipRect, polyline );
+
+    return polyline;
+}
+
+template<class Sampler>
+static QPolygonF qwtMapToPointsF( QwtPointMapper::TransformationFlags flags,
+    const QRectF &boundingRect,
+    const Sampler &sampler, int from, int to )
+{
+    QPolygonF points;
+
+    if ( flags & QwtPointMapper::WeedOutPoints )
+    {
+        if ( flags & QwtPointMapper::RoundPoints )
+        {
+            if ( boundingRect.isValid() )
+            {   
+                points = qwtToPointsFilteredF( boundingRect,
+                    sampler, from, to );
+            }
+            else
+            {   
+                // without a bounding rectangle all we can
+                // do is to filter out duplicates of
+                // consecutive points
+
+                points = qwtToPolylineFilteredF( 
+                    sampler, from, to, QwtRoundF() );
+            }
+        }
+        else
+        {
+            // when rounding is not allowed we can't use
+            // qwtToPointsFilteredF
+
+            points = qwtToPolylineFilteredF( 
+                sampler, from, to, QwtNoRoundF() );
+        }
+    }
+    else
+    {
+        if ( flags & QwtPointMapper::RoundPoints )
+        {
+            points = qwtToPointsF( boundingRect,
+                sampler, from, to, QwtRoundF() );
+        }
+        else
+        {
+            points = qwtToPointsF( boundingRect,
+                sampler, from, to, QwtNoRoundF() );
+        }
+    }
+
+    return points;
+}
+
+template<class Sampler>
+static QPolygon qwtMapToPoints( QwtPointMapper::TransformationFlags flags,
+    const QRectF &boundingRect,
+    const Sampler &sampler, int from, int to )
+{
+    QPolygon points;
+
+    if ( flags & QwtPointMapper::WeedOutPoints )
+    {
+        if ( boundingRect.isValid() )
+        {
+            points = qwtToPointsFilteredI( boundingRect,
+                sampler, from, to );
+        }
+        else
+        {
+            // when we don't have the bounding rectangle all
+            // we can do is to filter out consecutive duplicates
+
+            points = qwtToPolylineFilteredI( 
+                sampler, from, to );
+        }
+    }
+    else
+    {
+        points = qwtToPointsI( 
+            boundingRect, sampler, from, to );
+    }
+
+    return points;
 }
 
 class QwtPointMapper::PrivateData
 {
 public:
     PrivateData():
-        boundingRect( qwtInvalidRect )
+        boundingRect( qwtInvalidRect ),
+        clipRect( qwtInvalidRect )
     {
     }
 
     QRectF boundingRect;
+    QRectF clipRect;
     QwtPointMapper::TransformationFlags flags;
 };
 
@@ -617,6 +997,33 @@ QRectF QwtPointMapper::boundingRect() const
     return d_data->boundingRect;
 }
 
+/*!
+  \brief Set a rectangle for clipping the polylines
+
+  When the clip rectangle is valid, the polylines returned
+  from toPolygonF() and toPolygon() are clipped like by
+  QwtClipper::clipPolygonF(). For most flags the points are
+  mapped and clipped in the same loop.
+
+  The default setting is an invalid rectangle: no clipping.
+
+  \param rect Clip rectangle
+  \sa clipRect(), QwtPolygonClipperF
+ */
+void QwtPointMapper::setClipRect( const QRectF &rect )
+{
+    d_data->clipRect = rect;
+}
+
+/*!
+  \return Clip rectangle
+  \sa setClipRect()
+ */
+QRectF QwtPointMapper::clipRect() const
+{
+    return d_data->clipRect;
+}
+
 /*!
   \brief Translate a series of points into a QPolygonF
 
@@ -642,41 +1049,15 @@ QPolygonF QwtPointMapper::toPolygonF(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
-    QPolygonF polyline;
-
-    if ( d_data->flags & RoundPoints )
-    {
-        if ( d_data->flags & WeedOutIntermediatePoints )
-        {
-            polyline = qwtMapPointsQuad<QPolygonF, QPointF>( 
-                xMap, yMap, series, from, to );
-        }
-        else if ( d_data->flags & WeedOutPoints )
-        {
-            polyline = qwtToPolylineFilteredF( 
-                xMap, yMap, series, from, to, QwtRoundF() );
-        }
-        else
-        {
-            polyline = qwtToPointsF( qwtInvalidRect, 
-                xMap, yMap, series, from, to, QwtRoundF() );
-        }
-    }
-    else
+    QwtPointSpan span;
+    if ( qwtPointSpan( series, to, span ) )
     {
-        if ( d_data->flags & WeedOutPoints )
-        {
-            polyline = qwtToPolylineFilteredF( 
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
-        else
-        {
-            polyline = qwtToPointsF( qwtInvalidRect, 
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
+        return qwtMapToPolygonF( d_data->flags, d_data->clipRect,
+            QwtSpanSampler( xMap, yMap, span ), from, to );
     }
 
-    return polyline;
+    return qwtMapToPolygonF( d_data->flags, d_data->clipRect,
+        QwtSeriesSampler( xMap, yMap, series ), from, to );
 }
 
 /*!
@@ -697,26 +1078,15 @@ QPolygon QwtPointMapper::toPolygon(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
-    QPolygon polyline;
-
-    if ( d_data->flags & WeedOutIntermediatePoints )
-    {
-        // TODO WeedOutIntermediatePointsY ...
-        polyline = qwtMapPointsQuad<QPolygon, QPoint>( 
-            xMap, yMap, series, from, to );
-    }
-    else if ( d_data->flags & WeedOutPoints )
-    {
-        polyline = qwtToPolylineFilteredI( 
-            xMap, yMap, series, from, to );
-    }
-    else
+    QwtPointSpan span;
+    if ( qwtPointSpan( series, to, span ) )
     {
-        polyline = qwtToPointsI( 
-            qwtInvalidRect, xMap, yMap, series, from, to );
+        return qwtMapToPolygon( d_data->flags, d_data->clipRect,
+            QwtSpanSampler( xMap, yMap, span ), from, to );
     }
 
-    return polyline;
+    return qwtMapToPolygon( d_data->flags, d_data->clipRect,
+        QwtSeriesSampler( xMap, yMap, series ), from, to );
 }
 
 /*!
@@ -754,51 +1124,15 @@ QPolygonF QwtPointMapper::toPointsF(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
-    QPolygonF points;
-
-    if ( d_data->flags & WeedOutPoints )
-    {
-        if ( d_data->flags & RoundPoints )
-        {
-            if ( d_data->boundingRect.isValid() )
-            {   
-                points = qwtToPointsFilteredF( d_data->boundingRect,
-                    xMap, yMap, series, from, to );
-            }
-            else
-            {   
-                // without a bounding rectangle all we can
-                // do is to filter out duplicates of
-                // consecutive points
-
-                points = qwtToPolylineFilteredF( 
-                    xMap, yMap, series, from, to, QwtRoundF() );
-            }
-        }
-        else
-        {
-            // when rounding is not allowed we can't use
-            // qwtToPointsFilteredF
-
-            points = qwtToPolylineFilteredF( 
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
-    }
-    else
+    QwtPointSpan span;
+    if ( qwtPointSpan( series, to, span ) )
     {
-        if ( d_data->flags & RoundPoints )
-        {
-            points = qwtToPointsF( d_data->boundingRect,
-                xMap, yMap, series, from, to, QwtRoundF() );
-        }
-        else
-        {
-            points = qwtToPointsF( d_data->boundingRect,
-                xMap, yMap, series, from, to, QwtNoRoundF() );
-        }
+        return qwtMapToPointsF( d_data->flags, d_data->boundingRect,
+            QwtSpanSampler( xMap, yMap, span ), from, to );
     }
 
-    return points;
+    return qwtMapToPointsF( d_data->flags, d_data->boundingRect,
+        QwtSeriesSampler( xMap, yMap, series ), from, to );
 }
 
 /*!
@@ -828,37 +1162,29 @@ QPolygon QwtPointMapper::toPoints(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to ) const
 {
-    QPolygon points;
-
-    if ( d_data->flags & WeedOutPoints )
-    {
-        if ( d_data->boundingRect.isValid() )
-        {
-            points = qwtToPointsFilteredI( d_data->boundingRect,
-                xMap, yMap, series, from, to );
-        }
-        else
-        {
-            // when we don't have the bounding rectangle all
-            // we can do is to filter out consecutive duplicates
-
-            points = qwtToPolylineFilteredI( 
-                xMap, yMap, series, from, to );
-        }
-    }
-    else
+    QwtPointSpan span;
+    if ( qwtPointSpan( series, to, span ) )
     {
-        points = qwtToPointsI( 
-            d_data->boundingRect, xMap, yMap, series, from, to );
+        return qwtMapToPoints( d_data->flags, d_data->boundingRect,
+            QwtSpanSampler( xMap, yMap, span ), from, to );
     }
 
-    return points;
+    return qwtMapToPoints( d_data->flags, d_data->boundingRect,
+        QwtSeriesSampler( xMap, yMap, series ), from, to );
 }
 
 
 /*!
   \brief Translate a series into a QImage
 
+  The samples are distributed in consecutive chunks to numThreads threads,
+  where each thread renders its chunk into an image of its own. The 
+  partial images are composed in the order of the chunks, so that the
+  result does not depend on the scheduling of the threads.
+
+  For pens with a width <= 1 and an opaque color each sample 
+  is mapped to one pixel. Otherwise the points are painted by QPainter.
+  
   \param xMap x map
   \param yMap y map
   \param series Series of points to be mapped
@@ -873,20 +1199,36 @@ QPolygon QwtPointMapper::toPoints(
                    ideal thread count is used.
 
   \return Image displaying the series
+
+  \note With translucent pens the result might differ from the
+        result of a single thread in the precision of the color
+        components, as the partial images are composed afterwards.
+
+  \sa QwtPlotItem::renderThreadCount()
 */
 QImage QwtPointMapper::toImage(
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to, 
     const QPen &pen, bool antialiased, uint numThreads ) const
 {
-    Q_UNUSED( antialiased )
+    const QRect rect = d_data->boundingRect.toAlignedRect();
+
+    QImage image( rect.size(), QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+
+    if ( from > to )
+        return image;
 
 #if QWT_USE_THREADS
     if ( numThreads == 0 )
         numThreads = QThread::idealThreadCount();
 
-    if ( numThreads <= 0 )
-        numThreads = 1;
+    // starting threads for a few points is not worth the effort
+    const int minPointsPerThread = 10000;
+
+    const int numPoints = to - from + 1;
+    numThreads = qBound( 1, numPoints / minPointsPerThread, 
+        static_cast<int>( numThreads ) );
 #else
     Q_UNUSED( numThreads )
 #endif
@@ -894,69 +1236,104 @@ QImage QwtPointMapper::toImage(
     // a very special optimization for scatter plots
     // where every sample is mapped to one pixel only.
 
-    const QRect rect = d_data->boundingRect.toAlignedRect();
+    const bool isDots = ( pen.width() <= 1 && pen.color().alpha() == 255 );
 
-    QImage image( rect.size(), QImage::Format_ARGB32 );
-    image.fill( Qt::transparent );
+    QwtDotsCommand dotsCommand;
+    dotsCommand.series = series;
+    dotsCommand.rgb = pen.color().rgba();
 
-    if ( pen.width() <= 1 && pen.color().alpha() == 255 )
-    {
-        QwtDotsCommand command;
-        command.series = series;
-        command.rgb = pen.color().rgba();
+    QwtPointsCommand pointsCommand;
+    pointsCommand.mapper = this;
+    pointsCommand.series = series;
+    pointsCommand.pen = pen;
+    pointsCommand.antialiased = antialiased;
 
 #if QWT_USE_THREADS
-        const int numPoints = ( to - from + 1 ) / numThreads;
+    if ( numThreads > 1 )
+    {
+        const int chunkSize = numPoints / numThreads;
+
+        QVector<QImage> partialImages( numThreads - 1 );
 
         QList< QFuture<void> > futures;
-        for ( uint i = 0; i < numThreads; i++ )
+        for ( uint i = 1; i < numThreads; i++ )
         {
-            const QPoint pos = rect.topLeft();
+            const int index0 = from + static_cast<int>( i ) * chunkSize;
+            const int index1 = ( i == numThreads - 1 ) 
+                ? to : index0 + chunkSize - 1;
 
-            const int index0 = from + i * numPoints;
-            if ( i == numThreads - 1 )
+            QImage &partialImage = partialImages[i - 1];
+            partialImage = QImage( rect.size(), image.format() );
+            partialImage.fill( Qt::transparent );
+
+            if ( isDots )
             {
-                command.from = index0;
-                command.to = to;
+                dotsCommand.from = index0;
+                dotsCommand.to = index1;
 
-                qwtRenderDots( xMap, yMap, command, pos, &image );
+                futures += QtConcurrent::run( &qwtRenderDots, 
+                    xMap, yMap, dotsCommand, rect.topLeft(), &partialImage );
             }
             else
             {
-                command.from = index0;
-                command.to = index0 + numPoints - 1;
+                pointsCommand.from = index0;
+                pointsCommand.to = index1;
 
-                futures += QtConcurrent::run( &qwtRenderDots, 
-                    xMap, yMap, command, pos, &image );
+                futures += QtConcurrent::run( &qwtRenderPoints, 
+                    xMap, yMap, pointsCommand, rect.topLeft(), &partialImage );
             }
         }
+
+        // the first chunk is rendered by the calling thread
+        to = from + chunkSize - 1;
+
+        if ( isDots )
+        {
+            dotsCommand.from = from;
+            dotsCommand.to = to;
+
+            qwtRenderDots( xMap, yMap, dotsCommand, rect.topLeft(), &image );
+        }
+        else
+        {
+            pointsCommand.from = from;
+            pointsCommand.to = to;
+
+            qwtRenderPoints( xMap, yMap, pointsCommand, rect.topLeft(), &image );
+        }
+
         for ( int i = 0; i < futures.size(); i++ )
             futures[i].waitForFinished();
-#else
-        command.from = from;
-        command.to = to;
 
-        qwtRenderDots( xMap, yMap, command, rect.topLeft(), &image );
+        if ( isDots )
+        {
+            for ( int i = 0; i < partialImages.size(); i++ )
+                qwtMergeDots( partialImages[i], &image );
+        }
+        else
+        {
+            QPainter painter( &image );
+            for ( int i = 0; i < partialImages.size(); i++ )
+                painter.drawImage( 0, 0, partialImages[i] );
+        }
+
+        return image;
+    }
 #endif
+
+    if ( isDots )
+    {
+        dotsCommand.from = from;
+        dotsCommand.to = to;
+
+        qwtRenderDots( xMap, yMap, dotsCommand, rect.topLeft(), &image );
     }
     else
     {
-        // fallback implementation: to be replaced later by
-        // setting the pixels of the image like above, TODO ...
-
-        QPainter painter( &image );
-        painter.setPen( pen );
-        painter.setRenderHint( QPainter::Antialiasing, antialiased );
+        pointsCommand.from = from;
+        pointsCommand.to = to;
 
-        const int chunkSize = 1000;
-        for ( int i = from; i <= to; i += chunkSize )
-        {
-            const int indexTo = qMin( i + chunkSize - 1, to );
-            const QPolygon points = toPoints(
-                xMap, yMap, series, i, indexTo );
-
-            painter.drawPoints( points );
-        }
+        qwtRenderPoints( xMap, yMap, pointsCommand, rect.topLeft(), &image );
     }
 
     return image;
@@ -25,6 +25,11 @@ class QPolygon;
   for translating a series of points into paint device coordinates. 
   It is used by QwtPlotCurve but might also be useful for 
   similar plot items displaying a QwtSeriesData<QPointF>.
+
+  When the series exposes its coordinates as QwtPointSpan
+  ( QwtSeriesData::pointSpan() ) the points are read directly from
+  memory instead of calling the virtual QwtSeriesData::sample()
+  for each of them.
  */
 class QWT_EXPORT QwtPointMapper
 {
@@ -83,6 +88,9 @@ public:
     void setBoundingRect( const QRectF & );
     QRectF boundingRect() const;
 
+    void setClipRect( const QRectF & );
+    QRectF clipRect() const;
+
     QPolygonF toPolygonF( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtSeriesData<QPointF> *series, int from, int to ) const;
 
@@ -10,6 +10,12 @@
 #include "qwt_raster_data.h"
 #include "qwt_point_3d.h"
 #include <qnumeric.h>
+#include <qvector.h>
+#include <qhash.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+#include <algorithm>
 
 class QwtRasterData::ContourPlane
 {
@@ -155,6 +161,276 @@ inline QPointF QwtRasterData::ContourPlane::intersection(
     return QPointF( x, y );
 }
 
+class QwtContourSegment
+{
+public:
+    // edges of the raster, where the segment starts/ends
+    qint64 edge[2];
+    QPointF point[2];
+};
+
+class QwtContourJob
+{
+public:
+    const QwtRasterData *data;
+
+    QRectF rect;
+    QSize raster;
+    double dx;
+    double dy;
+
+    QVector<double> xValues;
+    QVector<double> levels;
+
+    QwtInterval range;
+    bool ignoreOutOfRange;
+
+    int numBands;
+};
+
+static inline qint64 qwtHorizontalEdge( const QSize &raster, int col, int row )
+{
+    return 2 * ( static_cast<qint64>( row ) * raster.width() + col );
+}
+
+static inline qint64 qwtVerticalEdge( const QSize &raster, int col, int row )
+{
+    return qwtHorizontalEdge( raster, col, row ) + 1;
+}
+
+static void qwtContourRows( const QwtContourJob *job,
+    int fromRow, int toRow, QVector<QwtContourSegment> *segments )
+{
+    /*
+        Marching squares for the cells between the rows
+        [fromRow, toRow + 1]. For each level the segments are
+        appended to segments[level].
+     */
+
+    enum Edge
+    {
+        TopEdge,
+        RightEdge,
+        BottomEdge,
+        LeftEdge
+    };
+
+    const QSize &raster = job->raster;
+    const int numColumns = raster.width();
+
+    const double *xValues = job->xValues.constData();
+    const double *levels = job->levels.constData();
+    const int numLevels = job->levels.size();
+
+    QVector<double> buffer( 2 * numColumns );
+    double *upperValues = buffer.data();
+    double *lowerValues = upperValues + numColumns;
+
+    job->data->values( job->rect.y() + fromRow * job->dy,
+        xValues, lowerValues, numColumns );
+
+    for ( int row = fromRow; row <= toRow; row++ )
+    {
+        const double y1 = job->rect.y() + row * job->dy;
+        const double y2 = job->rect.y() + ( row + 1 ) * job->dy;
+
+        qSwap( upperValues, lowerValues );
+        job->data->values( y2, xValues, lowerValues, numColumns );
+
+        for ( int col = 0; col < numColumns - 1; col++ )
+        {
+            const double v[4] =
+            {
+                upperValues[col], upperValues[col + 1],
+                lowerValues[col + 1], lowerValues[col]
+            };
+
+            double zMin = v[0];
+            double zMax = v[0];
+
+            for ( int i = 1; i < 4; i++ )
+            {
+                if ( v[i] < zMin )
+                    zMin = v[i];
+                if ( v[i] > zMax )
+                    zMax = v[i];
+            }
+
+            if ( qIsNaN( v[0] + v[1] + v[2] + v[3] ) )
+                continue;
+
+            if ( job->ignoreOutOfRange )
+            {
+                if ( !job->range.contains( zMin ) || !job->range.contains( zMax ) )
+                    continue;
+            }
+
+            // the levels in ( zMin, zMax ] are intersecting the cell
+
+            const int from = std::upper_bound( levels, levels + numLevels, zMin ) - levels;
+            const int to = std::upper_bound( levels, levels + numLevels, zMax ) - levels;
+
+            for ( int l = from; l < to; l++ )
+            {
+                const double level = levels[l];
+
+                const bool above[4] =
+                {
+                    v[0] >= level, v[1] >= level, v[2] >= level, v[3] >= level
+                };
+
+                int edges[4];
+                int numEdges = 0;
+
+                for ( int i = 0; i < 4; i++ )
+                {
+                    if ( above[i] != above[ ( i + 1 ) % 4 ] )
+                        edges[numEdges++] = i;
+                }
+
+                if ( numEdges == 4 )
+                {
+                    // saddle point: resolved by the value in the center
+
+                    const double center = 0.25 * ( v[0] + v[1] + v[2] + v[3] );
+                    if ( ( center >= level ) != above[0] )
+                    {
+                        edges[0] = LeftEdge;
+                        edges[1] = TopEdge;
+                        edges[2] = RightEdge;
+                        edges[3] = BottomEdge;
+                    }
+                }
+
+                for ( int i = 0; i < numEdges; i += 2 )
+                {
+                    QwtContourSegment segment;
+
+                    for ( int k = 0; k < 2; k++ )
+                    {
+                        // the edges are always interpolated from the left/top
+                        // vertex, so that neighboured cells find the same point
+
+                        switch( edges[i + k] )
+                        {
+                            case TopEdge:
+                            {
+                                const double t = ( level - v[0] ) / ( v[1] - v[0] );
+                                segment.edge[k] = qwtHorizontalEdge( raster, col, row );
+                                segment.point[k] = QPointF( xValues[col] + t * job->dx, y1 );
+                                break;
+                            }
+                            case RightEdge:
+                            {
+                                const double t = ( level - v[1] ) / ( v[2] - v[1] );
+                                segment.edge[k] = qwtVerticalEdge( raster, col + 1, row );
+                                segment.point[k] = QPointF( xValues[col + 1], y1 + t * job->dy );
+                                break;
+                            }
+                            case BottomEdge:
+                            {
+                                const double t = ( level - v[3] ) / ( v[2] - v[3] );
+                                segment.edge[k] = qwtHorizontalEdge( raster, col, row + 1 );
+                                segment.point[k] = QPointF( xValues[col] + t * job->dx, y2 );
+                                break;
+                            }
+                            case LeftEdge:
+                            default:
+                            {
+                                const double t = ( level - v[0] ) / ( v[3] - v[0] );
+                                segment.edge[k] = qwtVerticalEdge( raster, col, row );
+                                segment.point[k] = QPointF( xValues[col], y1 + t * job->dy );
+                                break;
+                            }
+                        }
+                    }
+
+                    segments[l] += segment;
+                }
+            }
+        }
+    }
+}
+
+static void qwtJoinSegments( const QwtContourJob *job,
+    const QVector<QwtContourSegment> *bandSegments, int level,
+    QVector<QPolygonF> *polylines )
+{
+    // bandSegments[ band * numLevels + level ]
+
+    const int numLevels = job->levels.size();
+
+    QVector<QwtContourSegment> segments;
+    for ( int i = 0; i < job->numBands; i++ )
+        segments += bandSegments[ i * numLevels + level ];
+
+    const int numSegments = segments.size();
+    if ( numSegments == 0 )
+        return;
+
+    // each edge is shared by the segments of 2 neighboured cells
+
+    QVector<int> partner( 2 * numSegments, -1 );
+
+    QHash<qint64, int> edgeHash;
+    edgeHash.reserve( 2 * numSegments );
+
+    for ( int i = 0; i < 2 * numSegments; i++ )
+    {
+        const qint64 edge = segments[i / 2].edge[i % 2];
+
+        QHash<qint64, int>::iterator it = edgeHash.find( edge );
+        if ( it == edgeHash.end() )
+        {
+            edgeHash.insert( edge, i );
+        }
+        else
+        {
+            partner[i] = it.value();
+            partner[it.value()] = i;
+            edgeHash.erase( it );
+        }
+    }
+
+    QVector<bool> done( numSegments, false );
+
+    // open polylines first, starting at an end without partner, then the closed ones
+
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        for ( int i = 0; i < 2 * numSegments; i++ )
+        {
+            if ( done[i / 2] || ( pass == 0 && partner[i] >= 0 ) )
+                continue;
+
+            QPolygonF polyline;
+            polyline += segments[i / 2].point[i % 2];
+
+            int end = i;
+            while ( end >= 0 && !done[end / 2] )
+            {
+                const int segment = end / 2;
+                const int other = 2 * segment + ( 1 - end % 2 );
+
+                polyline += segments[segment].point[other % 2];
+                done[segment] = true;
+
+                end = partner[other];
+            }
+
+            *polylines += polyline;
+        }
+    }
+}
+
+static void qwtJoinLevels( const QwtContourJob *job,
+    const QVector<QwtContourSegment> *segments, int fromLevel, int step,
+    QVector<QPolygonF> *polylines )
+{
+    for ( int l = fromLevel; l < job->levels.size(); l += step )
+        qwtJoinSegments( job, segments, l, polylines + l );
+}
+
 class QwtRasterData::PrivateData
 {
 public:
@@ -289,6 +565,55 @@ QRectF QwtRasterData::pixelHint( const QRectF &area ) const
     return QRectF(); 
 }
 
+/*!
+   \brief Calculate the values for a row of positions
+
+   values() is called by QwtPlotSpectrogram and contourLines() for
+   each row of a raster. Implementations can override it to avoid
+   the overhead of a virtual call and of all calculations, that
+   depend on y only, for each position.
+
+   The default implementation calls value() for each position.
+
+   \param y Y value in plot coordinates
+   \param xValues Array of X values in plot coordinates
+   \param out Array, where to store the values
+   \param numValues Size of xValues and out
+
+   \sa value(), tileValues()
+*/
+void QwtRasterData::values( double y,
+    const double *xValues, double *out, int numValues ) const
+{
+    for ( int i = 0; i < numValues; i++ )
+        out[i] = value( xValues[i], y );
+}
+
+/*!
+   \brief Calculate the values for a block of rows
+
+   tileValues() is called by QwtPlotSpectrogram for blocks of rows,
+   that share the same x coordinates. Implementations can override it
+   to do all calculations, that depend on x only, once for all rows.
+
+   The default implementation calls values() for each row.
+
+   \param yValues Array of Y values in plot coordinates, one for each row
+   \param numRows Size of yValues
+   \param xValues Array of X values in plot coordinates, one for each column
+   \param numColumns Size of xValues
+   \param out Array of numRows * numColumns values, where to store
+              the values row by row
+
+   \sa values(), value()
+*/
+void QwtRasterData::tileValues( const double *yValues, int numRows,
+    const double *xValues, int numColumns, double *out ) const
+{
+    for ( int row = 0; row < numRows; row++ )
+        values( yValues[row], xValues, out + row * numColumns, numColumns );
+}
+
 /*!
    Calculate contour lines
 
@@ -325,6 +650,20 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
     QwtRasterData *that = const_cast<QwtRasterData *>( this );
     that->initRaster( rect, raster );
 
+    const int numColumns = raster.width();
+
+    QVector<double> xValues( numColumns );
+    for ( int x = 0; x < numColumns; x++ )
+        xValues[x] = rect.x() + x * dx;
+
+    // the values of 2 neighboured rows
+
+    QVector<double> buffer( 2 * numColumns );
+    double *upperValues = buffer.data();
+    double *lowerValues = upperValues + numColumns;
+
+    values( rect.y(), xValues.constData(), lowerValues, numColumns );
+
     for ( int y = 0; y < raster.height() - 1; y++ )
     {
         enum Position
@@ -339,41 +678,20 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
             NumPositions
         };
 
-        QwtPoint3D xy[NumPositions];
+        const double yTop = rect.y() + y * dy;
+        const double yBottom = rect.y() + ( y + 1 ) * dy;
 
-        for ( int x = 0; x < raster.width() - 1; x++ )
-        {
-            const QPointF pos( rect.x() + x * dx, rect.y() + y * dy );
+        qSwap( upperValues, lowerValues );
+        values( yBottom, xValues.constData(), lowerValues, numColumns );
 
-            if ( x == 0 )
-            {
-                xy[TopRight].setX( pos.x() );
-                xy[TopRight].setY( pos.y() );
-                xy[TopRight].setZ(
-                    value( xy[TopRight].x(), xy[TopRight].y() )
-                );
-
-                xy[BottomRight].setX( pos.x() );
-                xy[BottomRight].setY( pos.y() + dy );
-                xy[BottomRight].setZ(
-                    value( xy[BottomRight].x(), xy[BottomRight].y() )
-                );
-            }
-
-            xy[TopLeft] = xy[TopRight];
-            xy[BottomLeft] = xy[BottomRight];
-
-            xy[TopRight].setX( pos.x() + dx );
-            xy[TopRight].setY( pos.y() );
-            xy[BottomRight].setX( pos.x() + dx );
-            xy[BottomRight].setY( pos.y() + dy );
+        QwtPoint3D xy[NumPositions];
 
-            xy[TopRight].setZ(
-                value( xy[TopRight].x(), xy[TopRight].y() )
-            );
-            xy[BottomRight].setZ(
-                value( xy[BottomRight].x(), xy[BottomRight].y() )
-            );
+        for ( int x = 0; x < numColumns - 1; x++ )
+        {
+            xy[TopLeft] = QwtPoint3D( xValues[x], yTop, upperValues[x] );
+            xy[TopRight] = QwtPoint3D( xValues[x + 1], yTop, upperValues[x + 1] );
+            xy[BottomRight] = QwtPoint3D( xValues[x + 1], yBottom, lowerValues[x + 1] );
+            xy[BottomLeft] = QwtPoint3D( xValues[x], yBottom, lowerValues[x] );
 
             double zMin = xy[TopLeft].z();
             double zMax = zMin;
@@ -408,8 +726,8 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
                 continue;
             }
 
-            xy[Center].setX( pos.x() + 0.5 * dx );
-            xy[Center].setY( pos.y() + 0.5 * dy );
+            xy[Center].setX( xValues[x] + 0.5 * dx );
+            xy[Center].setY( yTop + 0.5 * dy );
             xy[Center].setZ( 0.25 * zSum );
 
             const int numLevels = levels.size();
@@ -446,3 +764,150 @@ QwtRasterData::ContourLines QwtRasterData::contourLines(
 
     return contourLines;
 }
+
+/*!
+   \brief Calculate contour lines as polylines
+
+   contourPolylines() is an alternative to contourLines() using
+   the marching squares algorithm. The raster is divided into bands
+   of rows, that are processed in parallel threads. Then the segments
+   of the cells are joined to continuous polylines for each level -
+   closed contours end with their first point.
+
+   Saddle cells are resolved by the average of the 4 corners.
+   Cells with NaN values are skipped.
+
+   \param rect Bounding rectangle for the contour lines
+   \param raster Number of data pixels of the raster data
+   \param levels List of limits, where to insert contour lines
+   \param flags Flags to customize the contouring algorithm.
+                IgnoreAllVerticesOnLevel has no effect
+   \param numThreads Number of threads, 0 means the system specific
+                     ideal number of threads
+
+   \return Polylines for each level
+   \sa contourLines(), values()
+*/
+QwtRasterData::ContourPolylines QwtRasterData::contourPolylines(
+    const QRectF &rect, const QSize &raster,
+    const QList<double> &levels, ConrecFlags flags, uint numThreads ) const
+{
+    ContourPolylines contourPolylines;
+
+    if ( levels.size() == 0 || !rect.isValid() || !raster.isValid()
+        || raster.width() < 2 || raster.height() < 2 )
+    {
+        return contourPolylines;
+    }
+
+    QwtContourJob job;
+    job.data = this;
+    job.rect = rect;
+    job.raster = raster;
+    job.dx = rect.width() / raster.width();
+    job.dy = rect.height() / raster.height();
+
+    job.xValues.resize( raster.width() );
+    for ( int x = 0; x < raster.width(); x++ )
+        job.xValues[x] = rect.x() + x * job.dx;
+
+    for ( int l = 0; l < levels.size(); l++ )
+    {
+        if ( !qIsNaN( levels[l] ) )
+            job.levels += levels[l];
+    }
+
+    std::sort( job.levels.begin(), job.levels.end() );
+    job.levels.erase( std::unique( job.levels.begin(), job.levels.end() ),
+        job.levels.end() );
+
+    job.range = interval( Qt::ZAxis );
+    job.ignoreOutOfRange = job.range.isValid() && ( flags & IgnoreOutOfRange );
+
+    const int numRows = raster.height() - 1;
+    const int numLevels = job.levels.size();
+
+    QwtRasterData *that = const_cast<QwtRasterData *>( this );
+    that->initRaster( rect, raster );
+
+#if !defined(QT_NO_QFUTURE)
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+#else
+    Q_UNUSED( numThreads );
+    numThreads = 1;
+#endif
+
+    job.numBands = qMin( static_cast<int>( numThreads ), numRows );
+
+    // segments[ band * numLevels + level ]
+    QVector< QVector<QwtContourSegment> > segments( job.numBands * numLevels );
+
+    QVector< QVector<QPolygonF> > polylines( numLevels );
+
+#if !defined(QT_NO_QFUTURE)
+    {
+        // calculating the segments of the cells in bands of rows
+
+        const int bandSize = numRows / job.numBands;
+
+        QList< QFuture<void> > futures;
+        for ( int i = 0; i < job.numBands; i++ )
+        {
+            QVector<QwtContourSegment> *bandSegments =
+                segments.data() + i * numLevels;
+
+            const int fromRow = i * bandSize;
+            if ( i == job.numBands - 1 )
+            {
+                qwtContourRows( &job, fromRow, numRows - 1, bandSegments );
+            }
+            else
+            {
+                futures += QtConcurrent::run( &qwtContourRows,
+                    &job, fromRow, fromRow + bandSize - 1, bandSegments );
+            }
+        }
+
+        for ( int i = 0; i < futures.size(); i++ )
+            futures[i].waitForFinished();
+    }
+
+    {
+        // joining the segments of each level
+
+        const int numJobs = qMin( static_cast<int>( numThreads ), numLevels );
+
+        QList< QFuture<void> > futures;
+        for ( int i = 0; i < numJobs; i++ )
+        {
+            if ( i == numJobs - 1 )
+            {
+                qwtJoinLevels( &job, segments.constData(),
+                    i, numJobs, polylines.data() );
+            }
+            else
+            {
+                futures += QtConcurrent::run( &qwtJoinLevels, &job,
+                    segments.constData(), i, numJobs, polylines.data() );
+            }
+        }
+
+        for ( int i = 0; i < futures.size(); i++ )
+            futures[i].waitForFinished();
+    }
+#else
+    qwtContourRows( &job, 0, numRows - 1, segments.data() );
+    qwtJoinLevels( &job, segments.constData(), 0, 1, polylines.data() );
+#endif
+
+    that->discardRaster();
+
+    for ( int l = 0; l < numLevels; l++ )
+        contourPolylines.insert( job.levels[l], polylines[l] );
+
+    return contourPolylines;
+}
@@ -15,6 +15,7 @@
 #include <qmap.h>
 #include <qlist.h>
 #include <qpolygon.h>
+#include <qvector.h>
 
 class QwtScaleMap;
 
@@ -43,6 +44,9 @@ public:
     //! Contour lines
     typedef QMap<double, QPolygonF> ContourLines;
 
+    //! Contour lines as polylines
+    typedef QMap<double, QVector<QPolygonF> > ContourPolylines;
+
     /*!
       \brief Raster data attributes
 
@@ -105,10 +109,20 @@ public:
     */
     virtual double value( double x, double y ) const = 0;
 
+    virtual void values( double y, const double *xValues,
+        double *out, int numValues ) const;
+
+    virtual void tileValues( const double *yValues, int numRows,
+        const double *xValues, int numColumns, double *out ) const;
+
     virtual ContourLines contourLines( const QRectF &rect,
         const QSize &raster, const QList<double> &levels,
         ConrecFlags ) const;
 
+    virtual ContourPolylines contourPolylines( const QRectF &rect,
+        const QSize &raster, const QList<double> &levels,
+        ConrecFlags, uint numThreads = 0 ) const;
+
     class Contour3DPoint;
     class ContourPlane;
 
@@ -0,0 +1,357 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_ring_buffer_raster_data.h"
+#include <qnumeric.h>
+#include <string.h>
+
+class QwtRingBufferRasterData::PrivateData
+{
+public:
+    PrivateData():
+        numColumns( 0 ),
+        capacity( 0 ),
+        numRows( 0 ),
+        rowCount( 0 ),
+        rowHeight( 1.0 ),
+        dx( 0.0 )
+    {
+    }
+
+    inline const double *row( double y ) const
+    {
+        // the interval has been checked before: we only need to
+        // take care of rounding errors and the maximum
+
+        qint64 r = static_cast<qint64>( y / rowHeight );
+        r = qBound( rowCount - numRows, r, rowCount - 1 );
+
+        return values.constData() + ( r % capacity ) * numColumns;
+    }
+
+    QVector<double> values;
+    int numColumns;
+    int capacity;
+
+    int numRows;
+    qint64 rowCount;
+
+    double rowHeight;
+    double dx;
+};
+
+//! Constructor
+QwtRingBufferRasterData::QwtRingBufferRasterData()
+{
+    d_data = new PrivateData();
+    updateRows();
+}
+
+//! Destructor
+QwtRingBufferRasterData::~QwtRingBufferRasterData()
+{
+    delete d_data;
+}
+
+/*!
+   \brief Assign the bounding interval for an axis
+
+   The interval in X direction defines the positions of the columns,
+   the interval in Z direction the range for the values.
+   The interval in Y direction is calculated from the rows
+   in the buffer and can't be assigned.
+
+   \param axis X or Z axis
+   \param interval Interval
+
+   \sa QwtRasterData::interval(), setRowHeight()
+*/
+void QwtRingBufferRasterData::setInterval(
+    Qt::Axis axis, const QwtInterval &interval )
+{
+    if ( axis == Qt::YAxis )
+        return;
+
+    QwtRasterData::setInterval( axis, interval );
+
+    if ( axis == Qt::XAxis )
+        updateRows();
+}
+
+/*!
+   \brief Set the dimensions of the buffer
+
+   All rows are removed from the buffer.
+
+   \param numColumns Number of values of a row
+   \param capacity Maximum number of rows
+
+   \sa numColumns(), capacity(), clear()
+*/
+void QwtRingBufferRasterData::setDimensions( int numColumns, int capacity )
+{
+    numColumns = qMax( numColumns, 0 );
+    capacity = qMax( capacity, 0 );
+
+    d_data->numColumns = numColumns;
+    d_data->capacity = capacity;
+
+    d_data->values.clear();
+    d_data->values.resize( numColumns * capacity );
+
+    clear();
+}
+
+/*!
+   \return Number of values of a row
+   \sa setDimensions()
+*/
+int QwtRingBufferRasterData::numColumns() const
+{
+    return d_data->numColumns;
+}
+
+/*!
+   \return Maximum number of rows
+   \sa setDimensions(), numRows()
+*/
+int QwtRingBufferRasterData::capacity() const
+{
+    return d_data->capacity;
+}
+
+/*!
+   \brief Set the height of a row in y direction
+
+   The default setting is 1.0 - the y coordinates are the
+   indexes of the rows.
+
+   \param height Height of a row, needs to be > 0.0
+   \sa rowHeight()
+*/
+void QwtRingBufferRasterData::setRowHeight( double height )
+{
+    if ( height > 0.0 && height != d_data->rowHeight )
+    {
+        d_data->rowHeight = height;
+        updateRows();
+    }
+}
+
+/*!
+   \return Height of a row in y direction
+   \sa setRowHeight()
+*/
+double QwtRingBufferRasterData::rowHeight() const
+{
+    return d_data->rowHeight;
+}
+
+/*!
+   \brief Append a row
+
+   When the buffer is full the oldest row is replaced.
+
+   \param values Array of numColumns() values
+   \sa numRows(), rowCount()
+*/
+void QwtRingBufferRasterData::appendRow( const double *values )
+{
+    if ( d_data->capacity <= 0 )
+        return;
+
+    const int index = d_data->rowCount % d_data->capacity;
+
+    double *row = d_data->values.data() + index * d_data->numColumns;
+    memcpy( row, values, d_data->numColumns * sizeof( double ) );
+
+    d_data->rowCount++;
+    if ( d_data->numRows < d_data->capacity )
+        d_data->numRows++;
+
+    updateRows();
+}
+
+/*!
+   \brief Append a row
+
+   Missing values are filled with NaN, extra values are ignored.
+
+   \param values Vector of values
+   \sa numRows(), rowCount()
+*/
+void QwtRingBufferRasterData::appendRow( const QVector<double> &values )
+{
+    if ( values.size() >= d_data->numColumns )
+    {
+        appendRow( values.constData() );
+    }
+    else
+    {
+        QVector<double> row( d_data->numColumns, qQNaN() );
+        memcpy( row.data(), values.constData(), values.size() * sizeof( double ) );
+
+        appendRow( row.constData() );
+    }
+}
+
+/*!
+   \brief Remove all rows
+
+   The next row will be appended at y = 0.0.
+   \sa setDimensions()
+*/
+void QwtRingBufferRasterData::clear()
+{
+    d_data->numRows = 0;
+    d_data->rowCount = 0;
+
+    updateRows();
+}
+
+/*!
+   \return Number of rows in the buffer, that is never
+           more than capacity()
+   \sa capacity(), rowCount()
+*/
+int QwtRingBufferRasterData::numRows() const
+{
+    return d_data->numRows;
+}
+
+/*!
+   \return Number of rows, that have been appended since
+           the last clear()
+   \sa numRows()
+*/
+qint64 QwtRingBufferRasterData::rowCount() const
+{
+    return d_data->rowCount;
+}
+
+/*!
+   \brief Calculate the pixel hint
+
+   The hint is aligned to y = 0.0, so that the raster
+   of the image does not change when scrolling.
+
+   \param area Requested area, ignored
+   \return Geometry of a value
+
+   \sa setRowHeight(), setInterval()
+*/
+QRectF QwtRingBufferRasterData::pixelHint( const QRectF &area ) const
+{
+    Q_UNUSED( area )
+
+    QRectF rect;
+
+    const QwtInterval intervalX = interval( Qt::XAxis );
+    if ( intervalX.isValid() && d_data->numColumns > 0 )
+    {
+        rect = QRectF( intervalX.minValue(), 0.0,
+            d_data->dx, d_data->rowHeight );
+    }
+
+    return rect;
+}
+
+/*!
+   \return the value at a raster position
+
+   \param x X value in plot coordinates
+   \param y Y value in plot coordinates
+*/
+double QwtRingBufferRasterData::value( double x, double y ) const
+{
+    const QwtInterval xInterval = interval( Qt::XAxis );
+    const QwtInterval yInterval = interval( Qt::YAxis );
+
+    if ( !( xInterval.contains( x ) && yInterval.contains( y ) )
+        || d_data->numColumns <= 0 )
+    {
+        return qQNaN();
+    }
+
+    int col = int( ( x - xInterval.minValue() ) / d_data->dx );
+    if ( col >= d_data->numColumns )
+        col = d_data->numColumns - 1;
+
+    return d_data->row( y )[col];
+}
+
+/*!
+   \brief Calculate the values for a row of positions
+
+   The row in the buffer is looked up only once for all positions.
+
+   \param y Y value in plot coordinates
+   \param xValues Array of X values in plot coordinates
+   \param out Array, where to store the values
+   \param numValues Size of xValues and out
+
+   \sa value()
+*/
+void QwtRingBufferRasterData::values( double y,
+    const double *xValues, double *out, int numValues ) const
+{
+    const QwtInterval xInterval = interval( Qt::XAxis );
+    const QwtInterval yInterval = interval( Qt::YAxis );
+
+    if ( !( xInterval.isValid() && yInterval.contains( y ) )
+        || d_data->numColumns <= 0 )
+    {
+        for ( int i = 0; i < numValues; i++ )
+            out[i] = qQNaN();
+
+        return;
+    }
+
+    const double *row = d_data->row( y );
+
+    const int numColumns = d_data->numColumns;
+    const double dx = d_data->dx;
+
+    for ( int i = 0; i < numValues; i++ )
+    {
+        const double x = xValues[i];
+
+        if ( !xInterval.contains( x ) )
+        {
+            out[i] = qQNaN();
+            continue;
+        }
+
+        int col = int( ( x - xInterval.minValue() ) / dx );
+        if ( col >= numColumns )
+            col = numColumns - 1;
+
+        out[i] = row[col];
+    }
+}
+
+void QwtRingBufferRasterData::updateRows()
+{
+    const QwtInterval xInterval = interval( Qt::XAxis );
+
+    d_data->dx = 0.0;
+    if ( xInterval.isValid() && d_data->numColumns > 0 )
+        d_data->dx = xInterval.width() / d_data->numColumns;
+
+    QwtInterval yInterval;
+    if ( d_data->numRows > 0 )
+    {
+        const double h = d_data->rowHeight;
+        yInterval.setInterval(
+            ( d_data->rowCount - d_data->numRows ) * h,
+            d_data->rowCount * h );
+    }
+
+    QwtRasterData::setInterval( Qt::YAxis, yInterval );
+}
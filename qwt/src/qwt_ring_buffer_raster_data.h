@@ -0,0 +1,100 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_RING_BUFFER_RASTER_DATA_H
+#define QWT_RING_BUFFER_RASTER_DATA_H 1
+
+#include "qwt_global.h"
+#include "qwt_raster_data.h"
+#include <qvector.h>
+
+/*!
+  \brief Raster data for waterfall plots
+
+  QwtRingBufferRasterData stores the most recent rows, that have been
+  appended - f.e. one spectrum for each FFT frame. When the buffer
+  is full the oldest row is overwritten.
+
+  The columns are distributed equidistantly over interval( Qt::XAxis ).
+  The y coordinates of the rows are counted from the first row appended
+  after clear(): row n covers [n * rowHeight(), ( n + 1 ) * rowHeight()].
+  interval( Qt::YAxis ) is updated, whenever a row is appended.
+
+  As the values of a row never change, while it is in the buffer,
+  the data can be displayed by a QwtPlotSpectrogram with the
+  QwtPlotRasterItem::ScrollCache policy. Then only the rows, that have
+  been appended since the last replot, need to be rendered.
+
+  \par Example
+  \code
+#include <qwt_ring_buffer_raster_data.h>
+#include <qwt_plot_spectrogram.h>
+
+QwtRingBufferRasterData *data = new QwtRingBufferRasterData();
+data->setInterval( Qt::XAxis, QwtInterval( 0.0, sampleRate / 2 ) );
+data->setInterval( Qt::ZAxis, QwtInterval( -120.0, 0.0 ) );
+data->setDimensions( 4096, 1000 );
+data->setRowHeight( 1.0 / frameRate );
+
+QwtPlotSpectrogram *spectrogram = new QwtPlotSpectrogram();
+spectrogram->setCachePolicy( QwtPlotRasterItem::ScrollCache );
+spectrogram->setData( data );
+
+// for each frame
+data->appendRow( spectrum.constData() );
+
+const QwtInterval rows = data->interval( Qt::YAxis );
+plot->setAxisScale( QwtPlot::yLeft, rows.maxValue() - 10.0, rows.maxValue() );
+plot->replot();
+  \endcode
+
+  \note Resetting the rows by clear() or setDimensions() modifies
+        values of an area, that might be cached by the plot item.
+        It has to be followed by QwtPlotRasterItem::invalidateCache().
+
+  \sa QwtMatrixRasterData, QwtPlotRasterItem::ScrollCache
+*/
+class QWT_EXPORT QwtRingBufferRasterData: public QwtRasterData
+{
+public:
+    QwtRingBufferRasterData();
+    virtual ~QwtRingBufferRasterData();
+
+    virtual void setInterval( Qt::Axis, const QwtInterval & );
+
+    void setDimensions( int numColumns, int capacity );
+    int numColumns() const;
+    int capacity() const;
+
+    void setRowHeight( double );
+    double rowHeight() const;
+
+    void appendRow( const double *values );
+    void appendRow( const QVector<double> &values );
+
+    void clear();
+
+    int numRows() const;
+    qint64 rowCount() const;
+
+    virtual QRectF pixelHint( const QRectF & ) const;
+
+    virtual double value( double x, double y ) const;
+
+    virtual void values( double y, const double *xValues,
+        double *out, int numValues ) const;
+
+private:
+    void updateRows();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -12,6 +12,76 @@
 #include <qrect.h>
 #include <qdebug.h>
 
+#if defined(__AVX__)
+#define QWT_USE_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define QWT_USE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define QWT_USE_NEON 1
+#include <arm_neon.h>
+#endif
+
+/*
+  out = offset + ( value - origin ) * factor, or
+  out = offset + ( value - origin ) / factor for the inverted map.
+
+  The operations are the same as in the scalar QwtScaleMap::transform()
+  and QwtScaleMap::invTransform(), so that both return identical results.
+ */
+template <bool inverted>
+static void qwtMapLinear( const double *values, double *out,
+    size_t numValues, double offset, double origin, double factor )
+{
+    size_t i = 0;
+
+#if QWT_USE_AVX
+    const __m256d o = _mm256_set1_pd( offset );
+    const __m256d s = _mm256_set1_pd( origin );
+    const __m256d f = _mm256_set1_pd( factor );
+
+    for ( ; i + 3 < numValues; i += 4 )
+    {
+        const __m256d d = _mm256_sub_pd( _mm256_loadu_pd( values + i ), s );
+        const __m256d v = inverted ? _mm256_div_pd( d, f ) : _mm256_mul_pd( d, f );
+
+        _mm256_storeu_pd( out + i, _mm256_add_pd( o, v ) );
+    }
+#elif QWT_USE_SSE2
+    const __m128d o = _mm_set1_pd( offset );
+    const __m128d s = _mm_set1_pd( origin );
+    const __m128d f = _mm_set1_pd( factor );
+
+    for ( ; i + 1 < numValues; i += 2 )
+    {
+        const __m128d d = _mm_sub_pd( _mm_loadu_pd( values + i ), s );
+        const __m128d v = inverted ? _mm_div_pd( d, f ) : _mm_mul_pd( d, f );
+
+        _mm_storeu_pd( out + i, _mm_add_pd( o, v ) );
+    }
+#elif QWT_USE_NEON
+    const float64x2_t o = vdupq_n_f64( offset );
+    const float64x2_t s = vdupq_n_f64( origin );
+    const float64x2_t f = vdupq_n_f64( factor );
+
+    for ( ; i + 1 < numValues; i += 2 )
+    {
+        const float64x2_t d = vsubq_f64( vld1q_f64( values + i ), s );
+        const float64x2_t v = inverted ? vdivq_f64( d, f ) : vmulq_f64( d, f );
+
+        vst1q_f64( out + i, vaddq_f64( o, v ) );
+    }
+#endif
+
+    for ( ; i < numValues; i++ )
+    {
+        const double d = values[i] - origin;
+        out[i] = offset + ( inverted ? d / factor : d * factor );
+    }
+}
+
 /*!
   \brief Constructor
 
@@ -139,6 +209,52 @@ void QwtScaleMap::updateFactor()
         d_cnv = ( d_p2 - d_p1 ) / ( ts2 - d_ts1 );
 }
 
+/*!
+  Transform an array of values related to the scale interval
+  into values related to the interval of the paint device
+
+  The linear part of the mapping is vectorized. The transformation
+  is done by QwtTransform::transformArray(). For the transformations
+  of Qwt the results are identical to those of transform( double ),
+  so that a value is always mapped to the same pixel.
+
+  \param values Values relative to the coordinates of the scale
+  \param out Array for the transformed values, might be identical to values
+  \param numValues Number of values
+
+  \sa invTransform()
+*/
+void QwtScaleMap::transform( const double *values, 
+    double *out, size_t numValues ) const
+{
+    if ( d_transform )
+    {
+        d_transform->transformArray( values, out, numValues );
+        values = out;
+    }
+
+    qwtMapLinear<false>( values, out, numValues, d_p1, d_ts1, d_cnv );
+}
+
+/*!
+  Transform an array of paint device values into values 
+  in the interval of the scale
+
+  \param values Values relative to the coordinates of the paint device
+  \param out Array for the transformed values, might be identical to values
+  \param numValues Number of values
+
+  \sa transform()
+*/
+void QwtScaleMap::invTransform( const double *values, 
+    double *out, size_t numValues ) const
+{
+    qwtMapLinear<true>( values, out, numValues, d_ts1, d_p1, d_cnv );
+
+    if ( d_transform )
+        d_transform->invTransformArray( out, out, numValues );
+}
+
 /*!
    Transform a rectangle from scale to paint coordinates
 
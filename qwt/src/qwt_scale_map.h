@@ -46,6 +46,12 @@ public:
     double transform( double s ) const;
     double invTransform( double p ) const;
 
+    void transform( const double *values, 
+        double *out, size_t numValues ) const;
+
+    void invTransform( const double *values, 
+        double *out, size_t numValues ) const;
+
     double p1() const;
     double p2() const;
 
@@ -21,6 +21,59 @@
 #include <qstyle.h>
 #include <qstyleoption.h>
 
+static QList<double> qwtTicksInside(
+    const QList<double> &ticks, const QwtInterval &interval )
+{
+    QList<double> insideTicks;
+    for ( int i = 0; i < ticks.size(); i++ )
+    {
+        if ( interval.contains( ticks[i] ) )
+            insideTicks += ticks[i];
+    }
+
+    return insideTicks;
+}
+
+/*
+  Find out if the new scale is the old one translated by
+  a whole number of pixels, with the same ticks, where
+  both scales are overlapping.
+ */
+static bool qwtScrollOffset(
+    const QwtScaleMap &oldMap, const QwtScaleDiv &oldScaleDiv,
+    const QwtScaleDiv &newScaleDiv, int &offset )
+{
+    const double d1 =
+        oldMap.transform( newScaleDiv.lowerBound() ) - oldMap.p1();
+    const double d2 =
+        oldMap.transform( newScaleDiv.upperBound() ) - oldMap.p2();
+
+    const int d = qRound( d1 );
+    if ( d == 0 || qAbs( d1 - d ) > 1e-3 || qAbs( d2 - d ) > 1e-3 )
+        return false;
+
+    const QwtInterval overlap =
+        oldScaleDiv.interval().normalized() &
+        newScaleDiv.interval().normalized();
+
+    if ( !overlap.isValid() )
+        return false;
+
+    for ( int type = 0; type < QwtScaleDiv::NTickTypes; type++ )
+    {
+        const QList<double> oldTicks =
+            qwtTicksInside( oldScaleDiv.ticks( type ), overlap );
+        const QList<double> newTicks =
+            qwtTicksInside( newScaleDiv.ticks( type ), overlap );
+
+        if ( oldTicks != newTicks )
+            return false;
+    }
+
+    offset = d;
+    return true;
+}
+
 class QwtScaleWidget::PrivateData
 {
 public:
@@ -849,13 +902,97 @@ void QwtScaleWidget::setScaleDiv( const QwtScaleDiv &scaleDiv )
     QwtScaleDraw *sd = d_data->scaleDraw;
     if ( sd->scaleDiv() != scaleDiv )
     {
+        const QwtScaleDiv oldScaleDiv = sd->scaleDiv();
+        const QwtScaleMap oldMap = sd->scaleMap();
+        const QPointF oldPos = sd->pos();
+        const double oldLength = sd->length();
+
         sd->setScaleDiv( scaleDiv );
-        layoutScale();
+        layoutScale( false );
+
+        updateGeometry();
+
+        bool doScroll = isVisible() &&
+            sd->pos() == oldPos && sd->length() == oldLength &&
+            !testAttribute( Qt::WA_StyledBackground );
+
+        if ( doScroll && autoFillBackground() )
+        {
+            const QBrush brush = palette().brush( backgroundRole() );
+            doScroll = ( brush.style() == Qt::SolidPattern );
+        }
+
+        int offset = 0;
+        if ( doScroll )
+            doScroll = qwtScrollOffset( oldMap, oldScaleDiv, scaleDiv, offset );
+
+        if ( doScroll )
+            scrollScale( offset );
+        else
+            update();
 
         Q_EMIT scaleDivChanged();
     }
 }
 
+/*!
+  Scroll the backbone, ticks and labels of the scale
+  and repaint the labels, that have been entered or left
+  the scale.
+
+  \param offset Pixel offset between the old and the new scale
+  \sa setScaleDiv()
+ */
+void QwtScaleWidget::scrollScale( int offset )
+{
+    const QwtScaleDraw *sd = d_data->scaleDraw;
+
+    const QRect cr = contentsRect();
+    const int extent = qCeil( sd->extent( font() ) ) + 1;
+    const QPointF pos = sd->pos();
+
+    // labels might be rotated
+    const int labelSize = 1 + qMax( sd->maxLabelWidth( font() ),
+        sd->maxLabelHeight( font() ) );
+
+    const int margin = qAbs( offset ) + labelSize;
+
+    if ( sd->orientation() == Qt::Horizontal )
+    {
+        int y = qFloor( pos.y() );
+        if ( sd->alignment() == QwtScaleDraw::TopScale )
+            y -= extent - 1;
+
+        const QRect rect( cr.left(), y, cr.width(), extent );
+        scroll( -offset, 0, rect );
+
+        const int x1 = qCeil( pos.x() ) + margin;
+        const int x2 = qFloor( pos.x() + sd->length() ) - margin;
+
+        update( QRect( rect.left(), rect.top(),
+            x1 - rect.left(), rect.height() ) );
+        update( QRect( x2, rect.top(),
+            rect.right() + 1 - x2, rect.height() ) );
+    }
+    else
+    {
+        int x = qFloor( pos.x() );
+        if ( sd->alignment() == QwtScaleDraw::LeftScale )
+            x -= extent - 1;
+
+        const QRect rect( x, cr.top(), extent, cr.height() );
+        scroll( 0, -offset, rect );
+
+        const int y1 = qCeil( pos.y() ) + margin;
+        const int y2 = qFloor( pos.y() + sd->length() ) - margin;
+
+        update( QRect( rect.left(), rect.top(),
+            rect.width(), y1 - rect.top() ) );
+        update( QRect( rect.left(), y2,
+            rect.width(), rect.bottom() + 1 - y2 ) );
+    }
+}
+
 /*!
   Set the transformation
 
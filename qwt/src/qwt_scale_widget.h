@@ -124,6 +124,7 @@ protected:
 
     void scaleChange();
     void layoutScale( bool update = true );
+    void scrollScale( int offset );
 
 private:
     void initScale( QwtScaleDraw::Alignment );
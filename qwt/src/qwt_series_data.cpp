@@ -241,6 +241,24 @@ QRectF QwtPointSeriesData::boundingRect() const
     return d_boundingRect;
 }
 
+/*!
+  \brief Expose the samples as span of interleaved x/y coordinates
+
+  \param span Span, that is assigned on success
+  \return True, unless qreal is not a double
+*/
+bool QwtPointSeriesData::pointSpan( QwtPointSpan &span ) const
+{
+    if ( sizeof( qreal ) != sizeof( double ) )
+        return false;
+
+    const double *values = 
+        reinterpret_cast<const double *>( d_samples.constData() );
+
+    span = QwtPointSpan( values, values + 1, d_samples.size(), 2 );
+    return true;
+}
+
 /*!
    Constructor
    \param samples Samples
@@ -319,6 +337,123 @@ QRectF QwtSetSeriesData::boundingRect() const
     return d_boundingRect;
 }
 
+/*!
+  Constructor
+
+  \param positions Positions of the sets
+  \param values Values of all sets, where the values of
+                consecutive sets follow each other
+  \param setSize Number of values of each set
+
+  \note The number of sets is limited by the size of positions
+        and values.size() / setSize.
+*/
+QwtSetArrayData::QwtSetArrayData( const QVector<double> &positions,
+        const QVector<double> &values, int setSize ):
+    d_positions( positions ),
+    d_values( values ),
+    d_setSize( qMax( setSize, 0 ) )
+{
+}
+
+/*!
+  \brief Calculate the bounding rectangle
+
+  The bounding rectangle is calculated once by iterating over all
+  values and is stored for all following requests.
+
+  \return Bounding rectangle
+*/
+QRectF QwtSetArrayData::boundingRect() const
+{
+    if ( d_boundingRect.width() < 0.0 )
+    {
+        const size_t numSamples = size();
+        if ( numSamples == 0 || d_setSize == 0 )
+            return d_boundingRect;
+
+        const double *positions = d_positions.constData();
+        const double *values = d_values.constData();
+
+        double minX = positions[0];
+        double maxX = positions[0];
+        double minY = values[0];
+        double maxY = values[0];
+
+        for ( size_t i = 0; i < numSamples; i++ )
+        {
+            minX = qMin( minX, positions[i] );
+            maxX = qMax( maxX, positions[i] );
+        }
+
+        const size_t numValues = numSamples * d_setSize;
+        for ( size_t i = 1; i < numValues; i++ )
+        {
+            minY = qMin( minY, values[i] );
+            maxY = qMax( maxY, values[i] );
+        }
+
+        d_boundingRect.setRect( minX, minY, maxX - minX, maxY - minY );
+    }
+
+    return d_boundingRect;
+}
+
+//! \return Number of sets
+size_t QwtSetArrayData::size() const
+{
+    if ( d_setSize == 0 )
+        return 0;
+
+    return qMin( d_positions.size(), d_values.size() / d_setSize );
+}
+
+/*!
+  \param index Index
+  \return Set at index
+
+  \note The values are copied into a QVector. Iterating over
+        the span avoids the allocation.
+  \sa setSpan()
+*/
+QwtSetSample QwtSetArrayData::sample( size_t index ) const
+{
+    const int i = static_cast<int>( index );
+    return QwtSetSample( d_positions[i], d_values.mid( i * d_setSize, d_setSize ) );
+}
+
+/*!
+  Expose the positions and the flat buffer of values
+
+  QwtPlotMultiBarChart uses the span to iterate over the values
+  without building a QwtSetSample for each set.
+
+  \return Span, that is valid until the data object is deleted
+*/
+QwtSetSpan QwtSetArrayData::setSpan() const
+{
+    return QwtSetSpan( d_positions.constData(), d_values.constData(),
+        size(), d_setSize, d_setSize );
+}
+
+//! \return Number of values of each set
+int QwtSetArrayData::setSize() const
+{
+    return d_setSize;
+}
+
+//! \return Positions of the sets
+const QVector<double> &QwtSetArrayData::positions() const
+{
+    return d_positions;
+}
+
+//! \return Values of all sets
+const QVector<double> &QwtSetArrayData::values() const
+{
+    return d_values;
+}
+
 /*!
    Constructor
    \param samples Samples
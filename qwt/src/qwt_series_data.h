@@ -17,6 +17,251 @@
 #include <qvector.h>
 #include <qrect.h>
 
+/*!
+   \brief Memory layout of a series of points
+
+   QwtPointSpan describes x and y coordinates, that are stored
+   in memory blocks of doubles. The coordinates of a point
+   are found at xData()[ i * stride() ] and yData()[ i * stride() ].
+
+   A stride of 1 describes separate arrays for the x and y values,
+   f.e. QwtPointArrayData, while a stride of 2 describes an 
+   array of interleaved x/y pairs like a QVector<QPointF>.
+
+   \sa QwtSeriesData::pointSpan(), QwtPointMapper
+ */
+class QwtPointSpan
+{
+public:
+    QwtPointSpan();
+    QwtPointSpan( const double *xData, const double *yData,
+        size_t size, size_t stride = 1 );
+
+    bool isNull() const;
+
+    size_t size() const;
+    size_t stride() const;
+
+    const double *xData() const;
+    const double *yData() const;
+
+    double x( size_t index ) const;
+    double y( size_t index ) const;
+
+    QPointF sample( size_t index ) const;
+
+private:
+    const double *d_x;
+    const double *d_y;
+    size_t d_size;
+    size_t d_stride;
+};
+
+//! Constructs a null span
+inline QwtPointSpan::QwtPointSpan():
+    d_x( NULL ),
+    d_y( NULL ),
+    d_size( 0 ),
+    d_stride( 1 )
+{
+}
+
+/*!
+   Constructor
+
+   \param xData Pointer to the first x coordinate
+   \param yData Pointer to the first y coordinate
+   \param size Number of points
+   \param stride Distance between 2 consecutive coordinates in doubles
+ */
+inline QwtPointSpan::QwtPointSpan( const double *xData,
+        const double *yData, size_t size, size_t stride ):
+    d_x( xData ),
+    d_y( yData ),
+    d_size( size ),
+    d_stride( stride )
+{
+}
+
+//! \return True, when the span does not reference any memory
+inline bool QwtPointSpan::isNull() const
+{
+    return ( d_x == NULL ) || ( d_y == NULL );
+}
+
+//! \return Number of points
+inline size_t QwtPointSpan::size() const
+{
+    return d_size;
+}
+
+//! \return Distance between 2 consecutive coordinates in doubles
+inline size_t QwtPointSpan::stride() const
+{
+    return d_stride;
+}
+
+//! \return Pointer to the first x coordinate
+inline const double *QwtPointSpan::xData() const
+{
+    return d_x;
+}
+
+//! \return Pointer to the first y coordinate
+inline const double *QwtPointSpan::yData() const
+{
+    return d_y;
+}
+
+/*!
+   \param index Index
+   \return x coordinate of the point at index
+ */
+inline double QwtPointSpan::x( size_t index ) const
+{
+    return d_x[ index * d_stride ];
+}
+
+/*!
+   \param index Index
+   \return y coordinate of the point at index
+ */
+inline double QwtPointSpan::y( size_t index ) const
+{
+    return d_y[ index * d_stride ];
+}
+
+/*!
+   \param index Index
+   \return Point at index
+ */
+inline QPointF QwtPointSpan::sample( size_t index ) const
+{
+    return QPointF( d_x[ index * d_stride ], d_y[ index * d_stride ] );
+}
+
+/*!
+   \brief Memory layout of a series of sets
+
+   QwtSetSpan describes a series of QwtSetSample, where all sets have
+   the same number of values. The positions are stored in a block of
+   doubles, while the values of all sets are stored in one flat
+   buffer: the values of the set at index i are found at
+   valueData()[ i * stride() ] ... valueData()[ i * stride() + setSize() - 1 ].
+
+   \sa QwtSetArrayData::setSpan()
+ */
+class QwtSetSpan
+{
+public:
+    QwtSetSpan();
+    QwtSetSpan( const double *positions, const double *values,
+        size_t size, int setSize, size_t stride );
+
+    bool isNull() const;
+
+    size_t size() const;
+    int setSize() const;
+    size_t stride() const;
+
+    const double *positionData() const;
+    const double *valueData() const;
+
+    double position( size_t index ) const;
+    const double *values( size_t index ) const;
+
+private:
+    const double *d_positions;
+    const double *d_values;
+    size_t d_size;
+    int d_setSize;
+    size_t d_stride;
+};
+
+//! Constructs a null span
+inline QwtSetSpan::QwtSetSpan():
+    d_positions( NULL ),
+    d_values( NULL ),
+    d_size( 0 ),
+    d_setSize( 0 ),
+    d_stride( 0 )
+{
+}
+
+/*!
+   Constructor
+
+   \param positions Pointer to the first position
+   \param values Pointer to the first value of the first set
+   \param size Number of sets
+   \param setSize Number of values of each set
+   \param stride Distance between the first values of 2 consecutive
+                 sets in doubles
+ */
+inline QwtSetSpan::QwtSetSpan( const double *positions,
+        const double *values, size_t size, int setSize, size_t stride ):
+    d_positions( positions ),
+    d_values( values ),
+    d_size( size ),
+    d_setSize( setSize ),
+    d_stride( stride )
+{
+}
+
+//! \return True, when the span does not reference any memory
+inline bool QwtSetSpan::isNull() const
+{
+    return ( d_positions == NULL ) || ( d_values == NULL );
+}
+
+//! \return Number of sets
+inline size_t QwtSetSpan::size() const
+{
+    return d_size;
+}
+
+//! \return Number of values of each set
+inline int QwtSetSpan::setSize() const
+{
+    return d_setSize;
+}
+
+//! \return Distance between 2 consecutive sets in doubles
+inline size_t QwtSetSpan::stride() const
+{
+    return d_stride;
+}
+
+//! \return Pointer to the first position
+inline const double *QwtSetSpan::positionData() const
+{
+    return d_positions;
+}
+
+//! \return Pointer to the first value of the first set
+inline const double *QwtSetSpan::valueData() const
+{
+    return d_values;
+}
+
+/*!
+   \param index Index
+   \return Position of the set at index
+ */
+inline double QwtSetSpan::position( size_t index ) const
+{
+    return d_positions[ index ];
+}
+
+/*!
+   \param index Index
+   \return Pointer to the setSize() values of the set at index
+ */
+inline const double *QwtSetSpan::values( size_t index ) const
+{
+    return d_values + index * d_stride;
+}
+
 /*!
    \brief Abstract interface for iterating over samples
 
@@ -90,6 +335,24 @@ public:
     */
     virtual void setRectOfInterest( const QRectF &rect );
 
+    /*!
+       \brief Direct access to the coordinates of the samples
+
+       Series of points, that are stored in memory blocks of doubles,
+       can expose them as span. Algorithms like QwtPointMapper 
+       use the span to iterate over the points without calling
+       the virtual sample() method for each of them.
+
+       The span has to remain valid until the series gets modified
+       or deleted. Only series of QPointF can be exposed as span.
+
+       The default implementation returns false.
+
+       \param span Span, that is assigned on success
+       \return True, when the samples are available as span
+    */
+    virtual bool pointSpan( QwtPointSpan &span ) const;
+
 protected:
     //! Can be used to cache a calculated bounding rectangle
     mutable QRectF d_boundingRect;
@@ -114,6 +377,12 @@ void QwtSeriesData<T>::setRectOfInterest( const QRectF & )
 {
 }
 
+template <typename T>
+bool QwtSeriesData<T>::pointSpan( QwtPointSpan & ) const
+{
+    return false;
+}
+
 /*!
   \brief Template class for data, that is organized as QVector
 
@@ -202,6 +471,7 @@ public:
         const QVector<QPointF> & = QVector<QPointF>() );
 
     virtual QRectF boundingRect() const;
+    virtual bool pointSpan( QwtPointSpan & ) const;
 };
 
 //! Interface for iterating over an array of 3D points
@@ -233,6 +503,43 @@ public:
     virtual QRectF boundingRect() const;
 };
 
+/*!
+  \brief Interface for iterating over sets, that are stored
+         in a flat buffer
+
+  All sets have the same number of values. The values of the
+  set at index i are stored at values()[ i * setSize() ] ...
+  values()[ i * setSize() + setSize() - 1 ].
+
+  In opposite to QwtSetSeriesData no QVector is allocated per set.
+  The values are exposed by setSpan(), what allows plot items
+  like QwtPlotMultiBarChart to iterate over them without
+  building QwtSetSample objects.
+*/
+class QWT_EXPORT QwtSetArrayData: public QwtSeriesData<QwtSetSample>
+{
+public:
+    QwtSetArrayData( const QVector<double> &positions,
+        const QVector<double> &values, int setSize );
+
+    virtual QRectF boundingRect() const;
+
+    virtual size_t size() const;
+    virtual QwtSetSample sample( size_t index ) const;
+
+    QwtSetSpan setSpan() const;
+
+    int setSize() const;
+
+    const QVector<double> &positions() const;
+    const QVector<double> &values() const;
+
+private:
+    QVector<double> d_positions;
+    QVector<double> d_values;
+    int d_setSize;
+};
+
 /*!
     Interface for iterating over an array of OHLC samples
 */
@@ -352,4 +659,21 @@ inline int qwtUpperSampleIndex( const QwtSeriesData<T> &series,
     return indexMin;
 }
 
+/*!
+  \brief Compare operation for qwtUpperSampleIndex()
+
+  Compares a value with the x coordinate of a point, what can
+  be used for series, that are sorted in increasing order 
+  of their x coordinates.
+ */
+class QwtLessThanX
+{
+public:
+    //! \return True, when x is less than the x coordinate of pos
+    inline bool operator()( const double x, const QPointF &pos ) const
+    {
+        return ( x < pos.x() );
+    }
+};
+
 #endif
@@ -14,8 +14,10 @@
 #include <qpainter.h>
 #include <qpainterpath.h>
 #include <qpixmap.h>
+#include <qimage.h>
 #include <qpaintengine.h>
 #include <qmath.h>
+#include <string.h>
 #ifndef QWT_NO_SVG
 #include <qsvgrenderer.h>
 #endif
@@ -767,6 +769,318 @@ static inline void qwtDrawHexagonSymbols( QPainter *painter,
     }
 }
 
+class QwtSymbolSpriteKey
+{
+public:
+    QwtSymbolSpriteKey( const QwtSymbol &symbol,
+            QPainter::RenderHints hints ):
+        style( symbol.style() ),
+        size( symbol.size() ),
+        pen( symbol.pen() ),
+        brush( symbol.brush() ),
+        isPinPointEnabled( symbol.isPinPointEnabled() ),
+        pinPoint( symbol.pinPoint() ),
+        renderHints( hints )
+    {
+    }
+
+    bool operator==( const QwtSymbolSpriteKey &other ) const
+    {
+        return ( style == other.style ) && ( size == other.size )
+            && ( pen == other.pen ) && ( brush == other.brush )
+            && ( isPinPointEnabled == other.isPinPointEnabled )
+            && ( pinPoint == other.pinPoint )
+            && ( renderHints == other.renderHints );
+    }
+
+    QwtSymbol::Style style;
+    QSize size;
+    QPen pen;
+    QBrush brush;
+    bool isPinPointEnabled;
+    QPointF pinPoint;
+    QPainter::RenderHints renderHints;
+};
+
+/*
+   Several prerendered symbols in one image. Symbols with built-in
+   styles are completely identified by their attributes, so that a symbol,
+   that toggles between different pens/brushes/sizes, can reuse sprites,
+   that have been rendered before.
+ */
+class QwtSymbolAtlas
+{
+public:
+    enum
+    {
+        MinWidth = 256,
+        MaxHeight = 1024
+    };
+
+    QwtSymbolAtlas():
+        d_x( 0 ),
+        d_y( 0 ),
+        d_rowHeight( 0 )
+    {
+    }
+
+    int indexOf( const QwtSymbolSpriteKey &key ) const
+    {
+        for ( int i = 0; i < d_sprites.size(); i++ )
+        {
+            if ( d_sprites[i].key == key )
+                return i;
+        }
+
+        return -1;
+    }
+
+    int insert( const QwtSymbolSpriteKey &key, const QSize &size )
+    {
+        if ( size.isEmpty() || size.height() > MaxHeight )
+            return -1;
+
+        if ( d_image.isNull() || size.width() > d_image.width() )
+            reset( size );
+
+        if ( d_x + size.width() > d_image.width() )
+        {
+            // next row
+            d_x = 0;
+            d_y += d_rowHeight;
+            d_rowHeight = 0;
+        }
+
+        if ( d_y + size.height() > MaxHeight )
+        {
+            // full: starting from scratch
+            reset( size );
+        }
+
+        if ( d_y + size.height() > d_image.height() )
+        {
+            const int height = qMin( int( MaxHeight ),
+                qMax( 2 * d_image.height(), d_y + size.height() ) );
+
+            resize( height );
+        }
+
+        d_sprites += Sprite( key, QRect( QPoint( d_x, d_y ), size ) );
+
+        d_x += size.width();
+        d_rowHeight = qMax( d_rowHeight, size.height() );
+
+        return d_sprites.size() - 1;
+    }
+
+    QRect spriteRect( int index ) const
+    {
+        return d_sprites[index].rect;
+    }
+
+    QImage &image()
+    {
+        return d_image;
+    }
+
+    void removeUserSprites()
+    {
+        // sprites, that can't be identified by their key
+
+        for ( int i = d_sprites.size() - 1; i >= 0; i-- )
+        {
+            if ( d_sprites[i].key.style >= QwtSymbol::Path )
+                d_sprites.removeAt( i );
+        }
+    }
+
+private:
+    void reset( const QSize &size )
+    {
+        d_sprites.clear();
+
+        d_x = d_y = d_rowHeight = 0;
+
+        d_image = QImage( qMax( int( MinWidth ), size.width() ),
+            size.height(), QImage::Format_ARGB32_Premultiplied );
+        d_image.fill( 0 );
+    }
+
+    void resize( int height )
+    {
+        QImage image( d_image.width(), height,
+            QImage::Format_ARGB32_Premultiplied );
+        image.fill( 0 );
+
+        for ( int y = 0; y < d_image.height(); y++ )
+        {
+            ::memcpy( image.scanLine( y ), d_image.constScanLine( y ),
+                d_image.bytesPerLine() );
+        }
+
+        d_image = image;
+    }
+
+    class Sprite
+    {
+    public:
+        Sprite( const QwtSymbolSpriteKey &spriteKey, const QRect &spriteRect ):
+            key( spriteKey ),
+            rect( spriteRect )
+        {
+        }
+
+        QwtSymbolSpriteKey key;
+        QRect rect;
+    };
+
+    QList<Sprite> d_sprites;
+    QImage d_image;
+
+    int d_x;
+    int d_y;
+    int d_rowHeight;
+};
+
+static QImage *qwtRasterImage( const QPainter *painter,
+    QPoint &offset, QRect &clipRect )
+{
+    /*
+       The sprites can be composed directly into the memory of
+       an image, as long as the painter does nothing, that would
+       have to be done by the raster paint engine.
+     */
+
+    QPaintDevice *device = painter->device();
+    if ( device == NULL || device->devType() != QInternal::Image )
+        return NULL;
+
+    QImage *image = static_cast<QImage *>( device );
+    if ( image->format() != QImage::Format_ARGB32_Premultiplied &&
+        image->format() != QImage::Format_RGB32 )
+    {
+        return NULL;
+    }
+
+#if QT_VERSION >= 0x050000
+    if ( image->devicePixelRatio() != 1.0 )
+        return NULL;
+#endif
+
+    if ( painter->compositionMode() != QPainter::CompositionMode_SourceOver
+        || painter->opacity() < 1.0 )
+    {
+        return NULL;
+    }
+
+    const QTransform transform = painter->combinedTransform();
+    if ( transform.type() > QTransform::TxTranslate )
+        return NULL;
+
+    offset = QPoint( qRound( transform.dx() ), qRound( transform.dy() ) );
+    if ( offset.x() != transform.dx() || offset.y() != transform.dy() )
+        return NULL;
+
+    clipRect = image->rect();
+    if ( painter->hasClipping() )
+    {
+        const QRegion clipRegion = painter->clipRegion();
+        if ( clipRegion.rectCount() > 1 )
+            return NULL;
+
+        clipRect &= clipRegion.boundingRect().translated( offset );
+    }
+
+    return image;
+}
+
+static inline uint qwtBlendPixel( uint src, uint dst )
+{
+    // src + dst * ( 1 - alpha( src ) ) with premultiplied colors
+
+    const uint alpha = 255 - ( src >> 24 );
+
+    uint rb = ( dst & 0x00ff00ff ) * alpha;
+    rb = ( ( rb + ( ( rb >> 8 ) & 0x00ff00ff ) + 0x00800080 ) >> 8 ) & 0x00ff00ff;
+
+    uint ag = ( ( dst >> 8 ) & 0x00ff00ff ) * alpha;
+    ag = ( ag + ( ( ag >> 8 ) & 0x00ff00ff ) + 0x00800080 ) & 0xff00ff00;
+
+    return src + ( rb | ag );
+}
+
+/*
+  The spans are limited by the width of a symbol, so the shortcuts
+  for opaque and transparent pixels are worth more than vectorizing
+  the loop with intrinsics, like it is done for the linear
+  scale maps in qwt_scale_map.cpp.
+ */
+static inline void qwtBlendSpan( uint *dst, const uint *src, int length )
+{
+    for ( int i = 0; i < length; i++ )
+    {
+        const uint s = src[i];
+
+        if ( s >= 0xff000000 )
+            dst[i] = s;
+        else if ( s != 0 )
+            dst[i] = qwtBlendPixel( s, dst[i] );
+    }
+}
+
+static void qwtBlendSprites( QImage &image, const QRect &clipRect,
+    const QImage &atlas, const QRect &sprite, const QPoint &offset,
+    const QPointF *points, int numPoints )
+{
+    if ( !clipRect.isValid() )
+        return;
+
+    // points outside ( or NaN ) are sorted out before rounding
+
+    const double xMin = clipRect.left() - offset.x() - sprite.width();
+    const double xMax = clipRect.right() - offset.x() + 1;
+    const double yMin = clipRect.top() - offset.y() - sprite.height();
+    const double yMax = clipRect.bottom() - offset.y() + 1;
+
+    uchar *bits = image.bits();
+    const int bytesPerLine = image.bytesPerLine();
+
+    const uchar *spriteBits = atlas.constBits();
+    const int spriteBytesPerLine = atlas.bytesPerLine();
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const double x = points[i].x();
+        const double y = points[i].y();
+
+        if ( !( x > xMin && x < xMax && y > yMin && y < yMax ) )
+            continue;
+
+        const int left = qRound( x ) + offset.x();
+        const int top = qRound( y ) + offset.y();
+
+        const QRect r = QRect( left, top,
+            sprite.width(), sprite.height() ) & clipRect;
+
+        if ( r.isEmpty() )
+            continue;
+
+        const int sx = sprite.left() + r.left() - left;
+
+        for ( int row = r.top(); row <= r.bottom(); row++ )
+        {
+            const int sy = sprite.top() + row - top;
+
+            const uint *src = reinterpret_cast<const uint *>(
+                spriteBits + sy * spriteBytesPerLine ) + sx;
+            uint *dst = reinterpret_cast<uint *>(
+                bits + row * bytesPerLine ) + r.left();
+
+            qwtBlendSpan( dst, src, r.width() );
+        }
+    }
+}
+
 class QwtSymbol::PrivateData
 {
 public:
@@ -829,6 +1143,7 @@ public:
     {
         QwtSymbol::CachePolicy policy;
         QPixmap pixmap;
+        QwtSymbolAtlas atlas;
 
     } cache;
 };
@@ -967,6 +1282,8 @@ void QwtSymbol::setPath( const QPainterPath &path )
     d_data->style = QwtSymbol::Path;
     d_data->path.path = path;
     d_data->path.graphic.reset();
+
+    invalidateCache();
 }
 
 /*!
@@ -992,6 +1309,8 @@ void QwtSymbol::setPixmap( const QPixmap &pixmap )
 {
     d_data->style = QwtSymbol::Pixmap;
     d_data->pixmap.pixmap = pixmap;
+
+    invalidateCache();
 }
 
 /*!
@@ -1017,6 +1336,8 @@ void QwtSymbol::setGraphic( const QwtGraphic &graphic )
 {
     d_data->style = QwtSymbol::Graphic;
     d_data->graphic.graphic = graphic;
+
+    invalidateCache();
 }
 
 /*!
@@ -1047,6 +1368,8 @@ void QwtSymbol::setSvgDocument( const QByteArray &svgDocument )
         d_data->svg.renderer = new QSvgRenderer();
 
     d_data->svg.renderer->load( svgDocument );
+
+    invalidateCache();
 }
 
 #endif
@@ -1299,6 +1622,13 @@ bool QwtSymbol::isPinPointEnabled() const
   one by one, as a couple of layout calculations and setting of pen/brush
   can be done once for the complete array.
 
+  When the symbol is cached and the painter is painting to a QImage
+  ( QImage::Format_ARGB32_Premultiplied or QImage::Format_RGB32 )
+  without scaling, opacity or non rectangular clipping, the cached symbol
+  is composed directly into the image memory bypassing the paint engine.
+  The prerendered symbols are kept in an atlas, so that toggling
+  between different pens, brushes or sizes doesn't render them again.
+
   \param painter Painter
   \param points Array of points
   \param numPoints Number of points
@@ -1390,7 +1720,45 @@ void QwtSymbol::drawSymbols( QPainter *painter,
     {
         const QRect br = boundingRect();
 
-        const QRect rect( 0, 0, br.width(), br.height() );
+        QPoint offset;
+        QRect clipRect;
+
+        QImage *image = qwtRasterImage( painter, offset, clipRect );
+        if ( image )
+        {
+            // composing the sprite directly into the image
+
+            QwtSymbolAtlas &atlas = d_data->cache.atlas;
+
+            const QwtSymbolSpriteKey key( *this, painter->renderHints() );
+
+            int index = atlas.indexOf( key );
+            if ( index < 0 )
+            {
+                index = atlas.insert( key, br.size() );
+                if ( index >= 0 )
+                {
+                    const QRect spriteRect = atlas.spriteRect( index );
+
+                    QPainter p( &atlas.image() );
+                    p.setRenderHints( painter->renderHints() );
+                    p.setClipRect( spriteRect );
+                    p.translate( spriteRect.topLeft() - br.topLeft() );
+
+                    const QPointF pos( 0.0, 0.0 );
+                    renderSymbols( &p, &pos, 1 );
+                }
+            }
+
+            if ( index >= 0 )
+            {
+                qwtBlendSprites( *image, clipRect, atlas.image(),
+                    atlas.spriteRect( index ), offset + br.topLeft(),
+                    points, numPoints );
+
+                return;
+            }
+        }
 
         if ( d_data->cache.pixmap.isNull() )
         {
@@ -1776,6 +2144,8 @@ void QwtSymbol::invalidateCache()
 {
     if ( !d_data->cache.pixmap.isNull() )
         d_data->cache.pixmap = QPixmap();
+
+    d_data->cache.atlas.removeUserSprites();
 }
 
 /*!
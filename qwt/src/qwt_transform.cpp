@@ -10,6 +10,8 @@
 #include "qwt_transform.h"
 #include "qwt_math.h"
 
+#include <string.h>
+
 #if QT_VERSION < 0x040601
 #define qExp(x) ::exp(x)
 #endif
@@ -39,6 +41,46 @@ double QwtTransform::bounded( double value ) const
     return value;
 }
 
+/*!
+  \brief Transform an array of values
+
+  The default implementation calls transform() for each value.
+  Transformations, that can be done more efficiently for
+  many values at once, should reimplement this method.
+
+  \param values Values to be transformed
+  \param out Array for the transformed values,
+             might be identical to values
+  \param numValues Number of values
+
+  \sa transform(), invTransformArray(), QwtScaleMap::transform()
+ */
+void QwtTransform::transformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    for ( size_t i = 0; i < numValues; i++ )
+        out[i] = transform( values[i] );
+}
+
+/*!
+  \brief Inverse transform an array of values
+
+  The default implementation calls invTransform() for each value.
+
+  \param values Values to be transformed
+  \param out Array for the transformed values,
+             might be identical to values
+  \param numValues Number of values
+
+  \sa invTransform(), transformArray(), QwtScaleMap::invTransform()
+ */
+void QwtTransform::invTransformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    for ( size_t i = 0; i < numValues; i++ )
+        out[i] = invTransform( values[i] );
+}
+
 //! Constructor
 QwtNullTransform::QwtNullTransform():
     QwtTransform()
@@ -68,6 +110,30 @@ double QwtNullTransform::invTransform( double value ) const
     return value;
 }
 
+/*! 
+  \param values Values to be transformed
+  \param out Values unmodified
+  \param numValues Number of values
+ */
+void QwtNullTransform::transformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    if ( out != values )
+        ::memmove( out, values, numValues * sizeof( double ) );
+}
+
+/*! 
+  \param values Values to be transformed
+  \param out Values unmodified
+  \param numValues Number of values
+ */
+void QwtNullTransform::invTransformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    if ( out != values )
+        ::memmove( out, values, numValues * sizeof( double ) );
+}
+
 //! \return Clone of the transformation
 QwtTransform *QwtNullTransform::copy() const
 {
@@ -103,6 +169,36 @@ double QwtLogTransform::invTransform( double value ) const
     return qExp( value );
 }
 
+/*! 
+  \param values Values to be transformed
+  \param out log( value ) for each value
+  \param numValues Number of values
+
+  \note The values are calculated by the same function as in
+        transform(), so that both return identical results.
+ */
+void QwtLogTransform::transformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    for ( size_t i = 0; i < numValues; i++ )
+        out[i] = ::log( values[i] );
+}
+
+/*! 
+  \param values Values to be transformed
+  \param out exp( value ) for each value
+  \param numValues Number of values
+
+  \note The values are calculated by the same function as in
+        invTransform(), so that both return identical results.
+ */
+void QwtLogTransform::invTransformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    for ( size_t i = 0; i < numValues; i++ )
+        out[i] = qExp( values[i] );
+}
+
 /*! 
   \param value Value to be bounded
   \return qBound( LogMin, value, LogMax )
@@ -158,6 +254,30 @@ double QwtPowerTransform::invTransform( double value ) const
         return qPow( value, d_exponent );
 }
 
+/*! 
+  \param values Values to be transformed
+  \param out Exponentiation preserving the sign for each value
+  \param numValues Number of values
+ */
+void QwtPowerTransform::transformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    for ( size_t i = 0; i < numValues; i++ )
+        out[i] = QwtPowerTransform::transform( values[i] );
+}
+
+/*! 
+  \param values Values to be transformed
+  \param out Inverse exponentiation preserving the sign for each value
+  \param numValues Number of values
+ */
+void QwtPowerTransform::invTransformArray(
+    const double *values, double *out, size_t numValues ) const
+{
+    for ( size_t i = 0; i < numValues; i++ )
+        out[i] = QwtPowerTransform::invTransform( values[i] );
+}
+
 //! \return Clone of the transformation
 QwtTransform *QwtPowerTransform::copy() const
 {
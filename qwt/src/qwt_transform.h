@@ -64,6 +64,12 @@ public:
      */
     virtual double invTransform( double value ) const = 0;
 
+    virtual void transformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
+    virtual void invTransformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
     //! Virtualized copy operation
     virtual QwtTransform *copy() const = 0;
 
@@ -86,6 +92,12 @@ public:
     virtual double transform( double value ) const;
     virtual double invTransform( double value ) const;
 
+    virtual void transformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
+    virtual void invTransformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
     virtual QwtTransform *copy() const;
 };
 /*!
@@ -106,6 +118,12 @@ public:
     virtual double transform( double value ) const;
     virtual double invTransform( double value ) const;
 
+    virtual void transformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
+    virtual void invTransformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
     virtual double bounded( double value ) const;
 
     virtual QwtTransform *copy() const;
@@ -131,6 +149,12 @@ public:
     virtual double transform( double value ) const;
     virtual double invTransform( double value ) const;
 
+    virtual void transformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
+    virtual void invTransformArray( 
+        const double *values, double *out, size_t numValues ) const;
+
     virtual QwtTransform *copy() const;
 
 private:
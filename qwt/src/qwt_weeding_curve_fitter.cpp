@@ -9,8 +9,17 @@
 
 #include "qwt_weeding_curve_fitter.h"
 #include "qwt_math.h"
-#include <qstack.h>
 #include <qvector.h>
+#include <qvarlengtharray.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+#include <string.h>
+#include <typeinfo>
+
+#if !defined(QT_NO_QFUTURE)
+#define QWT_USE_THREADS 1
+#endif
 
 #if QT_VERSION < 0x040601
 #define qFabs(x) ::fabs(x)
@@ -21,18 +30,38 @@ class QwtWeedingCurveFitter::PrivateData
 public:
     PrivateData():
         tolerance( 1.0 ),
-        chunkSize( 0 )
+        chunkSize( 0 ),
+        threadCount( 1 ),
+        incremental( false ),
+        numCachedPoints( 0 ),
+        numCachedFitted( 0 )
+    {
+    }
+
+    void invalidateCache()
     {
+        fittedPoints.clear();
+        numCachedPoints = 0;
+        numCachedFitted = 0;
     }
 
     double tolerance;
     uint chunkSize;
+    uint threadCount;
+    bool incremental;
+
+    // the completed chunks of the previous call in incremental mode
+    QPolygonF fittedPoints;
+    int numCachedPoints;
+    int numCachedFitted;
+    QPointF firstPoint;
+    QPointF lastPoint;
 };
 
-class QwtWeedingCurveFitter::Line
+class QwtWeedingLine
 {
 public:
-    Line( int i1 = 0, int i2 = 0 ):
+    QwtWeedingLine( int i1 = 0, int i2 = 0 ):
         from( i1 ),
         to( i2 )
     {
@@ -42,6 +71,152 @@ public:
     int to;
 };
 
+class QwtWeedingJob
+{
+public:
+    inline QPolygonF simplify( const QPolygonF &points ) const
+    {
+        return fitter->simplify( points );
+    }
+
+    const QwtWeedingCurveFitter *fitter;
+
+    // simplify() has been reimplemented in a derived class
+    bool isReimplemented;
+    double toleranceSqr;
+
+    const QPointF *points;
+    int numPoints;
+    int chunkSize;
+
+    QPointF *fittedPoints;
+    int *numFitted;
+};
+
+static int qwtSimplify( const QPointF *p, int nPoints,
+    double toleranceSqr, QPointF *fittedPoints )
+{
+    if ( nPoints <= 0 )
+        return 0;
+
+    /*
+      The lines are processed depth first, the left half before
+      the right half. So the lines, that are accepted, are in increasing
+      order and their end points can be written without having a mask.
+     */
+
+    QVarLengthArray<QwtWeedingLine, 256> stack;
+    stack.append( QwtWeedingLine( 0, nPoints - 1 ) );
+
+    int numFitted = 0;
+    int lastIndex = -1;
+
+    while ( stack.size() > 0 )
+    {
+        const QwtWeedingLine r = stack[ stack.size() - 1 ];
+        stack.resize( stack.size() - 1 );
+
+        // initialize line segment
+        const double vecX = p[r.to].x() - p[r.from].x();
+        const double vecY = p[r.to].y() - p[r.from].y();
+
+        const double vecLength = qSqrt( vecX * vecX + vecY * vecY );
+
+        const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
+        const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+
+        double maxDistSqr = 0.0;
+        int nVertexIndexMaxDistance = r.from + 1;
+        for ( int i = r.from + 1; i < r.to; i++ )
+        {
+            //compare to anchor
+            const double fromVecX = p[i].x() - p[r.from].x();
+            const double fromVecY = p[i].y() - p[r.from].y();
+
+            double distToSegmentSqr;
+            if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
+            {
+                distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
+            }
+            else
+            {
+                const double toVecX = p[i].x() - p[r.to].x();
+                const double toVecY = p[i].y() - p[r.to].y();
+                const double toVecLength = toVecX * toVecX + toVecY * toVecY;
+
+                const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
+                if ( s < 0.0 )
+                {
+                    distToSegmentSqr = toVecLength;
+                }
+                else
+                {
+                    distToSegmentSqr = qFabs( toVecLength - s * s );
+                }
+            }
+
+            if ( maxDistSqr < distToSegmentSqr )
+            {
+                maxDistSqr = distToSegmentSqr;
+                nVertexIndexMaxDistance = i;
+            }
+        }
+        if ( maxDistSqr <= toleranceSqr )
+        {
+            if ( r.from != lastIndex )
+                fittedPoints[ numFitted++ ] = p[r.from];
+
+            if ( r.to != r.from )
+                fittedPoints[ numFitted++ ] = p[r.to];
+
+            lastIndex = r.to;
+        }
+        else
+        {
+            stack.append( QwtWeedingLine( nVertexIndexMaxDistance, r.to ) );
+            stack.append( QwtWeedingLine( r.from, nVertexIndexMaxDistance ) );
+        }
+    }
+
+    return numFitted;
+}
+
+static void qwtSimplifyChunks( const QwtWeedingJob *job,
+    int fromChunk, int toChunk )
+{
+    for ( int i = fromChunk; i <= toChunk; i++ )
+    {
+        const int from = i * job->chunkSize;
+        const int numPoints = qMin( job->chunkSize, job->numPoints - from );
+
+        // the fitted points of a chunk are written to the position
+        // of the chunk, as they never need more space than the chunk itself
+
+        if ( !job->isReimplemented )
+        {
+            job->numFitted[i] = qwtSimplify( job->points + from, numPoints,
+                job->toleranceSqr, job->fittedPoints + from );
+
+            continue;
+        }
+
+        QPolygonF chunk( numPoints );
+        ::memcpy( chunk.data(), job->points + from,
+            numPoints * sizeof( QPointF ) );
+
+        const QPolygonF fitted = job->simplify( chunk );
+
+        const int numFitted = qMin( fitted.size(), numPoints );
+        if ( numFitted > 0 )
+        {
+            ::memcpy( job->fittedPoints + from, fitted.constData(),
+                numFitted * sizeof( QPointF ) );
+        }
+
+        job->numFitted[i] = numFitted;
+    }
+}
+
 /*!
    Constructor
 
@@ -77,6 +252,7 @@ QwtWeedingCurveFitter::~QwtWeedingCurveFitter()
 void QwtWeedingCurveFitter::setTolerance( double tolerance )
 {
     d_data->tolerance = qMax( tolerance, 0.0 );
+    d_data->invalidateCache();
 }
 
 /*!
@@ -105,6 +281,7 @@ void QwtWeedingCurveFitter::setChunkSize( uint numPoints )
         numPoints = qMax( numPoints, 3U );
 
     d_data->chunkSize = numPoints;
+    d_data->invalidateCache();
 }
 
 /*!
@@ -119,123 +296,227 @@ uint QwtWeedingCurveFitter::chunkSize() const
 }
 
 /*!
-  \param points Series of data points
-  \return Curve points
-   \sa fitCurvePath()
+ Set the number of threads for processing the chunks
+
+ The chunks ( see setChunkSize() ) are independent from each other
+ and are processed in parallel by the global thread pool. Without
+ a chunk size the algorithm runs in the calling thread.
+
+ \param numThreads Number of threads. If numThreads is set to 0,
+                   the system specific ideal thread count is used.
+                   The default setting is 1.
+
+ \note The threads are only available for Qt versions supporting QtConcurrent
+ \sa threadCount(), setChunkSize()
 */
-QPolygonF QwtWeedingCurveFitter::fitCurve( const QPolygonF &points ) const
+void QwtWeedingCurveFitter::setThreadCount( uint numThreads )
 {
-    QPolygonF fittedPoints;
+    d_data->threadCount = numThreads;
+}
 
-    if ( d_data->chunkSize == 0 )
-    {
-        fittedPoints = simplify( points );
-    }
-    else
-    {
-        for ( int i = 0; i < points.size(); i += d_data->chunkSize )
-        {
-            const QPolygonF p = points.mid( i, d_data->chunkSize );
-            fittedPoints += simplify( p );
-        }
-    }
+/*!
+  \return Number of threads for processing the chunks
+  \sa setThreadCount()
+*/
+uint QwtWeedingCurveFitter::threadCount() const
+{
+    return d_data->threadCount;
+}
 
-    return fittedPoints;
+/*!
+ En/Disable the incremental mode
+
+ In incremental mode the fitted points of the chunks, that have been
+ completed, are kept for the next call of fitCurve(). When the next polygon
+ starts with the same points - f.e. because new points have been
+ appended to a trace - only the following chunks are processed again.
+
+ The incremental mode needs a chunk size ( see setChunkSize() ).
+
+ \param on On/Off
+
+ \warning The incremental mode is intended for polygons, where points
+          are only appended. Only the first and the last point of the completed
+          chunks are compared to find out, if the fitted points can be reused.
+ \sa isIncremental(), setChunkSize()
+*/
+void QwtWeedingCurveFitter::setIncremental( bool on )
+{
+    d_data->incremental = on;
+    d_data->invalidateCache();
 }
 
 /*!
-  \param points Series of data points
-  \return Curve path
-  \sa fitCurve()
+  \return True, when the incremental mode is enabled
+  \sa setIncremental()
 */
-QPainterPath QwtWeedingCurveFitter::fitCurvePath( const QPolygonF &points ) const
+bool QwtWeedingCurveFitter::isIncremental() const
 {
-    QPainterPath path;
-    path.addPolygon( fitCurve( points ) );
-    return path;
+    return d_data->incremental;
 }
 
-QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
+/*!
+  \param points Series of data points
+  \return Curve points
+   \sa fitCurvePath()
+*/
+QPolygonF QwtWeedingCurveFitter::fitCurve( const QPolygonF &points ) const
 {
-    const double toleranceSqr = d_data->tolerance * d_data->tolerance;
+    const int numPoints = points.size();
+    const int chunkSize = static_cast<int>( d_data->chunkSize );
 
-    QStack<Line> stack;
-    stack.reserve( 500 );
+    if ( chunkSize == 0 )
+        return simplify( points );
 
-    const QPointF *p = points.data();
-    const int nPoints = points.size();
+    int from = 0;
+    int numFitted = 0;
 
-    QVector<bool> usePoint( nPoints, false );
+    if ( d_data->incremental )
+    {
+        const int n = d_data->numCachedPoints;
+        if ( n > 0 && n <= numPoints
+            && points[0] == d_data->firstPoint
+            && points[n - 1] == d_data->lastPoint )
+        {
+            from = n;
+            numFitted = d_data->numCachedFitted;
+        }
+    }
 
-    stack.push( Line( 0, nPoints - 1 ) );
+    const int numChunks = ( numPoints - from + chunkSize - 1 ) / chunkSize;
 
-    while ( !stack.isEmpty() )
+    QPolygonF fittedPoints( numFitted + numPoints - from );
+    QPointF *fitted = fittedPoints.data();
+
+    if ( numFitted > 0 )
     {
-        const Line r = stack.pop();
+        ::memcpy( fitted, d_data->fittedPoints.constData(),
+            numFitted * sizeof( QPointF ) );
+    }
 
-        // initialize line segment
-        const double vecX = p[r.to].x() - p[r.from].x();
-        const double vecY = p[r.to].y() - p[r.from].y();
+    QVector<int> numChunkPoints( numChunks );
 
-        const double vecLength = qSqrt( vecX * vecX + vecY * vecY );
+    QwtWeedingJob job;
+    job.fitter = this;
+    job.isReimplemented = ( typeid( *this ) != typeid( QwtWeedingCurveFitter ) );
+    job.toleranceSqr = d_data->tolerance * d_data->tolerance;
+    job.points = points.constData() + from;
+    job.numPoints = numPoints - from;
+    job.chunkSize = chunkSize;
+    job.fittedPoints = fitted + numFitted;
+    job.numFitted = numChunkPoints.data();
 
-        const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
-        const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+#if QWT_USE_THREADS
+    uint numThreads = d_data->threadCount;
+    if ( numThreads == 0 )
+        numThreads = QThread::idealThreadCount();
 
-        double maxDistSqr = 0.0;
-        int nVertexIndexMaxDistance = r.from + 1;
-        for ( int i = r.from + 1; i < r.to; i++ )
-        {
-            //compare to anchor
-            const double fromVecX = p[i].x() - p[r.from].x();
-            const double fromVecY = p[i].y() - p[r.from].y();
+    numThreads = qBound( 1, numChunks, static_cast<int>( numThreads ) );
 
-            double distToSegmentSqr;
-            if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
+    if ( numThreads > 1 )
+    {
+        const int chunksPerThread = numChunks / numThreads;
+
+        QList< QFuture<void> > futures;
+        for ( uint i = 0; i < numThreads; i++ )
+        {
+            const int fromChunk = i * chunksPerThread;
+            if ( i == numThreads - 1 )
             {
-                distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
+                qwtSimplifyChunks( &job, fromChunk, numChunks - 1 );
             }
             else
             {
-                const double toVecX = p[i].x() - p[r.to].x();
-                const double toVecY = p[i].y() - p[r.to].y();
-                const double toVecLength = toVecX * toVecX + toVecY * toVecY;
-
-                const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
-                if ( s < 0.0 )
-                {
-                    distToSegmentSqr = toVecLength;
-                }
-                else
-                {
-                    distToSegmentSqr = qFabs( toVecLength - s * s );
-                }
-            }
-
-            if ( maxDistSqr < distToSegmentSqr )
-            {
-                maxDistSqr = distToSegmentSqr;
-                nVertexIndexMaxDistance = i;
+                futures += QtConcurrent::run( &qwtSimplifyChunks,
+                    &job, fromChunk, fromChunk + chunksPerThread - 1 );
             }
         }
-        if ( maxDistSqr <= toleranceSqr )
+
+        for ( int i = 0; i < futures.size(); i++ )
+            futures[i].waitForFinished();
+    }
+    else
+#endif
+    {
+        qwtSimplifyChunks( &job, 0, numChunks - 1 );
+    }
+
+    // moving the fitted points of each chunk behind the previous chunk
+
+    const int offset = numFitted;
+
+    int numCompletedPoints = from;
+    int numCompletedFitted = numFitted;
+
+    for ( int i = 0; i < numChunks; i++ )
+    {
+        const int pos = offset + i * chunkSize;
+        if ( pos != numFitted )
         {
-            usePoint[r.from] = true;
-            usePoint[r.to] = true;
+            ::memmove( fitted + numFitted, fitted + pos,
+                numChunkPoints[i] * sizeof( QPointF ) );
         }
-        else
+
+        numFitted += numChunkPoints[i];
+
+        if ( ( i + 1 ) * chunkSize <= job.numPoints )
         {
-            stack.push( Line( r.from, nVertexIndexMaxDistance ) );
-            stack.push( Line( nVertexIndexMaxDistance, r.to ) );
+            numCompletedPoints += chunkSize;
+            numCompletedFitted = numFitted;
         }
     }
 
-    QPolygonF stripped;
-    for ( int i = 0; i < nPoints; i++ )
+    fittedPoints.resize( numFitted );
+
+    if ( d_data->incremental )
     {
-        if ( usePoint[i] )
-            stripped += p[i];
+        d_data->fittedPoints = fittedPoints;
+        d_data->numCachedPoints = numCompletedPoints;
+        d_data->numCachedFitted = numCompletedFitted;
+
+        if ( numCompletedPoints > 0 )
+        {
+            d_data->firstPoint = points[0];
+            d_data->lastPoint = points[numCompletedPoints - 1];
+        }
     }
 
+    return fittedPoints;
+}
+
+/*!
+  \param points Series of data points
+  \return Curve path
+  \sa fitCurve()
+*/
+QPainterPath QwtWeedingCurveFitter::fitCurvePath( const QPolygonF &points ) const
+{
+    QPainterPath path;
+    path.addPolygon( fitCurve( points ) );
+    return path;
+}
+
+/*!
+  Simplify a polygon ( or a chunk of it ) by the Douglas-Peucker algorithm
+
+  \param points Series of data points
+  \return Subset of the points
+
+  \note For classes derived from QwtWeedingCurveFitter fitCurve() calls
+        simplify() for each chunk, otherwise the chunks are simplified
+        in place. When running in parallel ( setThreadCount() ) the chunks
+        are processed in worker threads, so a reimplementation has
+        to be reentrant.
+*/
+QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
+{
+    const double toleranceSqr = d_data->tolerance * d_data->tolerance;
+
+    QPolygonF stripped( points.size() );
+
+    const int numPoints = qwtSimplify( points.constData(), points.size(),
+        toleranceSqr, stripped.data() );
+
+    stripped.resize( numPoints );
     return stripped;
 }
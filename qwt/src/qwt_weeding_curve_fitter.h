@@ -34,6 +34,11 @@
   the number of points. By adjusting the tolerance parameter according to the
   axis scales QwtSplineCurveFitter can be used to implement different
   level of details to speed up painting of curves of many points.
+
+  As the chunks are independent from each other they can be processed
+  in parallel ( setThreadCount() ). For series, where points are only appended,
+  the incremental mode ( setIncremental() ) runs the algorithm only for
+  the chunks at the end, that have not been completed before.
 */
 class QWT_EXPORT QwtWeedingCurveFitter: public QwtCurveFitter
 {
@@ -47,13 +52,19 @@ public:
     void setChunkSize( uint );
     uint chunkSize() const;
 
+    void setThreadCount( uint numThreads );
+    uint threadCount() const;
+
+    void setIncremental( bool on );
+    bool isIncremental() const;
+
     virtual QPolygonF fitCurve( const QPolygonF & ) const;
     virtual QPainterPath fitCurvePath( const QPolygonF & ) const;
 
 private:
-    virtual QPolygonF simplify( const QPolygonF & ) const;
+    friend class QwtWeedingJob;
 
-    class Line;
+    virtual QPolygonF simplify( const QPolygonF & ) const;
 
     class PrivateData;
     PrivateData *d_data;
@@ -145,6 +145,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_point_mapper.h \
         qwt_raster_data.h \
         qwt_matrix_raster_data.h \
+        qwt_ring_buffer_raster_data.h \
         qwt_sampling_thread.h \
         qwt_samples.h \
         qwt_series_data.h \
@@ -196,6 +197,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_point_mapper.cpp \
         qwt_raster_data.cpp \
         qwt_matrix_raster_data.cpp \
+        qwt_ring_buffer_raster_data.cpp \
         qwt_sampling_thread.cpp \
         qwt_series_data.cpp \
         qwt_point_data.cpp \
@@ -0,0 +1,236 @@
+#include <qwt_plot.h>
+#include <qwt_plot_curve.h>
+#include <qwt_plot_grid.h>
+#include <qwt_plot_marker.h>
+#include <qapplication.h>
+#include <qpainter.h>
+#include <qimage.h>
+#include <qvector.h>
+#include <qdebug.h>
+
+// a curve, that counts how often it has been painted
+
+class CountingCurve: public QwtPlotCurve
+{
+public:
+    CountingCurve():
+        numDraws( 0 )
+    {
+        setPen( QColor( Qt::darkBlue ), 2.0 );
+    }
+
+    virtual void draw( QPainter *painter,
+        const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QRectF &canvasRect ) const
+    {
+        numDraws++;
+        QwtPlotCurve::draw( painter, xMap, yMap, canvasRect );
+    }
+
+    mutable int numDraws;
+};
+
+static QVector<QPointF> curvePoints( double offset )
+{
+    QVector<QPointF> points;
+    for ( int i = 0; i <= 100; i++ )
+        points += QPointF( i, offset + ( qrand() % 100 ) * 0.1 );
+
+    return points;
+}
+
+class Scene
+{
+public:
+    enum { NumCurves = 4 };
+
+    Scene( bool cached )
+    {
+        plot = new QwtPlot();
+        plot->resize( 600, 400 );
+        plot->setAxisScale( QwtPlot::xBottom, 0.0, 100.0 );
+        plot->setAxisScale( QwtPlot::yLeft, 0.0, 50.0 );
+        plot->updateLayout();
+
+        grid = new QwtPlotGrid();
+        grid->setPen( QColor( Qt::gray ) );
+        grid->attach( plot );
+
+        for ( int i = 0; i < NumCurves; i++ )
+        {
+            curves[i] = new CountingCurve();
+            curves[i]->setZ( 10 + i );
+            curves[i]->attach( plot );
+        }
+
+        marker = new QwtPlotMarker();
+        marker->setLineStyle( QwtPlotMarker::HLine );
+        marker->setLinePen( QColor( Qt::red ), 3.0 );
+        marker->setValue( 0.0, 25.0 );
+        marker->setZ( 20 );
+        marker->attach( plot );
+
+        if ( cached )
+        {
+            // the third curve is a live curve, that splits
+            // the slow layer into 2 runs
+
+            grid->setCacheLayer( QwtPlotItem::StaticLayer );
+            curves[0]->setCacheLayer( QwtPlotItem::SlowLayer );
+            curves[1]->setCacheLayer( QwtPlotItem::SlowLayer );
+            curves[3]->setCacheLayer( QwtPlotItem::SlowLayer );
+            marker->setCacheLayer( QwtPlotItem::StaticLayer );
+        }
+    }
+
+    ~Scene()
+    {
+        delete plot;
+    }
+
+    QImage render()
+    {
+        for ( int i = 0; i < NumCurves; i++ )
+            numDraws[i] = curves[i]->numDraws;
+
+        QImage image( plot->canvas()->size(), QImage::Format_ARGB32 );
+        image.fill( 0xffffffff );
+
+        QPainter painter( &image );
+        plot->drawCanvas( &painter );
+        painter.end();
+
+        for ( int i = 0; i < NumCurves; i++ )
+            numDraws[i] = curves[i]->numDraws - numDraws[i];
+
+        // the pixmaps of the cache are limited to the canvas
+        // rectangle, while items might paint beyond
+
+        return image.copy( plot->canvas()->contentsRect() );
+    }
+
+    QwtPlot *plot;
+    QwtPlotGrid *grid;
+    CountingCurve *curves[NumCurves];
+    QwtPlotMarker *marker;
+
+    // number of draw calls of the last render()
+    int numDraws[NumCurves];
+};
+
+static int compareScenes( const char *step, Scene &scene, Scene &refScene,
+    const QString &expectedDraws )
+{
+    int numErrors = 0;
+
+    if ( scene.render() != refScene.render() )
+    {
+        qDebug() << step << ": cached rendering differs";
+        numErrors++;
+    }
+
+    // "x" for curves, that have to be painted, "-" for
+    // curves, that are taken from the cache
+
+    QString draws;
+    for ( int i = 0; i < Scene::NumCurves; i++ )
+        draws += ( scene.numDraws[i] > 0 ) ? 'x' : '-';
+
+    if ( draws != expectedDraws )
+    {
+        qDebug() << step << ": painted curves:" << draws
+            << "expected:" << expectedDraws;
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+int main( int argc, char **argv )
+{
+    QApplication app( argc, argv );
+
+    qsrand( 0 );
+
+    Scene scene( true );
+    Scene refScene( false );
+
+    for ( int i = 0; i < Scene::NumCurves; i++ )
+    {
+        const QVector<QPointF> points = curvePoints( 10.0 * i );
+
+        scene.curves[i]->setSamples( points );
+        refScene.curves[i]->setSamples( points );
+    }
+
+    int numErrors = 0;
+
+    numErrors += compareScenes( "Initial", scene, refScene, "xxxx" );
+    numErrors += compareScenes( "Unchanged", scene, refScene, "--x-" );
+
+    // a changed item invalidates all runs of its layer
+
+    const QVector<QPointF> points = curvePoints( 5.0 );
+    scene.curves[0]->setSamples( points );
+    refScene.curves[0]->setSamples( points );
+
+    numErrors += compareScenes( "Slow layer", scene, refScene, "xxxx" );
+
+    scene.marker->setValue( 0.0, 40.0 );
+    refScene.marker->setValue( 0.0, 40.0 );
+
+    numErrors += compareScenes( "Static layer", scene, refScene, "--x-" );
+
+    // items without a cache layer don't invalidate anything
+
+    const QVector<QPointF> livePoints = curvePoints( 20.0 );
+    scene.curves[2]->setSamples( livePoints );
+    refScene.curves[2]->setSamples( livePoints );
+
+    numErrors += compareScenes( "Live curve", scene, refScene, "--x-" );
+
+    // different scales invalidate all layers
+
+    scene.plot->setAxisScale( QwtPlot::yLeft, 10.0, 40.0 );
+    scene.plot->updateAxes();
+    refScene.plot->setAxisScale( QwtPlot::yLeft, 10.0, 40.0 );
+    refScene.plot->updateAxes();
+
+    numErrors += compareScenes( "Scales", scene, refScene, "xxxx" );
+
+    // a different geometry invalidates all layers
+
+    scene.plot->resize( 500, 300 );
+    scene.plot->updateLayout();
+    refScene.plot->resize( 500, 300 );
+    refScene.plot->updateLayout();
+
+    numErrors += compareScenes( "Geometry", scene, refScene, "xxxx" );
+
+    // hiding an item changes the run of its layer
+
+    scene.curves[1]->setVisible( false );
+    refScene.curves[1]->setVisible( false );
+
+    numErrors += compareScenes( "Hidden", scene, refScene, "x-xx" );
+
+    // an explicit invalidation, f.e. after changes without itemChanged()
+
+    scene.plot->invalidateCacheLayer( QwtPlotItem::SlowLayer );
+    numErrors += compareScenes( "Invalidated", scene, refScene, "x-xx" );
+
+    // without cache layers the items are painted directly
+
+    for ( int i = 0; i < Scene::NumCurves; i++ )
+        scene.curves[i]->setCacheLayer( QwtPlotItem::NoCacheLayer );
+
+    scene.grid->setCacheLayer( QwtPlotItem::NoCacheLayer );
+    scene.marker->setCacheLayer( QwtPlotItem::NoCacheLayer );
+
+    numErrors += compareScenes( "No layers", scene, refScene, "x-xx" );
+    numErrors += compareScenes( "No layers", scene, refScene, "x-xx" );
+
+    qDebug() << "Cache layers:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
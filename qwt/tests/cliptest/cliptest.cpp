@@ -0,0 +1,353 @@
+#include <qwt_clipper.h>
+#include <qwt_point_mapper.h>
+#include <qwt_point_data.h>
+#include <qwt_scale_map.h>
+#include <qpolygon.h>
+#include <qrect.h>
+#include <qdebug.h>
+#include <qmath.h>
+
+// hiding the span, so that the mapper has to
+// use the virtual QwtSeriesData::sample()
+
+class VirtualData: public QwtSeriesData<QPointF>
+{
+public:
+    VirtualData( const QwtSeriesData<QPointF> *data ):
+        d_data( data )
+    {
+    }
+
+    virtual size_t size() const
+    {
+        return d_data->size();
+    }
+
+    virtual QPointF sample( size_t i ) const
+    {
+        return d_data->sample( i );
+    }
+
+    virtual QRectF boundingRect() const
+    {
+        return d_data->boundingRect();
+    }
+
+private:
+    const QwtSeriesData<QPointF> *d_data;
+};
+
+static QPolygonF randomPolygon( int numPoints )
+{
+    QPolygonF points;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        // some of the points are exactly on the border
+
+        const double x = ( qrand() % 160 ) - 20 + ( qrand() % 2 ) * 0.25;
+        const double y = ( qrand() % 100 ) + ( qrand() % 2 ) * 0.5;
+
+        points += QPointF( x, y );
+    }
+
+    return points;
+}
+
+static double polygonArea( const QPolygonF &polygon )
+{
+    double area = 0.0;
+
+    for ( int i = 0; i < polygon.size(); i++ )
+    {
+        const QPointF &p1 = polygon[i];
+        const QPointF &p2 = polygon[ ( i + 1 ) % polygon.size() ];
+
+        area += p1.x() * p2.y() - p2.x() * p1.y();
+    }
+
+    return 0.5 * area;
+}
+
+static int testClipper( const QRectF &clipRect, const QPolygonF &points )
+{
+    int numErrors = 0;
+
+    for ( int closed = 0; closed <= 1; closed++ )
+    {
+        const QPolygonF clipped =
+            QwtClipper::clipPolygonF( clipRect, points, closed );
+
+        QPolygonF inPlace = points;
+        QwtClipper::clipPolygonF( clipRect, inPlace, inPlace, closed );
+
+        if ( inPlace != clipped )
+        {
+            qDebug() << "in place clipping differs:" << points.size()
+                << ( closed ? "closed" : "open" );
+            numErrors++;
+        }
+
+        QPolygonF streamed;
+        {
+            QwtPolygonClipperF clipper( clipRect, streamed, closed );
+
+            int i = 0;
+            while ( i < points.size() )
+            {
+                const int numChunkPoints =
+                    qMin( 1 + qrand() % 5, points.size() - i );
+
+                clipper.addPoints( points.constData() + i, numChunkPoints );
+                i += numChunkPoints;
+            }
+
+            clipper.finish();
+        }
+
+        if ( streamed != clipped )
+        {
+            qDebug() << "streamed clipping differs:" << points.size()
+                << ( closed ? "closed" : "open" );
+            numErrors++;
+        }
+    }
+
+    // a single point is never clipped, so filled
+    // curves are clipped from 2 points on only
+
+    if ( points.size() < 2 )
+        return numErrors;
+
+    // the closing points of a filled curve
+
+    QPointF closingPoints[2];
+    closingPoints[0] = QPointF( 130.0, 200.0 );
+    closingPoints[1] = QPointF( -30.0, 200.0 );
+
+    QPolygonF closedPolygon = points;
+    closedPolygon += closingPoints[0];
+    closedPolygon += closingPoints[1];
+
+    QPolygonF filled;
+    const int outlineSize = QwtClipper::clipFilledPolygonF( clipRect,
+        points, closingPoints, 2, filled );
+
+    if ( filled.mid( 0, outlineSize ) !=
+        QwtClipper::clipPolygonF( clipRect, points, false ) )
+    {
+        qDebug() << "outline of the filled polygon differs:" << points.size();
+        numErrors++;
+    }
+
+    // the filled polygon might start at a different point
+
+    const double area = polygonArea(
+        QwtClipper::clipPolygonF( clipRect, closedPolygon, true ) );
+
+    if ( qAbs( polygonArea( filled ) - area ) > 1e-6 )
+    {
+        qDebug() << "area of the filled polygon differs:" << points.size();
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+static double visibleLength( const QRectF &clipRect,
+    const QPointF &p1, const QPointF &p2 )
+{
+    // Liang-Barsky for a single line
+
+    const double dx = p2.x() - p1.x();
+    const double dy = p2.y() - p1.y();
+
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] =
+    {
+        p1.x() - clipRect.left(), clipRect.right() - p1.x(),
+        p1.y() - clipRect.top(), clipRect.bottom() - p1.y()
+    };
+
+    double t1 = 0.0;
+    double t2 = 1.0;
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        if ( p[i] == 0.0 )
+        {
+            if ( q[i] < 0.0 )
+                return 0.0;
+        }
+        else
+        {
+            const double t = q[i] / p[i];
+            if ( p[i] < 0.0 )
+                t1 = qMax( t1, t );
+            else
+                t2 = qMin( t2, t );
+        }
+    }
+
+    if ( t1 > t2 )
+        return 0.0;
+
+    return ( t2 - t1 ) * qSqrt( dx * dx + dy * dy );
+}
+
+static int testSplitter( const QRectF &clipRect, const QPolygonF &points )
+{
+    QPolygonF runs;
+    QVector<int> runSizes;
+    QwtClipper::splitPolylineF( clipRect, points, runs, runSizes );
+
+    const QRectF rect = clipRect.adjusted( -1e-6, -1e-6, 1e-6, 1e-6 );
+
+    int numErrors = 0;
+    int numRunPoints = 0;
+
+    double length = 0.0;
+
+    for ( int i = 0; i < runSizes.size(); i++ )
+    {
+        if ( runSizes[i] < 2 && points.size() > 1 )
+        {
+            qDebug() << "run with less than 2 points:" << points.size();
+            numErrors++;
+        }
+
+        for ( int j = numRunPoints; j < numRunPoints + runSizes[i]; j++ )
+        {
+            if ( !rect.contains( runs[j] ) )
+            {
+                qDebug() << "run outside of the clip rectangle:" << points.size();
+                numErrors++;
+            }
+
+            if ( j > numRunPoints )
+            {
+                const double dx = runs[j].x() - runs[j - 1].x();
+                const double dy = runs[j].y() - runs[j - 1].y();
+
+                length += qSqrt( dx * dx + dy * dy );
+            }
+        }
+
+        numRunPoints += runSizes[i];
+    }
+
+    if ( numRunPoints != runs.size() )
+    {
+        qDebug() << "run sizes don't match the runs:" << points.size();
+        numErrors++;
+    }
+
+    double expectedLength = 0.0;
+    for ( int i = 1; i < points.size(); i++ )
+        expectedLength += visibleLength( clipRect, points[i - 1], points[i] );
+
+    if ( qAbs( length - expectedLength ) > 1e-6 )
+    {
+        qDebug() << "visible length of the runs differs:" << points.size();
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+static int testMapper( const char *name, const QRectF &clipRect,
+    QwtPointMapper::TransformationFlags flags,
+    const QwtSeriesData<QPointF> *data )
+{
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( 0.0, data->size() );
+    xMap.setPaintInterval( 0, 1000 );
+
+    QwtScaleMap yMap;
+    yMap.setScaleInterval( -20.0, 20.0 );
+    yMap.setPaintInterval( 800, 0 );
+
+    const int to = static_cast<int>( data->size() ) - 1;
+
+    QwtPointMapper mapper;
+    mapper.setFlags( flags );
+
+    const QPolygonF clipped = QwtClipper::clipPolygonF( clipRect,
+        mapper.toPolygonF( xMap, yMap, data, 0, to ) );
+
+    mapper.setClipRect( clipRect );
+
+    const VirtualData virtualData( data );
+
+    int numErrors = 0;
+
+    if ( mapper.toPolygonF( xMap, yMap, data, 0, to ) != clipped )
+    {
+        qDebug() << name << ": fused clipping differs ( span )";
+        numErrors++;
+    }
+
+    if ( mapper.toPolygonF( xMap, yMap, &virtualData, 0, to ) != clipped )
+    {
+        qDebug() << name << ": fused clipping differs ( virtual )";
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+static int testClipping()
+{
+    const QRectF clipRect( 10.0, 20.0, 100.0, 50.0 );
+
+    int numErrors = 0;
+
+    for ( int i = 0; i < 10000; i++ )
+    {
+        const QPolygonF points = randomPolygon( qrand() % 20 );
+
+        numErrors += testClipper( clipRect, points );
+        numErrors += testSplitter( clipRect, points );
+    }
+
+    // a random walk, that leaves and reenters the canvas
+
+    const int numPoints = 100000;
+
+    QVector<double> x( numPoints );
+    QVector<double> y( numPoints );
+
+    double value = 0.0;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        value += ( qrand() % 201 - 100 ) * 0.01;
+
+        x[i] = i;
+        y[i] = value;
+    }
+
+    const QwtPointArrayData data( x, y );
+    const QRectF canvasRect( 100.0, 100.0, 800.0, 600.0 );
+
+    numErrors += testMapper( "Plain", canvasRect, 0, &data );
+
+    numErrors += testMapper( "Weeded", canvasRect,
+        QwtPointMapper::WeedOutPoints, &data );
+
+    numErrors += testMapper( "Rounded", canvasRect,
+        QwtPointMapper::RoundPoints | QwtPointMapper::WeedOutPoints, &data );
+
+    return numErrors;
+}
+
+int main()
+{
+    qsrand( 0 );
+
+    int numErrors = 0;
+    numErrors += testClipping();
+
+    qDebug() << "Clipping:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include <qwt_plot.h>
+#include <qwt_plot_curve.h>
+#include <qwt_scale_engine.h>
+#include <qapplication.h>
+#include <qvector.h>
+#include <qnumeric.h>
+#include <qdebug.h>
+
+static double randomValue( double min, double max )
+{
+    return min + ( max - min ) * ( qrand() % 10001 ) / 10000.0;
+}
+
+static QVector<QPointF> sortedPoints( int numPoints )
+{
+    // a random walk with increasing x coordinates,
+    // where some of the x coordinates are duplicates
+
+    QVector<QPointF> points( numPoints );
+
+    double x = 0.0;
+    double y = 500.0;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        if ( qrand() % 10 != 0 )
+            x += randomValue( 0.0, 0.2 );
+
+        y = qBound( 1.0, y + randomValue( -5.0, 5.0 ), 1000.0 );
+
+        points[i] = QPointF( x, y );
+    }
+
+    return points;
+}
+
+static QVector<QPointF> scatteredPoints( int numPoints )
+{
+    // some clusters and a couple of outliers
+
+    QVector<QPointF> points( numPoints );
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        if ( qrand() % 100 == 0 )
+        {
+            points[i] = QPointF( randomValue( 0.0, 1000.0 ),
+                randomValue( 1.0, 1000.0 ) );
+        }
+        else
+        {
+            const double cx = 100.0 * ( qrand() % 10 );
+            const double cy = 100.0 * ( 1 + qrand() % 9 );
+
+            points[i] = QPointF( cx + randomValue( 0.0, 20.0 ),
+                cy + randomValue( 0.0, 20.0 ) );
+        }
+    }
+
+    return points;
+}
+
+static void addGaps( QVector<QPointF> &points )
+{
+    for ( int i = 0; i < 20; i++ )
+    {
+        QPointF &point = points[ qrand() % points.size() ];
+        point.setY( qQNaN() );
+    }
+}
+
+static int testClosestPoint( const char *name, QwtPlot *plot,
+    QwtPlotCurve *curve, QwtPlotCurve *indexedCurve )
+{
+    const QRect rect = plot->canvas()->contentsRect().adjusted(
+        -100, -100, 100, 100 );
+
+    int numErrors = 0;
+
+    for ( int i = 0; i < 1000; i++ )
+    {
+        const QPoint pos( rect.left() + qrand() % rect.width(),
+            rect.top() + qrand() % rect.height() );
+
+        double dist = 0.0;
+        const int index = curve->closestPoint( pos, &dist );
+
+        double indexedDist = 0.0;
+        const int indexedIndex = indexedCurve->closestPoint( pos, &indexedDist );
+
+        // points with the same distance might be found in a different order
+
+        if ( indexedIndex != index &&
+            ( indexedIndex < 0 || qAbs( indexedDist - dist ) > 1e-9 ) )
+        {
+            qDebug() << name << ": closest points differ:" << pos
+                << index << dist << indexedIndex << indexedDist;
+            numErrors++;
+        }
+    }
+
+    return numErrors;
+}
+
+static int testSamples( const char *name, QwtPlot *plot,
+    const QVector<QPointF> &points )
+{
+    QwtPlotCurve curve;
+    curve.setSamples( points );
+    curve.attach( plot );
+
+    QwtPlotCurve indexedCurve;
+    indexedCurve.setClosestPointIndexEnabled( true );
+    indexedCurve.setSamples( points );
+    indexedCurve.attach( plot );
+
+    int numErrors = 0;
+
+    plot->setAxisScaleEngine( QwtPlot::yLeft, new QwtLinearScaleEngine() );
+    plot->setAxisScale( QwtPlot::xBottom, 0.0, 1000.0 );
+    plot->setAxisScale( QwtPlot::yLeft, 0.0, 1000.0 );
+    plot->replot();
+
+    numErrors += testClosestPoint( name, plot, &curve, &indexedCurve );
+
+    // the index is independent of the scales
+
+    plot->setAxisScale( QwtPlot::xBottom, 300.0, 200.0 );
+    plot->setAxisScale( QwtPlot::yLeft, 400.0, 600.0 );
+    plot->replot();
+
+    numErrors += testClosestPoint( name, plot, &curve, &indexedCurve );
+
+    plot->setAxisScaleEngine( QwtPlot::yLeft, new QwtLogScaleEngine() );
+    plot->setAxisScale( QwtPlot::xBottom, 0.0, 1000.0 );
+    plot->setAxisScale( QwtPlot::yLeft, 1.0, 1000.0 );
+    plot->replot();
+
+    numErrors += testClosestPoint( name, plot, &curve, &indexedCurve );
+
+    // new samples of the same size have to invalidate the index
+
+    QVector<QPointF> shiftedPoints = points;
+    for ( int i = 0; i < shiftedPoints.size(); i++ )
+        shiftedPoints[i] += QPointF( 50.0, 10.0 );
+
+    curve.setSamples( shiftedPoints );
+    indexedCurve.setSamples( shiftedPoints );
+
+    numErrors += testClosestPoint( name, plot, &curve, &indexedCurve );
+
+    return numErrors;
+}
+
+int main( int argc, char **argv )
+{
+    QApplication app( argc, argv );
+
+    qsrand( 0 );
+
+    QwtPlot plot;
+    plot.resize( 800, 600 );
+    plot.updateLayout();
+
+    int numErrors = 0;
+
+    QVector<QPointF> points = sortedPoints( 20000 );
+    numErrors += testSamples( "Sorted", &plot, points );
+
+    addGaps( points );
+    numErrors += testSamples( "Sorted with gaps", &plot, points );
+
+    points = scatteredPoints( 20000 );
+    numErrors += testSamples( "Scattered", &plot, points );
+
+    addGaps( points );
+    numErrors += testSamples( "Scattered with gaps", &plot, points );
+
+    numErrors += testSamples( "Single", &plot, scatteredPoints( 1 ) );
+
+    qDebug() << "Closest point:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
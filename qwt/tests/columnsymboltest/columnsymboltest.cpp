@@ -0,0 +1,251 @@
+#include <qwt_column_symbol.h>
+#include <qwt_plot_barchart.h>
+#include <qwt_plot_histogram.h>
+#include <qwt_scale_map.h>
+#include <qapplication.h>
+#include <qpainter.h>
+#include <qpalette.h>
+#include <qimage.h>
+#include <qvector.h>
+#include <qdebug.h>
+
+static QImage newImage()
+{
+    QImage image( 1000, 400, QImage::Format_ARGB32 );
+    image.fill( 0xffffffff );
+
+    return image;
+}
+
+static QPalette columnPalette()
+{
+    QPalette palette;
+    palette.setColor( QPalette::Window, QColor( 200, 120, 40 ) );
+    palette.setColor( QPalette::Light, QColor( 250, 220, 180 ) );
+    palette.setColor( QPalette::Dark, QColor( 90, 40, 10 ) );
+
+    return palette;
+}
+
+static QVector<QwtColumnRect> randomColumns()
+{
+    // columns, that don't overlap. Their sizes are large enough
+    // for the frames, or 0, what results in lines
+
+    QVector<QwtColumnRect> columns;
+
+    double x = 5.0;
+    while ( x < 950.0 )
+    {
+        const double width = ( qrand() % 8 == 0 ) ? 0.0 : 10 + qrand() % 30;
+        const double height = ( qrand() % 8 == 0 ) ? 0.0 : 6 + qrand() % 300;
+
+        const double y = 350.0 + ( qrand() % 100 ) * 0.1;
+
+        const double x1 = ( width > 0.0 ) ? x + ( qrand() % 10 ) * 0.1 : x;
+
+        QwtColumnRect column;
+        column.hInterval = QwtInterval( x1, x + width );
+        column.vInterval = QwtInterval( y - height, y );
+
+        if ( width > 0.0 && qrand() % 4 == 0 )
+        {
+            column.hInterval.setBorderFlags(
+                QwtInterval::ExcludeMinimum | QwtInterval::ExcludeMaximum );
+        }
+
+        columns += column;
+
+        x += width + 4.0;
+    }
+
+    return columns;
+}
+
+static int testSymbol( const QVector<QwtColumnRect> &columns )
+{
+    const QwtColumnSymbol::FrameStyle frameStyles[] =
+    {
+        QwtColumnSymbol::NoFrame,
+        QwtColumnSymbol::Plain,
+        QwtColumnSymbol::Raised
+    };
+
+    int numErrors = 0;
+
+    for ( uint i = 0; i < sizeof( frameStyles ) / sizeof( frameStyles[0] ); i++ )
+    {
+        for ( int lineWidth = 0; lineWidth <= 2; lineWidth++ )
+        {
+            QwtColumnSymbol symbol( QwtColumnSymbol::Box );
+            symbol.setFrameStyle( frameStyles[i] );
+            symbol.setLineWidth( lineWidth );
+            symbol.setPalette( columnPalette() );
+
+            QImage image = newImage();
+            {
+                QPainter painter( &image );
+                for ( int j = 0; j < columns.size(); j++ )
+                    symbol.draw( &painter, columns[j] );
+            }
+
+            QImage batchedImage = newImage();
+            {
+                QPainter painter( &batchedImage );
+                symbol.drawColumns( &painter,
+                    columns.constData(), columns.size() );
+            }
+
+            if ( batchedImage != image )
+            {
+                qDebug() << "batched columns differ:"
+                    << frameStyles[i] << lineWidth;
+                numErrors++;
+            }
+        }
+    }
+
+    return numErrors;
+}
+
+static int testBarChart( QwtColumnSymbol *symbol )
+{
+    const int numBars = 50;
+
+    QVector<QPointF> samples;
+    for ( int i = 0; i < numBars; i++ )
+    {
+        const double value = 10 + qrand() % 140;
+        samples += QPointF( i, ( qrand() % 2 ) ? value : -value );
+    }
+
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( -1.0, numBars );
+    xMap.setPaintInterval( 0, 1000 );
+
+    QwtScaleMap yMap;
+    yMap.setScaleInterval( -200.0, 200.0 );
+    yMap.setPaintInterval( 400, 0 );
+
+    const QRectF canvasRect( 0.0, 0.0, 1000.0, 400.0 );
+
+    // bars of 12 pixels with a gap of ~8 pixels
+
+    QwtPlotBarChart chart;
+    chart.setLayoutPolicy( QwtPlotBarChart::FixedSampleSize );
+    chart.setLayoutHint( 12.0 );
+    chart.setSamples( samples );
+    chart.setSymbol( symbol );
+
+    QImage image = newImage();
+    {
+        QPainter painter( &image );
+        chart.draw( &painter, xMap, yMap, canvasRect );
+    }
+
+    chart.setPaintAttribute( QwtPlotBarChart::BatchedBars, true );
+
+    QImage batchedImage = newImage();
+    {
+        QPainter painter( &batchedImage );
+        chart.draw( &painter, xMap, yMap, canvasRect );
+    }
+
+    if ( batchedImage != image )
+    {
+        qDebug() << "batched bars differ:" << ( symbol != NULL );
+        return 1;
+    }
+
+    return 0;
+}
+
+static QImage histogramImage( const QVector<QwtIntervalSample> &samples,
+    QwtPlotHistogram::HistogramStyle style, bool batched )
+{
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( -1.0, 100.0 );
+    xMap.setPaintInterval( 0, 1000 );
+
+    QwtScaleMap yMap;
+    yMap.setScaleInterval( -200.0, 200.0 );
+    yMap.setPaintInterval( 400, 0 );
+
+    const QRectF canvasRect( 0.0, 0.0, 1000.0, 400.0 );
+
+    QwtPlotHistogram histogram;
+    histogram.setStyle( style );
+    histogram.setPen( QColor( Qt::darkBlue ) );
+    histogram.setBrush( QColor( Qt::yellow ) );
+    histogram.setPaintAttribute( QwtPlotHistogram::BatchedColumns, batched );
+    histogram.setSamples( samples );
+
+    QImage image = newImage();
+    {
+        QPainter painter( &image );
+        histogram.draw( &painter, xMap, yMap, canvasRect );
+    }
+
+    return image;
+}
+
+static int testHistogram( QwtPlotHistogram::HistogramStyle style )
+{
+    QVector<QwtIntervalSample> samples;
+    for ( int i = 0; i < 50; i++ )
+        samples += QwtIntervalSample( 10 + qrand() % 140, 2 * i, 2 * i + 1 );
+
+    // samples with null intervals, that must not be painted
+
+    QVector<QwtIntervalSample> nullSamples = samples;
+    for ( int i = 0; i < 10; i++ )
+    {
+        const double x = 0.1 * ( qrand() % 1000 );
+        nullSamples.insert( qrand() % nullSamples.size(),
+            QwtIntervalSample( 190.0, x, x ) );
+    }
+
+    int numErrors = 0;
+
+    for ( int batched = 0; batched <= 1; batched++ )
+    {
+        if ( histogramImage( nullSamples, style, batched ) !=
+            histogramImage( samples, style, batched ) )
+        {
+            qDebug() << "null intervals are painted:" << style << batched;
+            numErrors++;
+        }
+    }
+
+    return numErrors;
+}
+
+int main( int argc, char **argv )
+{
+    QApplication app( argc, argv );
+
+    qsrand( 0 );
+
+    int numErrors = 0;
+
+    for ( int i = 0; i < 10; i++ )
+        numErrors += testSymbol( randomColumns() );
+
+    // the default symbol of the bar chart
+
+    numErrors += testBarChart( NULL );
+
+    QwtColumnSymbol *symbol = new QwtColumnSymbol( QwtColumnSymbol::Box );
+    symbol->setFrameStyle( QwtColumnSymbol::Raised );
+    symbol->setLineWidth( 2 );
+    symbol->setPalette( columnPalette() );
+
+    numErrors += testBarChart( symbol );
+
+    numErrors += testHistogram( QwtPlotHistogram::Columns );
+    numErrors += testHistogram( QwtPlotHistogram::Lines );
+
+    qDebug() << "Column symbol:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
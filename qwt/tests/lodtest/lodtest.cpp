@@ -0,0 +1,256 @@
+#include <qwt_point_data.h>
+#include <qwt_series_data.h>
+#include <qvector.h>
+#include <qrect.h>
+#include <qdebug.h>
+
+// a series, where samples can be appended
+
+class GrowingData: public QwtSeriesData<QPointF>
+{
+public:
+    void append( const QPointF &point )
+    {
+        d_points += point;
+        d_boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
+    }
+
+    virtual size_t size() const
+    {
+        return d_points.size();
+    }
+
+    virtual QPointF sample( size_t i ) const
+    {
+        return d_points[ static_cast<int>( i ) ];
+    }
+
+    virtual QRectF boundingRect() const
+    {
+        if ( d_boundingRect.width() < 0.0 )
+            d_boundingRect = qwtBoundingRect( *this );
+
+        return d_boundingRect;
+    }
+
+private:
+    QVector<QPointF> d_points;
+};
+
+static void visibleRange( const QVector<QPointF> &points,
+    const QRectF &rect, int &from, int &to )
+{
+    // the same range as found by the binary search: the visible
+    // samples including one sample on each side
+
+    const int numSamples = points.size();
+
+    from = numSamples - 1;
+    for ( int i = 0; i < numSamples; i++ )
+    {
+        if ( points[i].x() > rect.left() )
+        {
+            from = i;
+            break;
+        }
+    }
+    from = qMax( from - 1, 0 );
+
+    to = numSamples - 1;
+    for ( int i = 0; i < numSamples; i++ )
+    {
+        if ( points[i].x() > rect.right() )
+        {
+            to = i;
+            break;
+        }
+    }
+}
+
+static int testSelection( const QVector<QPointF> &points,
+    QwtLevelOfDetailData &lod, const QRectF &rect )
+{
+    lod.setRectOfInterest( rect );
+
+    int from, to;
+    visibleRange( points, rect, from, to );
+
+    int numErrors = 0;
+
+    if ( lod.level() < 0 )
+    {
+        // no aggregation: the raw samples
+
+        bool ok = ( lod.size() == static_cast<size_t>( to - from + 1 ) );
+        for ( int i = from; ok && i <= to; i++ )
+            ok = ( lod.sample( i - from ) == points[i] );
+
+        if ( !ok )
+        {
+            qDebug() << "raw samples differ:" << rect;
+            numErrors++;
+        }
+
+        return numErrors;
+    }
+
+    // each bucket is represented by its first and last sample
+    // and the samples with the minimum and the maximum
+
+    const int bucketSize = 8 << lod.level();
+    const int numSamples = points.size();
+
+    const int j1 = from / bucketSize;
+    const int j2 = to / bucketSize;
+
+    size_t index = 0;
+
+    for ( int j = j1; j <= j2; j++ )
+    {
+        const int first = j * bucketSize;
+        const int last = qMin( first + bucketSize, numSamples ) - 1;
+
+        double yMin = points[first].y();
+        double yMax = yMin;
+
+        for ( int i = first + 1; i <= last; i++ )
+        {
+            yMin = qMin( yMin, points[i].y() );
+            yMax = qMax( yMax, points[i].y() );
+        }
+
+        QVector<QPointF> selected;
+        while ( index < lod.size() && lod.sample( index ).x() <= points[last].x() )
+            selected += lod.sample( index++ );
+
+        if ( selected.isEmpty() || selected.first() != points[first]
+            || selected.last() != points[last] )
+        {
+            qDebug() << "bounds of bucket" << j << "differ:" << rect;
+            numErrors++;
+            continue;
+        }
+
+        double lodMin = selected[0].y();
+        double lodMax = lodMin;
+
+        for ( int i = 1; i < selected.size(); i++ )
+        {
+            lodMin = qMin( lodMin, selected[i].y() );
+            lodMax = qMax( lodMax, selected[i].y() );
+        }
+
+        if ( lodMin != yMin || lodMax != yMax || selected.size() > 4 )
+        {
+            qDebug() << "extremes of bucket" << j << "differ:" << rect;
+            numErrors++;
+        }
+    }
+
+    if ( index != lod.size() )
+    {
+        qDebug() << "samples outside of the visible buckets:" << rect;
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+static int testIncremental( const QVector<QPointF> &points,
+    const QVector<QRectF> &rects )
+{
+    GrowingData *series = new GrowingData();
+    for ( int i = 0; i < 1000; i++ )
+        series->append( points[i] );
+
+    QwtLevelOfDetailData lod( series );
+    lod.setResolution( 500 );
+
+    int i = 1000;
+    while ( i < points.size() )
+    {
+        const int numAppended = qMin( 1 + qrand() % 5000, points.size() - i );
+
+        for ( int j = 0; j < numAppended; j++ )
+            series->append( points[i++] );
+
+        lod.updateLevels();
+    }
+
+    GrowingData *allPoints = new GrowingData();
+    for ( int i = 0; i < points.size(); i++ )
+        allPoints->append( points[i] );
+
+    QwtLevelOfDetailData rebuilt( allPoints );
+    rebuilt.setResolution( 500 );
+
+    int numErrors = 0;
+
+    for ( int i = 0; i < rects.size(); i++ )
+    {
+        lod.setRectOfInterest( rects[i] );
+        rebuilt.setRectOfInterest( rects[i] );
+
+        bool ok = ( lod.level() == rebuilt.level() )
+            && ( lod.size() == rebuilt.size() );
+
+        for ( size_t j = 0; ok && j < lod.size(); j++ )
+            ok = ( lod.sample( j ) == rebuilt.sample( j ) );
+
+        if ( !ok )
+        {
+            qDebug() << "incremental levels differ:" << rects[i];
+            numErrors++;
+        }
+    }
+
+    return numErrors;
+}
+
+int main()
+{
+    qsrand( 0 );
+
+    const int numPoints = 1000003;
+
+    QVector<QPointF> points( numPoints );
+
+    double value = 0.0;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        value += ( qrand() % 201 - 100 ) * 0.01;
+        points[i] = QPointF( i, value + ( qrand() % 1000 ) * 0.01 );
+    }
+
+    QVector<QRectF> rects;
+    rects += QRectF( 0.0, -1e6, numPoints, 2e6 );
+    rects += QRectF( -100.0, -1e6, 100.0, 2e6 );
+    rects += QRectF( 5000.5, -1.0, 300.0, 2.0 );
+    rects += QRectF( 5000.5, -1.0, 30000.0, 2.0 );
+    rects += QRectF( 123456.7, -1.0, 654321.0, 2.0 );
+    rects += QRectF( numPoints - 10000.5, -1.0, 20000.0, 2.0 );
+    rects += QRectF( 2.0 * numPoints, -1.0, 100.0, 2.0 );
+
+    int numErrors = 0;
+
+    GrowingData *series = new GrowingData();
+    for ( int i = 0; i < numPoints; i++ )
+        series->append( points[i] );
+
+    QwtLevelOfDetailData lod( series );
+
+    const int resolutions[] = { 1, 100, 1000, 4000 };
+    for ( uint i = 0; i < sizeof( resolutions ) / sizeof( int ); i++ )
+    {
+        lod.setResolution( resolutions[i] );
+
+        for ( int j = 0; j < rects.size(); j++ )
+            numErrors += testSelection( points, lod, rects[j] );
+    }
+
+    numErrors += testIncremental( points.mid( 0, 200000 ), rects );
+
+    qDebug() << "Level of detail:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
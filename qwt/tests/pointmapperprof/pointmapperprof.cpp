@@ -0,0 +1,112 @@
+#include <qwt_point_mapper.h>
+#include <qwt_point_data.h>
+#include <qwt_scale_map.h>
+#include <qpolygon.h>
+#include <qelapsedtimer.h>
+#include <qdebug.h>
+#include <qmath.h>
+
+// hiding the span, so that the mapper has to
+// use the virtual QwtSeriesData::sample()
+
+class VirtualData: public QwtSeriesData<QPointF>
+{
+public:
+    VirtualData( const QwtSeriesData<QPointF> *data ):
+        d_data( data )
+    {
+    }
+
+    virtual size_t size() const
+    {
+        return d_data->size();
+    }
+
+    virtual QPointF sample( size_t i ) const
+    {
+        return d_data->sample( i );
+    }
+
+    virtual QRectF boundingRect() const
+    {
+        return d_data->boundingRect();
+    }
+
+private:
+    const QwtSeriesData<QPointF> *d_data;
+};
+
+static void testMapper( const char *name, const QwtPointMapper &mapper,
+    const QwtSeriesData<QPointF> *data )
+{
+    QwtScaleMap xMap;
+    xMap.setScaleInterval( 0.0, data->size() );
+    xMap.setPaintInterval( 0, 1000 );
+
+    QwtScaleMap yMap;
+    yMap.setScaleInterval( -1.0, 1.0 );
+    yMap.setPaintInterval( 800, 0 );
+
+    const VirtualData virtualData( data );
+    const int to = static_cast<int>( data->size() ) - 1;
+
+    QElapsedTimer timer;
+
+    timer.start();
+    const QPolygonF p1 = mapper.toPolygonF( xMap, yMap, &virtualData, 0, to );
+    const qint64 t1 = timer.elapsed();
+
+    timer.start();
+    const QPolygonF p2 = mapper.toPolygonF( xMap, yMap, data, 0, to );
+    const qint64 t2 = timer.elapsed();
+
+    if ( p1 != p2 )
+        qWarning() << name << ": results differ";
+
+    qDebug() << name << ": virtual" << t1 << "span" << t2;
+}
+
+static void testData( const char *name, const QwtSeriesData<QPointF> *data )
+{
+    qDebug() << "===" << name;
+
+    QwtPointMapper mapper;
+    testMapper( "Plain", mapper, data );
+
+    mapper.setFlag( QwtPointMapper::RoundPoints, true );
+    testMapper( "Rounded", mapper, data );
+
+    mapper.setFlag( QwtPointMapper::WeedOutPoints, true );
+    testMapper( "Weeded", mapper, data );
+
+    mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints, true );
+    testMapper( "Aggressive", mapper, data );
+}
+
+int main()
+{
+    const int numPoints = 10e6;
+
+    QVector<double> x( numPoints );
+    QVector<double> y( numPoints );
+    QVector<QPointF> points( numPoints );
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        x[i] = i;
+        y[i] = qSin( i * 0.001 );
+
+        points[i] = QPointF( x[i], y[i] );
+    }
+
+    const QwtPointArrayData arrayData( x, y );
+    testData( "QwtPointArrayData", &arrayData );
+
+    const QwtCPointerData cpointerData( x.constData(), y.constData(), numPoints );
+    testData( "QwtCPointerData", &cpointerData );
+
+    const QwtPointSeriesData seriesData( points );
+    testData( "QwtPointSeriesData", &seriesData );
+
+    return 0;
+}
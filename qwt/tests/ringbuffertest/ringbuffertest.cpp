@@ -0,0 +1,219 @@
+#include <qwt_point_data.h>
+#include <qwt_series_data.h>
+#include <qthread.h>
+#include <qvector.h>
+#include <qrect.h>
+#include <qmath.h>
+#include <qdebug.h>
+
+static inline double value( double x )
+{
+    return 1000.0 * qSin( 0.01 * x );
+}
+
+static int compareSnapshot( const char *name,
+    const QwtRingBufferPointData &data, const QVector<QPointF> &expected )
+{
+    int numErrors = 0;
+
+    bool ok = ( data.size() == static_cast<size_t>( expected.size() ) );
+    for ( int i = 0; ok && i < expected.size(); i++ )
+        ok = ( data.sample( i ) == expected[i] );
+
+    if ( !ok )
+    {
+        qDebug() << name << ": snapshot differs";
+        return 1;
+    }
+
+    if ( !expected.isEmpty() )
+    {
+        const QwtPointSeriesData series( expected );
+        if ( data.boundingRect() != qwtBoundingRect( series ) )
+        {
+            qDebug() << name << ": bounding rectangle differs";
+            numErrors++;
+        }
+
+        QwtPointSpan span;
+        if ( data.pointSpan( span ) )
+        {
+            // a span is offered, as long as the snapshot doesn't wrap
+
+            ok = ( span.size() == data.size() );
+            for ( size_t i = 0; ok && i < span.size(); i++ )
+                ok = ( span.sample( i ) == data.sample( i ) );
+
+            if ( !ok )
+            {
+                qDebug() << name << ": span differs";
+                numErrors++;
+            }
+        }
+    }
+    else if ( data.boundingRect().width() >= 0.0 )
+    {
+        qDebug() << name << ": bounding rectangle of an empty snapshot";
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+static int testSnapshots( int capacity )
+{
+    QwtRingBufferPointData data( capacity );
+
+    // all points, that have been accepted by the ring buffer
+    QVector<QPointF> points;
+
+    int numErrors = 0;
+
+    double x = 0.0;
+    for ( int i = 0; i < 1000; i++ )
+    {
+        const int numPoints = qrand() % ( 3 * capacity );
+
+        QVector<QPointF> chunk( numPoints );
+        for ( int j = 0; j < numPoints; j++ )
+        {
+            chunk[j] = QPointF( x, value( x ) );
+            x += 1.0;
+        }
+
+        const int numAppended = data.append( chunk.constData(), numPoints );
+
+        points += chunk.mid( 0, numAppended );
+        if ( numAppended < numPoints )
+            x -= numPoints - numAppended;
+
+        if ( qrand() % 4 == 0 )
+        {
+            // appending without taking a snapshot
+            continue;
+        }
+
+        if ( qrand() % 50 == 0 )
+        {
+            data.clear();
+            points.clear();
+        }
+        else
+        {
+            data.updateSnapshot();
+
+            const int n = qMin( points.size(), capacity );
+            points = points.mid( points.size() - n );
+        }
+
+        numErrors += compareSnapshot( "Snapshot", data, points );
+    }
+
+    return numErrors;
+}
+
+class Producer: public QThread
+{
+public:
+    Producer( QwtRingBufferPointData *data, int numPoints ):
+        d_data( data ),
+        d_numPoints( numPoints )
+    {
+    }
+
+protected:
+    virtual void run()
+    {
+        QPointF points[16];
+
+        int x = 0;
+        while ( x < d_numPoints )
+        {
+            const int n = qMin( 1 + x % 16, d_numPoints - x );
+            for ( int i = 0; i < n; i++ )
+                points[i] = QPointF( x + i, value( x + i ) );
+
+            // points, that have been dropped, are appended again
+
+            const int numAppended = d_data->append( points, n );
+            if ( numAppended == 0 )
+                yieldCurrentThread();
+
+            x += numAppended;
+        }
+    }
+
+private:
+    QwtRingBufferPointData *d_data;
+    const int d_numPoints;
+};
+
+static int testProducer( int capacity )
+{
+    QwtRingBufferPointData data( capacity );
+
+    const int numPoints = 200000;
+
+    Producer producer( &data, numPoints );
+    producer.start();
+
+    int numErrors = 0;
+
+    bool isDone = false;
+    while ( !isDone )
+    {
+        isDone = producer.isFinished();
+        if ( !isDone )
+            QThread::yieldCurrentThread();
+
+        data.updateSnapshot();
+
+        const size_t size = data.size();
+        if ( size > static_cast<size_t>( capacity ) )
+        {
+            qDebug() << "Producer: snapshot exceeds the capacity";
+            numErrors++;
+        }
+
+        if ( size == 0 )
+            continue;
+
+        // the snapshot is a sequence of consecutive points
+
+        QVector<QPointF> expected( static_cast<int>( size ) );
+
+        const double x0 = data.sample( 0 ).x();
+        for ( int i = 0; i < expected.size(); i++ )
+            expected[i] = QPointF( x0 + i, value( x0 + i ) );
+
+        numErrors += compareSnapshot( "Producer", data, expected );
+
+        if ( isDone && data.sample( size - 1 ).x() != numPoints - 1 )
+        {
+            qDebug() << "Producer: last point is missing";
+            numErrors++;
+        }
+    }
+
+    producer.wait();
+
+    return numErrors;
+}
+
+int main()
+{
+    qsrand( 0 );
+
+    int numErrors = 0;
+
+    const int capacities[] = { 1, 10, 1000, 5000 };
+    for ( uint i = 0; i < sizeof( capacities ) / sizeof( int ); i++ )
+    {
+        numErrors += testSnapshots( capacities[i] );
+        numErrors += testProducer( capacities[i] );
+    }
+
+    qDebug() << "Ring buffer:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include <qwt_plot.h>
+#include <qwt_plot_canvas.h>
+#include <qwt_plot_spectrogram.h>
+#include <qwt_raster_data.h>
+#include <qwt_scale_map.h>
+#include <qapplication.h>
+#include <qeventloop.h>
+#include <qtimer.h>
+#include <qelapsedtimer.h>
+#include <qvector.h>
+#include <qmath.h>
+#include <qdebug.h>
+
+class RasterData: public QwtRasterData
+{
+public:
+    RasterData()
+    {
+        setInterval( Qt::XAxis, QwtInterval( 0.0, 1e5 ) );
+        setInterval( Qt::YAxis, QwtInterval( 0.0, 100.0 ) );
+        setInterval( Qt::ZAxis, QwtInterval( -1.0, 1.0 ) );
+    }
+
+    virtual double value( double x, double y ) const
+    {
+        return qSin( 0.05 * x ) * qCos( 0.1 * y );
+    }
+};
+
+// a spectrogram, that records the sizes of the rendered images
+
+class Spectrogram: public QwtPlotSpectrogram
+{
+public:
+    Spectrogram()
+    {
+        setRenderMode( QwtPlotSpectrogram::ProgressiveRendering );
+        setCachePolicy( QwtPlotRasterItem::ScrollCache );
+        setData( new RasterData() );
+    }
+
+    mutable QVector<QSize> imageSizes;
+
+protected:
+    virtual QImage renderImage( const QwtScaleMap &xMap,
+        const QwtScaleMap &yMap, const QRectF &area,
+        const QSize &imageSize ) const
+    {
+        imageSizes += imageSize;
+        return QwtPlotSpectrogram::renderImage(
+            xMap, yMap, area, imageSize );
+    }
+};
+
+static void processEvents( int msecs )
+{
+    QEventLoop loop;
+    QTimer::singleShot( msecs, &loop, SLOT( quit() ) );
+    loop.exec();
+}
+
+static void waitForRendering( const Spectrogram *spectrogram )
+{
+    // completed tiles trigger replots, until the image
+    // is complete and no more images are rendered
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int numImages = -1;
+    while ( numImages != spectrogram->imageSizes.size()
+        && timer.elapsed() < 10000 )
+    {
+        numImages = spectrogram->imageSizes.size();
+        processEvents( 300 );
+    }
+}
+
+static int scroll( QwtPlot *plot, Spectrogram *spectrogram, int dx )
+{
+    const QSize canvasSize = plot->canvas()->contentsRect().size();
+
+    const QwtScaleMap map = plot->canvasMap( QwtPlot::xBottom );
+    const double d = dx * ( map.s2() - map.s1() ) / ( map.p2() - map.p1() );
+
+    plot->setAxisScale( QwtPlot::xBottom, map.s1() + d, map.s2() + d );
+
+    spectrogram->imageSizes.clear();
+    plot->replot();
+
+    int numErrors = 0;
+
+    // only the uncovered strip has to be rendered
+
+    const QVector<QSize> &sizes = spectrogram->imageSizes;
+    if ( sizes.isEmpty() )
+    {
+        qDebug() << "Scroll" << dx << ": nothing rendered";
+        numErrors++;
+    }
+
+    for ( int i = 0; i < sizes.size(); i++ )
+    {
+        if ( sizes[i] != QSize( qAbs( dx ), canvasSize.height() ) )
+        {
+            qDebug() << "Scroll" << dx << ": rendered" << sizes[i]
+                << "instead of a strip";
+            numErrors++;
+        }
+    }
+
+    // the strip is not a preview, that would invalidate the cache
+
+    spectrogram->imageSizes.clear();
+
+    waitForRendering( spectrogram );
+    plot->replot();
+
+    if ( !sizes.isEmpty() )
+    {
+        qDebug() << "Scroll" << dx << ": image rendered again" << sizes;
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+int main( int argc, char **argv )
+{
+    QApplication app( argc, argv );
+
+    QwtPlot plot;
+    plot.resize( 600, 400 );
+
+    // without axes scrolling doesn't change the layout
+    plot.enableAxis( QwtPlot::xBottom, false );
+    plot.enableAxis( QwtPlot::yLeft, false );
+
+    plot.setAxisScale( QwtPlot::xBottom, 0.0, 1000.0 );
+    plot.setAxisScale( QwtPlot::yLeft, 0.0, 100.0 );
+
+    QwtPlotCanvas *canvas = qobject_cast<QwtPlotCanvas *>( plot.canvas() );
+    canvas->setPaintAttribute( QwtPlotCanvas::ImmediatePaint, true );
+
+    Spectrogram *spectrogram = new Spectrogram();
+    spectrogram->attach( &plot );
+
+    plot.show();
+    plot.replot();
+
+    int numErrors = 0;
+
+    // the initial image is rendered progressively
+
+    waitForRendering( spectrogram );
+
+    spectrogram->imageSizes.clear();
+    plot.replot();
+
+    if ( !spectrogram->imageSizes.isEmpty() )
+    {
+        qDebug() << "Initial image is not cached";
+        numErrors++;
+    }
+
+    const int offsets[] = { 10, 10, -25, 3, -1 };
+    for ( uint i = 0; i < sizeof( offsets ) / sizeof( int ); i++ )
+        numErrors += scroll( &plot, spectrogram, offsets[i] );
+
+    qDebug() << "Scroll cache:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}
@@ -13,4 +13,13 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     splinetest \
-    splineprof
+    splineprof \
+    pointmapperprof \
+    cliptest \
+    lodtest \
+    ringbuffertest \
+    closestpointtest \
+    weedingtest \
+    cachelayertest \
+    columnsymboltest \
+    scrollcachetest
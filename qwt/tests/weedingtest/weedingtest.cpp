@@ -0,0 +1,274 @@
+#include <qwt_weeding_curve_fitter.h>
+#include <qpolygon.h>
+#include <qvector.h>
+#include <qstack.h>
+#include <qpair.h>
+#include <qmath.h>
+#include <qdebug.h>
+
+// the Douglas-Peucker algorithm, as it has been implemented
+// before the points were written in order
+
+static QPolygonF simplify( const QPolygonF &points, double tolerance )
+{
+    const double toleranceSqr = tolerance * tolerance;
+
+    const QPointF *p = points.data();
+    const int nPoints = points.size();
+
+    QVector<bool> usePoint( nPoints, false );
+
+    QStack< QPair<int, int> > stack;
+    stack.push( qMakePair( 0, nPoints - 1 ) );
+
+    while ( nPoints > 0 && !stack.isEmpty() )
+    {
+        const QPair<int, int> r = stack.pop();
+
+        const double vecX = p[r.second].x() - p[r.first].x();
+        const double vecY = p[r.second].y() - p[r.first].y();
+
+        const double vecLength = qSqrt( vecX * vecX + vecY * vecY );
+
+        const double unitVecX = ( vecLength != 0.0 ) ? vecX / vecLength : 0.0;
+        const double unitVecY = ( vecLength != 0.0 ) ? vecY / vecLength : 0.0;
+
+        double maxDistSqr = 0.0;
+        int nVertexIndexMaxDistance = r.first + 1;
+        for ( int i = r.first + 1; i < r.second; i++ )
+        {
+            const double fromVecX = p[i].x() - p[r.first].x();
+            const double fromVecY = p[i].y() - p[r.first].y();
+
+            double distToSegmentSqr;
+            if ( fromVecX * unitVecX + fromVecY * unitVecY < 0.0 )
+            {
+                distToSegmentSqr = fromVecX * fromVecX + fromVecY * fromVecY;
+            }
+            else
+            {
+                const double toVecX = p[i].x() - p[r.second].x();
+                const double toVecY = p[i].y() - p[r.second].y();
+                const double toVecLength = toVecX * toVecX + toVecY * toVecY;
+
+                const double s = toVecX * ( -unitVecX ) + toVecY * ( -unitVecY );
+                if ( s < 0.0 )
+                    distToSegmentSqr = toVecLength;
+                else
+                    distToSegmentSqr = qAbs( toVecLength - s * s );
+            }
+
+            if ( maxDistSqr < distToSegmentSqr )
+            {
+                maxDistSqr = distToSegmentSqr;
+                nVertexIndexMaxDistance = i;
+            }
+        }
+
+        if ( maxDistSqr <= toleranceSqr )
+        {
+            usePoint[r.first] = true;
+            usePoint[r.second] = true;
+        }
+        else
+        {
+            stack.push( qMakePair( r.first, nVertexIndexMaxDistance ) );
+            stack.push( qMakePair( nVertexIndexMaxDistance, r.second ) );
+        }
+    }
+
+    QPolygonF stripped;
+    for ( int i = 0; i < nPoints; i++ )
+    {
+        if ( usePoint[i] )
+            stripped += p[i];
+    }
+
+    return stripped;
+}
+
+static QPolygonF simplifyChunks( const QPolygonF &points,
+    double tolerance, int chunkSize )
+{
+    if ( chunkSize == 0 )
+        return simplify( points, tolerance );
+
+    QPolygonF fittedPoints;
+    for ( int i = 0; i < points.size(); i += chunkSize )
+        fittedPoints += simplify( points.mid( i, chunkSize ), tolerance );
+
+    return fittedPoints;
+}
+
+// a fitter, that keeps only the end points of each chunk
+
+class EndPointFitter: public QwtWeedingCurveFitter
+{
+private:
+    virtual QPolygonF simplify( const QPolygonF &points ) const
+    {
+        QPolygonF fittedPoints;
+        if ( !points.isEmpty() )
+        {
+            fittedPoints += points.first();
+            if ( points.size() > 1 )
+                fittedPoints += points.last();
+        }
+
+        return fittedPoints;
+    }
+};
+
+static QPolygonF randomWalk( int numPoints )
+{
+    QPolygonF points( numPoints );
+
+    double value = 0.0;
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        value += ( qrand() % 201 - 100 ) * 0.01;
+
+        // some of the points are duplicates
+        const double x = ( qrand() % 10 == 0 ) ? i - 1 : i;
+
+        points[i] = QPointF( x, value + ( qrand() % 100 ) * 0.01 );
+    }
+
+    return points;
+}
+
+static int testChunks( const QPolygonF &points )
+{
+    const double tolerances[] = { 0.0, 0.5, 5.0 };
+    const int chunkSizes[] = { 0, 3, 100, 1000, 12345 };
+    const int threadCounts[] = { 1, 4, 0 };
+
+    int numErrors = 0;
+
+    for ( uint i = 0; i < sizeof( tolerances ) / sizeof( double ); i++ )
+    {
+        for ( uint j = 0; j < sizeof( chunkSizes ) / sizeof( int ); j++ )
+        {
+            const QPolygonF expected = simplifyChunks(
+                points, tolerances[i], chunkSizes[j] );
+
+            for ( uint k = 0; k < sizeof( threadCounts ) / sizeof( int ); k++ )
+            {
+                QwtWeedingCurveFitter fitter( tolerances[i] );
+                fitter.setChunkSize( chunkSizes[j] );
+                fitter.setThreadCount( threadCounts[k] );
+
+                if ( fitter.fitCurve( points ) != expected )
+                {
+                    qDebug() << "fitted points differ:" << points.size()
+                        << tolerances[i] << chunkSizes[j] << threadCounts[k];
+                    numErrors++;
+                }
+            }
+        }
+    }
+
+    return numErrors;
+}
+
+static int testIncremental( const QPolygonF &points )
+{
+    const int chunkSize = 1000;
+    const double tolerance = 0.5;
+
+    QwtWeedingCurveFitter fitter( tolerance );
+    fitter.setChunkSize( chunkSize );
+    fitter.setThreadCount( 4 );
+    fitter.setIncremental( true );
+
+    int numErrors = 0;
+
+    int numPoints = 0;
+    while ( numPoints < points.size() )
+    {
+        numPoints = qMin( numPoints + 1 + qrand() % 3000, points.size() );
+
+        const QPolygonF polygon = points.mid( 0, numPoints );
+
+        if ( fitter.fitCurve( polygon ) !=
+            simplifyChunks( polygon, tolerance, chunkSize ) )
+        {
+            qDebug() << "incremental fitting differs:" << numPoints;
+            numErrors++;
+        }
+    }
+
+    // a polygon, that doesn't continue the previous one
+
+    const QPolygonF polygon = points.mid( 1 );
+    if ( fitter.fitCurve( polygon ) !=
+        simplifyChunks( polygon, tolerance, chunkSize ) )
+    {
+        qDebug() << "incremental fitting of a new polygon differs";
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+static int testReimplemented( const QPolygonF &points )
+{
+    const int chunkSizes[] = { 0, 3, 1000 };
+
+    int numErrors = 0;
+
+    for ( uint i = 0; i < sizeof( chunkSizes ) / sizeof( int ); i++ )
+    {
+        const int chunkSize = chunkSizes[i];
+
+        QPolygonF expected;
+        if ( chunkSize == 0 )
+        {
+            expected += points.first();
+            expected += points.last();
+        }
+        else
+        {
+            for ( int j = 0; j < points.size(); j += chunkSize )
+            {
+                const int last = qMin( j + chunkSize, points.size() ) - 1;
+
+                expected += points[j];
+                if ( last > j )
+                    expected += points[last];
+            }
+        }
+
+        EndPointFitter fitter;
+        fitter.setChunkSize( chunkSize );
+        fitter.setThreadCount( 4 );
+
+        if ( fitter.fitCurve( points ) != expected )
+        {
+            qDebug() << "reimplemented simplify() is not called:" << chunkSize;
+            numErrors++;
+        }
+    }
+
+    return numErrors;
+}
+
+int main()
+{
+    qsrand( 0 );
+
+    int numErrors = 0;
+
+    const int sizes[] = { 0, 1, 2, 3, 10, 999, 1000, 1001, 100000 };
+    for ( uint i = 0; i < sizeof( sizes ) / sizeof( int ); i++ )
+        numErrors += testChunks( randomWalk( sizes[i] ) );
+
+    const QPolygonF points = randomWalk( 50000 );
+
+    numErrors += testIncremental( points );
+    numErrors += testReimplemented( points );
+
+    qDebug() << "Weeding:" << numErrors << "errors";
+
+    return ( numErrors == 0 ) ? 0 : 1;
+}